@@ -54,7 +54,8 @@ class AccessClass : public ActionBroadcaster
 {
 public:
 
-    AccessClass() { }
+    AccessClass()
+        : ui(0), ev(0), pl(0), dv(0), pg(0), cp(0), mc(0), ac(0) { }
     ~AccessClass() { }
 
     /** Sets the object's UIComponent and copies all the necessary pointers
@@ -74,6 +74,48 @@ public:
             return static_cast<Sample>(out);
         }
 
+        // Processes a block through exactly NumStages stages. Being a
+        // compile-time constant, the stage loop unrolls completely, and
+        // with the states and coefficients copied into locals they can
+        // stay in registers for the whole block. The arithmetic is the
+        // same as process(), sample for sample.
+        template <int NumStages, typename Sample>
+        void processBlock(int numSamples, Sample* dest, const Cascade& c)
+        {
+            StateType state[NumStages];
+            Biquad stage[NumStages];
+
+            for (int i = 0; i < NumStages; ++i)
+            {
+                state[i] = m_stateArray[i];
+                stage[i] = c.m_stageArray[i];
+            }
+
+            while (--numSamples >= 0)
+            {
+                double out = *dest;
+                out = state[0].process1(out, stage[0], ac());
+                for (int i = 1; i < NumStages; ++i)
+                    out = state[i].process1(out, stage[i], 0);
+                *dest++ = static_cast<Sample>(out);
+            }
+
+            for (int i = 0; i < NumStages; ++i)
+                m_stateArray[i] = state[i];
+        }
+
+        // Puts every stage in the state it would have reached if the
+        // input had always been 'in', so that a block can start on a
+        // non-zero sample without a transient. Used for zero-phase
+        // filtering, where each pass starts mid-signal.
+        void setSteadyState(double in, const Cascade& c)
+        {
+            StateType* state = m_stateArray;
+            Biquad const* stage = c.m_stageArray;
+            for (int i = c.m_numStages; --i >= 0;)
+                in = (state++)->setSteadyState(in, *stage++);
+        }
+
     protected:
         StateBase(StateType* stateArray)
             : m_stateArray(stateArray)
@@ -117,14 +159,33 @@ public:
 
     std::vector<PoleZeroPair> getPoleZeros() const;
 
-    // Process a block of samples in the given form
+    // Process a block of samples in the given form. The stage counts of
+    // the designs we use most (up to 4th order band-passes) get a loop
+    // specialized for their exact number of stages.
     template <class StateType, typename Sample>
     void process(int numSamples, Sample* dest, StateType& state) const
     {
-        while (--numSamples >= 0)
+        switch (m_numStages)
         {
-            *dest = state.process(*dest, *this);
-            dest++;
+            case 1:
+                state.template processBlock <1> (numSamples, dest, *this);
+                break;
+            case 2:
+                state.template processBlock <2> (numSamples, dest, *this);
+                break;
+            case 3:
+                state.template processBlock <3> (numSamples, dest, *this);
+                break;
+            case 4:
+                state.template processBlock <4> (numSamples, dest, *this);
+                break;
+            default:
+                while (--numSamples >= 0)
+                {
+                    *dest = state.process(*dest, *this);
+                    dest++;
+                }
+                break;
         }
     }
 
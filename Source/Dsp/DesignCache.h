@@ -0,0 +1,167 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef DSPFILTERS_DESIGNCACHE_H
+#define DSPFILTERS_DESIGNCACHE_H
+
+#include "Common.h"
+#include "Params.h"
+
+namespace Dsp
+{
+
+/*
+ * DesignCache
+ *
+ * Shares one set of coefficients between every channel that uses the same
+ * design parameters. A Design (e.g. Butterworth::Design::BandPass <2>) holds
+ * the cascade coefficients plus the analog and digital layouts used to compute
+ * them, and running setParams() performs the whole pole/zero design. Channels
+ * that only need their own history can keep a DesignClass::State and run
+ * design->process (numSamples, dest, state) against a shared design.
+ *
+ * Designs are keyed on their Params, which for every Design filter begin with
+ * the sample rate followed by the order and the remaining parameters, so a
+ * reconfiguration costs one design per distinct parameter set.
+ *
+ * Released designs are kept until purge() is called, so that a processing
+ * thread still holding a pointer to one is never left dangling.
+ *
+ */
+template <class DesignClass>
+class DesignCache
+{
+public:
+    DesignCache()
+    {
+    }
+
+    ~DesignCache()
+    {
+        clear();
+    }
+
+    // Returns the shared design for these parameters, designing it
+    // only if it isn't cached yet. Balance every call with release().
+    const DesignClass* acquire(const Params& parameters)
+    {
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            if (matches(m_entries[i].params, parameters))
+            {
+                ++m_entries[i].refCount;
+                return m_entries[i].design;
+            }
+        }
+
+        Entry entry;
+        entry.params = parameters;
+        entry.design = new DesignClass;
+        entry.design->setParams(parameters);
+        entry.refCount = 1;
+
+        m_entries.push_back(entry);
+
+        return entry.design;
+    }
+
+    // Gives up one reference to a design returned by acquire().
+    void release(const DesignClass* design)
+    {
+        if (design == 0)
+            return;
+
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            if (m_entries[i].design == design)
+            {
+                assert(m_entries[i].refCount > 0);
+                --m_entries[i].refCount;
+                return;
+            }
+        }
+
+        assert(false); // not one of ours
+    }
+
+    // Deletes every design that no channel is using. Only call this
+    // when nothing can be processing with a released design.
+    void purge()
+    {
+        for (size_t i = m_entries.size(); i-- > 0;)
+        {
+            if (m_entries[i].refCount == 0)
+            {
+                delete m_entries[i].design;
+                m_entries.erase(m_entries.begin() + i);
+            }
+        }
+    }
+
+    // Deletes all designs, whether or not they are still in use.
+    void clear()
+    {
+        for (size_t i = 0; i < m_entries.size(); ++i)
+            delete m_entries[i].design;
+
+        m_entries.clear();
+    }
+
+    // Returns the number of designs currently in use.
+    int getNumDesigns() const
+    {
+        int count = 0;
+
+        for (size_t i = 0; i < m_entries.size(); ++i)
+            if (m_entries[i].refCount > 0)
+                ++count;
+
+        return count;
+    }
+
+private:
+    static bool matches(const Params& a, const Params& b)
+    {
+        for (int i = 0; i < DesignClass::NumParams; ++i)
+            if (a[i] != b[i])
+                return false;
+
+        return true;
+    }
+
+    struct Entry
+    {
+        Params params;
+        DesignClass* design;
+        int refCount;
+    };
+
+    std::vector<Entry> m_entries;
+
+    DesignCache(const DesignCache&);
+    DesignCache& operator=(const DesignCache&);
+};
+
+}
+
+#endif
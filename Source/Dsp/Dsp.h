@@ -44,11 +44,17 @@ THE SOFTWARE.
 
 #include "Biquad.h"
 #include "Cascade.h"
+#include "DesignCache.h"
+#include "FFT.h"
 #include "Filter.h"
+#include "Fir.h"
+#include "Hilbert.h"
 #include "PoleFilter.h"
 #include "SmoothedFilter.h"
 #include "State.h"
+#include "Transposed.h"
 #include "Utilities.h"
+#include "ZeroPhase.h"
 
 #include "Bessel.h"
 #include "Butterworth.h"
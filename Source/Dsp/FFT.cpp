@@ -0,0 +1,265 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Common.h"
+#include "FFT.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#  define DSP_FFT_USE_SSE 1
+#  include <xmmintrin.h>
+#else
+#  define DSP_FFT_USE_SSE 0
+#endif
+
+namespace Dsp
+{
+
+FFT::FFT(int size)
+    : m_size(size)
+    , m_half(size / 2)
+{
+    assert(size >= 4 && (size & (size - 1)) == 0);
+
+    const double twoPi = 2 * 3.1415926535897932384626433832795;
+
+    int bits = 0;
+    while ((1 << bits) < m_half)
+        ++bits;
+
+    m_bitReverse.resize(m_half);
+
+    for (int i = 0; i < m_half; ++i)
+    {
+        int r = 0;
+        for (int b = 0; b < bits; ++b)
+            if (i & (1 << b))
+                r |= 1 << (bits - 1 - b);
+        m_bitReverse[i] = r;
+    }
+
+    // stage spans are 1, 2, 4 ... m_half/2, for m_half - 1 twiddles in total
+    m_twiddleRe.resize(m_half);
+    m_twiddleIm.resize(m_half);
+
+    for (int h = 1; h < m_half; h <<= 1)
+    {
+        for (int j = 0; j < h; ++j)
+        {
+            const double w = -twoPi * j / (2 * h);
+            m_twiddleRe[h - 1 + j] = float(std::cos(w));
+            m_twiddleIm[h - 1 + j] = float(std::sin(w));
+        }
+    }
+
+    m_splitRe.resize(m_half + 1);
+    m_splitIm.resize(m_half + 1);
+
+    for (int k = 0; k <= m_half; ++k)
+    {
+        const double w = -twoPi * k / m_size;
+        m_splitRe[k] = float(std::cos(w));
+        m_splitIm[k] = float(std::sin(w));
+    }
+
+    m_re.resize(m_half);
+    m_im.resize(m_half);
+
+    m_spectrumRe.resize(m_half + 1);
+    m_spectrumIm.resize(m_half + 1);
+}
+
+void FFT::loadReal(const float* input)
+{
+    // pack and bit-reverse in the same pass
+    for (int i = 0; i < m_half; ++i)
+    {
+        const int r = m_bitReverse[i];
+        m_re[r] = input[2 * i];
+        m_im[r] = input[2 * i + 1];
+    }
+}
+
+void FFT::transform()
+{
+    float* const re = &m_re[0];
+    float* const im = &m_im[0];
+    const int n = m_half;
+
+    // the first stage only adds and subtracts
+    for (int i = 0; i < n; i += 2)
+    {
+        const float ar = re[i], ai = im[i];
+        const float br = re[i + 1], bi = im[i + 1];
+        re[i] = ar + br;
+        im[i] = ai + bi;
+        re[i + 1] = ar - br;
+        im[i + 1] = ai - bi;
+    }
+
+    for (int h = 2; h < n; h <<= 1)
+    {
+        const float* const wr = &m_twiddleRe[h - 1];
+        const float* const wi = &m_twiddleIm[h - 1];
+
+        for (int i = 0; i < n; i += 2 * h)
+        {
+            float* const ar = re + i;
+            float* const ai = im + i;
+            float* const br = re + i + h;
+            float* const bi = im + i + h;
+
+            int j = 0;
+
+#if DSP_FFT_USE_SSE
+            // h is a power of two, so from h = 4 on this covers the whole span
+            for (; j + 4 <= h; j += 4)
+            {
+                const __m128 twr = _mm_loadu_ps(wr + j);
+                const __m128 twi = _mm_loadu_ps(wi + j);
+                const __m128 xr = _mm_loadu_ps(br + j);
+                const __m128 xi = _mm_loadu_ps(bi + j);
+
+                const __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, twr), _mm_mul_ps(xi, twi));
+                const __m128 ti = _mm_add_ps(_mm_mul_ps(xr, twi), _mm_mul_ps(xi, twr));
+
+                const __m128 yr = _mm_loadu_ps(ar + j);
+                const __m128 yi = _mm_loadu_ps(ai + j);
+
+                _mm_storeu_ps(br + j, _mm_sub_ps(yr, tr));
+                _mm_storeu_ps(bi + j, _mm_sub_ps(yi, ti));
+                _mm_storeu_ps(ar + j, _mm_add_ps(yr, tr));
+                _mm_storeu_ps(ai + j, _mm_add_ps(yi, ti));
+            }
+#endif
+
+            for (; j < h; ++j)
+            {
+                const float tr = br[j] * wr[j] - bi[j] * wi[j];
+                const float ti = br[j] * wi[j] + bi[j] * wr[j];
+
+                br[j] = ar[j] - tr;
+                bi[j] = ai[j] - ti;
+                ar[j] += tr;
+                ai[j] += ti;
+            }
+        }
+    }
+}
+
+void FFT::splitSpectrum(float* re, float* im) const
+{
+    // X[k] = E[k] + W^k O[k], where E and O are the transforms of the even
+    // and odd samples, recovered from Z[k] and conj(Z[n/2 - k])
+    for (int k = 0; k <= m_half; ++k)
+    {
+        const int a = (k == m_half) ? 0 : k;
+        const int b = (k == 0) ? 0 : m_half - k;
+
+        const float er = 0.5f * (m_re[a] + m_re[b]);
+        const float ei = 0.5f * (m_im[a] - m_im[b]);
+        const float orr = 0.5f * (m_im[a] + m_im[b]);
+        const float oi = -0.5f * (m_re[a] - m_re[b]);
+
+        re[k] = er + m_splitRe[k] * orr - m_splitIm[k] * oi;
+        im[k] = ei + m_splitRe[k] * oi + m_splitIm[k] * orr;
+    }
+}
+
+void FFT::inverse(const float* re, const float* im, float* output)
+{
+    // rebuild Z[k] = E[k] + i O[k], with E[k] = (X[k] + conj(X[n/2 - k])) / 2
+    // and O[k] = (X[k] - conj(X[n/2 - k])) W^-k / 2, conjugated so that the
+    // forward transform computes the inverse one
+    for (int k = 0; k < m_half; ++k)
+    {
+        const int b = m_half - k;
+
+        const float er = 0.5f * (re[k] + re[b]);
+        const float ei = 0.5f * (im[k] - im[b]);
+        const float dr = 0.5f * (re[k] - re[b]);
+        const float di = 0.5f * (im[k] + im[b]);
+
+        // W^-k = conj(W^k)
+        const float orr = dr * m_splitRe[k] + di * m_splitIm[k];
+        const float oi = di * m_splitRe[k] - dr * m_splitIm[k];
+
+        const int r = m_bitReverse[k];
+        m_re[r] = er - oi;
+        m_im[r] = -(ei + orr);
+    }
+
+    transform();
+
+    const float scale = 1.0f / m_half;
+
+    for (int i = 0; i < m_half; ++i)
+    {
+        output[2 * i] = m_re[i] * scale;
+        output[2 * i + 1] = -m_im[i] * scale;
+    }
+}
+
+void FFT::performReal(const float* input, float* re, float* im)
+{
+    loadReal(input);
+    transform();
+    splitSpectrum(re, im);
+}
+
+void FFT::performPower(const float* input, float* power)
+{
+    loadReal(input);
+    transform();
+    splitSpectrum(&m_spectrumRe[0], &m_spectrumIm[0]);
+
+    for (int k = 0; k <= m_half; ++k)
+        power[k] = m_spectrumRe[k] * m_spectrumRe[k] + m_spectrumIm[k] * m_spectrumIm[k];
+}
+
+void FFT::performRealInverse(const float* re, const float* im, float* output)
+{
+    inverse(re, im, output);
+}
+
+void FFT::performConvolution(const float* input, float* output,
+                             const float* kernelRe, const float* kernelIm)
+{
+    loadReal(input);
+    transform();
+
+    float* const re = &m_spectrumRe[0];
+    float* const im = &m_spectrumIm[0];
+
+    splitSpectrum(re, im);
+
+    for (int k = 0; k <= m_half; ++k)
+    {
+        const float xr = re[k];
+        re[k] = xr * kernelRe[k] - im[k] * kernelIm[k];
+        im[k] = xr * kernelIm[k] + im[k] * kernelRe[k];
+    }
+
+    inverse(re, im, output);
+}
+
+}
@@ -0,0 +1,110 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef DSPFILTERS_FFT_H
+#define DSPFILTERS_FFT_H
+
+#include "Common.h"
+
+namespace Dsp
+{
+
+/*
+ * FFT
+ *
+ * Forward transform of a block of real samples, for spectral analysis.
+ *
+ * A real block of size N is packed into a complex block of N/2 points
+ * (even samples in the real part, odd samples in the imaginary part),
+ * transformed with an iterative radix-2 FFT, and then split back into the
+ * N/2+1 bins of the real spectrum.
+ *
+ * Everything that depends only on the size is computed in the constructor:
+ * the bit-reversal table and the twiddle factors for each stage, stored
+ * contiguously so the butterflies of a stage walk through them in order.
+ * Data is kept as separate real and imaginary arrays, which lets the
+ * butterflies run four at a time with SSE where it is available.
+ *
+ * An instance owns its scratch space, so one instance must not be used by
+ * two threads at once. Nothing is allocated after construction.
+ *
+ */
+class FFT
+{
+public:
+    // size must be a power of two, and at least 4
+    explicit FFT(int size);
+
+    int getSize() const { return m_size; }
+
+    // Returns the number of bins in the real spectrum, size/2+1.
+    int getNumBins() const { return m_half + 1; }
+
+    // Transforms size real samples. re and im receive getNumBins()
+    // values each; bin k is at frequency k * sampleRate / size.
+    void performReal(const float* input, float* re, float* im);
+
+    // As performReal(), but writes the squared magnitude of each bin.
+    void performPower(const float* input, float* power);
+
+    // Inverse of performReal(): turns getNumBins() complex bins back
+    // into size real samples.
+    void performRealInverse(const float* re, const float* im, float* output);
+
+    // Circular convolution of size real samples with a kernel whose
+    // spectrum was computed by performReal(). output may be input.
+    void performConvolution(const float* input, float* output,
+                            const float* kernelRe, const float* kernelIm);
+
+private:
+    void loadReal(const float* input);
+    void transform();
+    void splitSpectrum(float* re, float* im) const;
+    void inverse(const float* re, const float* im, float* output);
+
+    int m_size;
+    int m_half;
+
+    std::vector<int> m_bitReverse;
+
+    // twiddles for the stage with butterfly span h start at index h - 1
+    std::vector<float> m_twiddleRe;
+    std::vector<float> m_twiddleIm;
+
+    // twiddles for splitting the packed transform into the real spectrum
+    std::vector<float> m_splitRe;
+    std::vector<float> m_splitIm;
+
+    std::vector<float> m_re;
+    std::vector<float> m_im;
+
+    std::vector<float> m_spectrumRe;
+    std::vector<float> m_spectrumIm;
+
+    FFT(const FFT&);
+    FFT& operator=(const FFT&);
+};
+
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Common.h"
+#include "Fir.h"
+
+namespace Dsp
+{
+
+FirBandPass::State::State()
+    : m_fill(0)
+{
+}
+
+void FirBandPass::State::reset()
+{
+    std::fill(m_frame.begin(), m_frame.end(), 0.f);
+    std::fill(m_output.begin(), m_output.end(), 0.f);
+    m_fill = 0;
+}
+
+FirBandPass::FirBandPass()
+    : m_fftSize(0)
+{
+    m_params.clear();
+}
+
+int FirBandPass::getFftSizeForTaps(int numTaps)
+{
+    // at least twice the filter length, so that every frame
+    // yields at least as many new samples as the filter is long
+    int size = 256;
+
+    while (size < 2 * numTaps)
+        size *= 2;
+
+    return size;
+}
+
+void FirBandPass::setParams(const Params& parameters)
+{
+    m_params = parameters;
+
+    const double sampleRate = parameters[0];
+    const int numTaps = std::max(3, int(parameters[1])) | 1;
+    const double lowCut = parameters[2] / sampleRate;
+    const double highCut = parameters[3] / sampleRate;
+
+    const double pi = 3.1415926535897932384626433832795;
+    const int mid = (numTaps - 1) / 2;
+
+    m_taps.resize(numTaps);
+
+    for (int n = 0; n < numTaps; ++n)
+    {
+        const int m = n - mid;
+
+        // difference of two low-pass sinc kernels
+        double h;
+
+        if (m == 0)
+            h = 2 * (highCut - lowCut);
+        else
+            h = (std::sin(2 * pi * highCut * m) - std::sin(2 * pi * lowCut * m)) / (pi * m);
+
+        const double w = 0.42 - 0.5 * std::cos(2 * pi * n / (numTaps - 1))
+                         + 0.08 * std::cos(4 * pi * n / (numTaps - 1));
+
+        m_taps[n] = float(h * w);
+    }
+
+    m_fftSize = getFftSizeForTaps(numTaps);
+
+    FFT fft(m_fftSize);
+
+    std::vector<float> padded(m_fftSize, 0.f);
+    std::copy(m_taps.begin(), m_taps.end(), padded.begin());
+
+    m_spectrumRe.resize(fft.getNumBins());
+    m_spectrumIm.resize(fft.getNumBins());
+
+    fft.performReal(&padded[0], &m_spectrumRe[0], &m_spectrumIm[0]);
+}
+
+void FirBandPass::prepareState(State& state) const
+{
+    state.m_frame.resize(m_fftSize);
+    state.m_output.resize(m_fftSize);
+    state.reset();
+}
+
+void FirBandPass::process(int numSamples, float* dest, State& state, FFT& fft) const
+{
+    assert(fft.getSize() == m_fftSize);
+    assert(int(state.m_frame.size()) == m_fftSize);
+
+    const int overlap = getNumTaps() - 1;
+    const int blockSize = getBlockSize();
+
+    float* const frame = &state.m_frame[0];
+    float* const output = &state.m_output[0];
+
+    while (numSamples > 0)
+    {
+        const int n = std::min(numSamples, blockSize - state.m_fill);
+
+        // new input goes after the overlap; the last frame's
+        // results go out in its place
+        float* const in = frame + overlap + state.m_fill;
+        const float* const out = output + overlap + state.m_fill;
+
+        for (int i = 0; i < n; ++i)
+        {
+            const float x = dest[i];
+            dest[i] = out[i];
+            in[i] = x;
+        }
+
+        dest += n;
+        numSamples -= n;
+        state.m_fill += n;
+
+        if (state.m_fill == blockSize)
+        {
+            // the first getNumTaps() - 1 outputs wrap around, and are discarded
+            fft.performConvolution(frame, output, &m_spectrumRe[0], &m_spectrumIm[0]);
+
+            memmove(frame, frame + blockSize, sizeof(float) * overlap);
+
+            state.m_fill = 0;
+        }
+    }
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef DSPFILTERS_FIR_H
+#define DSPFILTERS_FIR_H
+
+#include "Common.h"
+#include "FFT.h"
+#include "Params.h"
+
+namespace Dsp
+{
+
+/*
+ * FirBandPass
+ *
+ * Linear-phase band-pass FIR filter (Blackman-windowed sinc), run by
+ * overlap-save convolution so that filters with thousands of taps stay
+ * cheap: each block of getBlockSize() samples costs one forward and one
+ * inverse FFT of getFftSize() points.
+ *
+ * Like the IIR Designs, the filter itself holds only coefficients (the taps
+ * and their spectrum) and can be shared between channels, for instance
+ * through a DesignCache; each channel keeps its own State. Parameters are
+ * sample rate, number of taps (rounded up to odd), low cut and high cut.
+ *
+ * Output is delayed by getLatency() samples: half the filter length, plus
+ * one block while the overlap-save frame fills.
+ *
+ */
+class FirBandPass
+{
+public:
+    enum { NumParams = 4 };
+
+    class State
+    {
+    public:
+        State();
+
+        void reset();
+
+    private:
+        friend class FirBandPass;
+
+        std::vector<float> m_frame;
+        std::vector<float> m_output;
+        int m_fill;
+    };
+
+    FirBandPass();
+
+    void setParams(const Params& parameters);
+
+    const Params& getParams() const { return m_params; }
+
+    int getNumTaps() const { return int(m_taps.size()); }
+    int getFftSize() const { return m_fftSize; }
+    int getBlockSize() const { return m_fftSize - getNumTaps() + 1; }
+
+    // Total delay between input and output, in samples.
+    int getLatency() const { return getBlockSize() + (getNumTaps() - 1) / 2; }
+
+    const std::vector<float>& getTaps() const { return m_taps; }
+
+    // Sizes a channel's state for this filter and clears it. The state
+    // can then be used with any filter with the same number of taps.
+    void prepareState(State& state) const;
+
+    // Filters numSamples samples in place. fft must be of getFftSize(),
+    // and is used as scratch space, so it must not be shared between threads.
+    void process(int numSamples, float* dest, State& state, FFT& fft) const;
+
+    // Returns the overlap-save FFT size used for a given number of taps.
+    static int getFftSizeForTaps(int numTaps);
+
+private:
+    Params m_params;
+    int m_fftSize;
+    std::vector<float> m_taps;
+    std::vector<float> m_spectrumRe;
+    std::vector<float> m_spectrumIm;
+};
+
+}
+
+#endif
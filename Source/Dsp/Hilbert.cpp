@@ -0,0 +1,152 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Common.h"
+#include "Hilbert.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#  define DSP_HILBERT_USE_SSE 1
+#  include <xmmintrin.h>
+#else
+#  define DSP_HILBERT_USE_SSE 0
+#endif
+
+namespace Dsp
+{
+
+HilbertFir::State::State()
+    : m_parity(0)
+{
+    m_index[0] = m_index[1] = 0;
+}
+
+void HilbertFir::State::reset()
+{
+    std::fill(m_history[0].begin(), m_history[0].end(), 0.f);
+    std::fill(m_history[1].begin(), m_history[1].end(), 0.f);
+    m_index[0] = m_index[1] = 0;
+    m_parity = 0;
+}
+
+HilbertFir::HilbertFir()
+    : m_delay(0)
+{
+}
+
+int HilbertFir::getNumTapsForFrequency(double sampleRate, double lowestFrequency)
+{
+    // the windowed response is within 0.2% of flat from about
+    // 2.5 / numTaps (as a fraction of the sample rate) up
+    return int(std::ceil(2.5 * sampleRate / std::max(lowestFrequency, 1e-3)));
+}
+
+void HilbertFir::setNumTaps(int numTaps)
+{
+    // numTaps = 2 * delay + 1, with an odd delay
+    m_delay = std::max(1, (numTaps - 1) / 2) | 1;
+
+    const int n = getNumTaps();
+    const double pi = 3.1415926535897932384626433832795;
+
+    m_taps.resize(m_delay + 1);
+
+    // tap i applies to the sample 2 * (delay - i) before the newest,
+    // which lies 2 * i - delay (always odd) after the output time
+    for (int i = 0; i <= m_delay; ++i)
+    {
+        const int j = 2 * i; // position within the window, oldest first
+        const int k = m_delay - j; // lag of that sample behind the output time
+
+        const double w = 0.42 - 0.5 * std::cos(2 * pi * j / (n - 1))
+                         + 0.08 * std::cos(4 * pi * j / (n - 1));
+
+        m_taps[i] = float(2.0 / (pi * k) * w);
+    }
+}
+
+void HilbertFir::prepareState(State& state) const
+{
+    const int length = m_delay + 1;
+
+    state.m_history[0].resize(2 * length);
+    state.m_history[1].resize(2 * length);
+    state.reset();
+}
+
+void HilbertFir::process(int numSamples, const float* input,
+                         float* real, float* imag, State& state) const
+{
+    const int length = m_delay + 1;
+
+    assert(int(state.m_history[0].size()) == 2 * length);
+
+    const float* const taps = &m_taps[0];
+
+    // the delayed sample is (delay - 1) / 2 samples back
+    // in the history of the other parity
+    const int back = (m_delay - 1) / 2;
+
+    for (int s = 0; s < numSamples; ++s)
+    {
+        const int p = state.m_parity;
+
+        float* const history = &state.m_history[p][0];
+        int& index = state.m_index[p];
+
+        index = (index + 1 == length) ? 0 : index + 1;
+
+        const float x = input[s];
+        history[index] = x;
+        history[index + length] = x;
+
+        // oldest to newest
+        const float* const window = history + index + 1;
+
+        float sum = 0;
+        int i = 0;
+
+#if DSP_HILBERT_USE_SSE
+        __m128 acc = _mm_setzero_ps();
+
+        for (; i + 4 <= length; i += 4)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(window + i), _mm_loadu_ps(taps + i)));
+
+        float lanes[4];
+        _mm_storeu_ps(lanes, acc);
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+        for (; i < length; ++i)
+            sum += window[i] * taps[i];
+
+        const float* const other = &state.m_history[p ^ 1][0];
+        const float delayed = other[state.m_index[p ^ 1] + length - back];
+
+        real[s] = delayed;
+        imag[s] = sum;
+
+        state.m_parity = p ^ 1;
+    }
+}
+
+}
@@ -0,0 +1,105 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef DSPFILTERS_HILBERT_H
+#define DSPFILTERS_HILBERT_H
+
+#include "Common.h"
+
+namespace Dsp
+{
+
+/*
+ * HilbertFir
+ *
+ * Streaming FIR Hilbert transformer (Blackman-windowed), producing the
+ * analytic signal of its input: the input delayed by getDelay() samples
+ * as the real part, and its Hilbert transform, aligned with it, as the
+ * imaginary part. Magnitude and phase of the pair are the instantaneous
+ * amplitude and phase of a band-limited signal.
+ *
+ * The filter is run directly rather than by FFT, so the delay is exactly
+ * half the filter length. Every other tap of a Hilbert transformer is
+ * zero; with the length rounded up to 4k + 3, the non-zero taps all fall
+ * on samples of the same parity as the newest one. Each State keeps its
+ * history split by parity, so a sample costs one dot product over a
+ * quarter of the filter length plus one, run four at a time with SSE
+ * where it is available.
+ *
+ * Its response falls away towards DC; getNumTapsForFrequency() gives a
+ * length that keeps it flat from a given frequency up.
+ *
+ */
+class HilbertFir
+{
+public:
+    class State
+    {
+    public:
+        State();
+
+        void reset();
+
+    private:
+        friend class HilbertFir;
+
+        // each history holds one parity of samples, twice over,
+        // so that the newest window is always contiguous
+        std::vector<float> m_history[2];
+        int m_index[2];
+        int m_parity;
+    };
+
+    HilbertFir();
+
+    // Designs the filter; numTaps is rounded up to the next 4k + 3.
+    void setNumTaps(int numTaps);
+
+    int getNumTaps() const { return 2 * m_delay + 1; }
+
+    // Delay of both outputs relative to the input, in samples.
+    int getDelay() const { return m_delay; }
+
+    // Sizes a channel's state for this filter and clears it.
+    void prepareState(State& state) const;
+
+    // Processes numSamples samples of input. real receives the delayed
+    // input and imag its Hilbert transform; either may be the input.
+    void process(int numSamples, const float* input,
+                 float* real, float* imag, State& state) const;
+
+    // Returns a length whose response is within 0.2% of flat
+    // from lowestFrequency to sampleRate/2 - lowestFrequency.
+    static int getNumTapsForFrequency(double sampleRate, double lowestFrequency);
+
+private:
+    int m_delay; // odd
+
+    // the getDelay() + 1 non-zero taps, in the order of the samples
+    // they apply to, oldest first
+    std::vector<float> m_taps;
+};
+
+}
+
+#endif
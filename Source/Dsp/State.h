@@ -92,6 +92,18 @@ public:
         return static_cast<Sample>(out);
     }
 
+    // Fills x[] with a constant input and y[] with its steady-state output (zero for a pole at DC).
+    inline double setSteadyState(const double in, const BiquadBase& s)
+    {
+        const double den = 1 + s.m_a1 + s.m_a2;
+        const double out = (den != 0) ? in * (s.m_b0 + s.m_b1 + s.m_b2) / den : 0;
+
+        m_x1 = m_x2 = (den != 0) ? in : 0;
+        m_y1 = m_y2 = out;
+
+        return out;
+    }
+
 protected:
     double m_x2; // x[n-2]
     double m_y2; // y[n-2]
@@ -138,6 +150,17 @@ public:
         return static_cast<Sample>(out);
     }
 
+    // Fills v[] with the constant input scaled by 1/(1+a1+a2), or zero for a pole at DC.
+    inline double setSteadyState(const double in, const BiquadBase& s)
+    {
+        const double den = 1 + s.m_a1 + s.m_a2;
+        const double w = (den != 0) ? in / den : 0;
+
+        m_v1 = m_v2 = w;
+
+        return (s.m_b0 + s.m_b1 + s.m_b2) * w;
+    }
+
 private:
     double m_v1; // v[-1]
     double m_v2; // v[-2]
@@ -245,6 +268,20 @@ public:
         return static_cast<Sample>(out);
     }
 
+    // Fills s1, s2 with the settled values for a constant input, or zero for a pole at DC.
+    inline double setSteadyState(const double in, const BiquadBase& s)
+    {
+        const double den = 1 + s.m_a1 + s.m_a2;
+        const double out = (den != 0) ? in * (s.m_b0 + s.m_b1 + s.m_b2) / den : 0;
+
+        const double x = (den != 0) ? in : 0;
+
+        m_s2 = m_s2_1 = s.m_b2*x - s.m_a2*out;
+        m_s1 = m_s1_1 = m_s2 + s.m_b1*x - s.m_a1*out;
+
+        return out;
+    }
+
 private:
     double m_s1;
     double m_s1_1;
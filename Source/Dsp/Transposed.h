@@ -0,0 +1,448 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef DSPFILTERS_TRANSPOSED_H
+#define DSPFILTERS_TRANSPOSED_H
+
+#include "Common.h"
+#include "Cascade.h"
+#include "MathSupplement.h"
+#include "Params.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#  define DSP_TRANSPOSED_USE_SSE 1
+#  include <xmmintrin.h>
+#else
+#  define DSP_TRANSPOSED_USE_SSE 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DSP_TRANSPOSED_USE_SSE2 1
+#  include <emmintrin.h>
+#else
+#  define DSP_TRANSPOSED_USE_SSE2 0
+#endif
+
+namespace Dsp
+{
+
+/*
+ * TransposedCascade
+ *
+ * A copy of a Cascade's coefficients in the precision given by Real,
+ * processed in Transposed Direct Form II, which keeps its state small and
+ * behaves best of the four forms when rounded to single precision.
+ *
+ * The state classes in State.h always compute in double, converting every
+ * sample on the way in and out. With Real = float a block stays in single
+ * precision throughout, and processFour() runs four channels side by side
+ * in the lanes of an SSE register, where double would only fit two.
+ *
+ * Storage is fixed at MaxStages, so nothing is allocated. Stages beyond
+ * those of the copied cascade pass their input through unchanged, which
+ * lets every loop run over exactly MaxStages stages.
+ *
+ */
+template <int MaxStages, typename Real = float>
+class TransposedCascade
+{
+public:
+    class State
+    {
+    public:
+        State()
+            : m_vsa(Real(anti_denormal_vsa))
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            for (int i = 0; i < MaxStages; ++i)
+            {
+                m_s1[i] = 0;
+                m_s2[i] = 0;
+            }
+        }
+
+    private:
+        friend class TransposedCascade;
+
+        Real m_s1[MaxStages];
+        Real m_s2[MaxStages];
+        Real m_vsa;
+    };
+
+    TransposedCascade()
+        : m_numStages(0)
+    {
+        for (int i = 0; i < MaxStages; ++i)
+            setIdentity(i);
+    }
+
+    int getNumStages() const
+    {
+        return m_numStages;
+    }
+
+    // Copies the (normalized) coefficients of a cascade.
+    void setCascade(const Cascade& cascade)
+    {
+        Cascade& c = const_cast<Cascade&>(cascade); // operator[] isn't const
+
+        assert(c.getNumStages() <= MaxStages);
+        m_numStages = std::min(int(c.getNumStages()), MaxStages);
+
+        for (int i = 0; i < MaxStages; ++i)
+        {
+            if (i < m_numStages)
+                copyStage(i, c[i]);
+            else
+                setIdentity(i);
+        }
+    }
+
+    // Copies a single section into one stage, for cascades assembled from
+    // individual biquads such as RBJ notches. Use clear() to start over.
+    void setStage(int index, const BiquadBase& stage)
+    {
+        assert(index >= 0 && index < MaxStages);
+
+        copyStage(index, stage);
+        m_numStages = std::max(m_numStages, index + 1);
+    }
+
+    // Makes every stage pass its input through unchanged.
+    void clear()
+    {
+        m_numStages = 0;
+
+        for (int i = 0; i < MaxStages; ++i)
+            setIdentity(i);
+    }
+
+    // Filters numSamples samples in place.
+    template <typename Sample>
+    void process(int numSamples, Sample* dest, State& state) const
+    {
+        Real s1[MaxStages];
+        Real s2[MaxStages];
+
+        for (int i = 0; i < MaxStages; ++i)
+        {
+            s1[i] = state.m_s1[i];
+            s2[i] = state.m_s2[i];
+        }
+
+        // a small alternating current keeps silence from decaying to
+        // denormals, which single precision reaches much sooner
+        Real vsa = state.m_vsa;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            Real x = Real(dest[n]);
+
+            for (int i = 0; i < MaxStages; ++i)
+            {
+                const Coefficients& k = m_stages[i];
+                const Real out = k.b0*x + s1[i] + vsa;
+                s1[i] = k.b1*x - k.a1*out + s2[i];
+                s2[i] = k.b2*x - k.a2*out;
+                x = out;
+            }
+
+            dest[n] = Sample(x);
+            vsa = -vsa;
+        }
+
+        for (int i = 0; i < MaxStages; ++i)
+        {
+            state.m_s1[i] = s1[i];
+            state.m_s2[i] = s2[i];
+        }
+
+        state.m_vsa = vsa;
+    }
+
+    // Filters four channels of numSamples samples in place, each with its
+    // own cascade and state, one channel per SSE lane. Real must be float.
+    static void processFour(int numSamples, float* const* dest,
+                            const TransposedCascade* const* cascades,
+                            State* const* states)
+    {
+#if DSP_TRANSPOSED_USE_SSE
+        __m128 b0[MaxStages], b1[MaxStages], b2[MaxStages], a1[MaxStages], a2[MaxStages];
+        __m128 s1[MaxStages], s2[MaxStages];
+
+        for (int i = 0; i < MaxStages; ++i)
+        {
+            const Coefficients& k0 = cascades[0]->m_stages[i];
+            const Coefficients& k1 = cascades[1]->m_stages[i];
+            const Coefficients& k2 = cascades[2]->m_stages[i];
+            const Coefficients& k3 = cascades[3]->m_stages[i];
+
+            b0[i] = _mm_setr_ps(k0.b0, k1.b0, k2.b0, k3.b0);
+            b1[i] = _mm_setr_ps(k0.b1, k1.b1, k2.b1, k3.b1);
+            b2[i] = _mm_setr_ps(k0.b2, k1.b2, k2.b2, k3.b2);
+            a1[i] = _mm_setr_ps(k0.a1, k1.a1, k2.a1, k3.a1);
+            a2[i] = _mm_setr_ps(k0.a2, k1.a2, k2.a2, k3.a2);
+
+            s1[i] = _mm_setr_ps(states[0]->m_s1[i], states[1]->m_s1[i],
+                                states[2]->m_s1[i], states[3]->m_s1[i]);
+            s2[i] = _mm_setr_ps(states[0]->m_s2[i], states[1]->m_s2[i],
+                                states[2]->m_s2[i], states[3]->m_s2[i]);
+        }
+
+        __m128 vsa = _mm_setr_ps(states[0]->m_vsa, states[1]->m_vsa,
+                                 states[2]->m_vsa, states[3]->m_vsa);
+        const __m128 sign = _mm_set1_ps(-0.0f);
+
+        float* const d0 = dest[0];
+        float* const d1 = dest[1];
+        float* const d2 = dest[2];
+        float* const d3 = dest[3];
+
+        int n = 0;
+
+        // four samples of each channel at a time, transposed so that each
+        // register holds one sample of every channel
+        for (; n + 4 <= numSamples; n += 4)
+        {
+            __m128 x[4];
+            x[0] = _mm_loadu_ps(d0 + n);
+            x[1] = _mm_loadu_ps(d1 + n);
+            x[2] = _mm_loadu_ps(d2 + n);
+            x[3] = _mm_loadu_ps(d3 + n);
+
+            _MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+
+            for (int j = 0; j < 4; ++j)
+            {
+                x[j] = filterFour(x[j], b0, b1, b2, a1, a2, s1, s2, vsa);
+                vsa = _mm_xor_ps(vsa, sign);
+            }
+
+            _MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+
+            _mm_storeu_ps(d0 + n, x[0]);
+            _mm_storeu_ps(d1 + n, x[1]);
+            _mm_storeu_ps(d2 + n, x[2]);
+            _mm_storeu_ps(d3 + n, x[3]);
+        }
+
+        for (; n < numSamples; ++n)
+        {
+            float out[4];
+
+            _mm_storeu_ps(out, filterFour(_mm_setr_ps(d0[n], d1[n], d2[n], d3[n]),
+                                          b0, b1, b2, a1, a2, s1, s2, vsa));
+            vsa = _mm_xor_ps(vsa, sign);
+
+            d0[n] = out[0];
+            d1[n] = out[1];
+            d2[n] = out[2];
+            d3[n] = out[3];
+        }
+
+        float lanes[4];
+
+        for (int i = 0; i < MaxStages; ++i)
+        {
+            _mm_storeu_ps(lanes, s1[i]);
+            for (int c = 0; c < 4; ++c)
+                states[c]->m_s1[i] = lanes[c];
+
+            _mm_storeu_ps(lanes, s2[i]);
+            for (int c = 0; c < 4; ++c)
+                states[c]->m_s2[i] = lanes[c];
+        }
+
+        _mm_storeu_ps(lanes, vsa);
+        for (int c = 0; c < 4; ++c)
+            states[c]->m_vsa = lanes[c];
+#else
+        for (int c = 0; c < 4; ++c)
+            cascades[c]->process(numSamples, dest[c], *states[c]);
+#endif
+    }
+
+    // As processFour(), with two channels per SSE2 register, for filters
+    // that need Real = double, such as narrow notches at low frequencies.
+    static void processTwo(int numSamples, float* const* dest,
+                           const TransposedCascade* const* cascades,
+                           State* const* states)
+    {
+#if DSP_TRANSPOSED_USE_SSE2
+        __m128d b0[MaxStages], b1[MaxStages], b2[MaxStages], a1[MaxStages], a2[MaxStages];
+        __m128d s1[MaxStages], s2[MaxStages];
+
+        for (int i = 0; i < MaxStages; ++i)
+        {
+            const Coefficients& k0 = cascades[0]->m_stages[i];
+            const Coefficients& k1 = cascades[1]->m_stages[i];
+
+            b0[i] = _mm_setr_pd(k0.b0, k1.b0);
+            b1[i] = _mm_setr_pd(k0.b1, k1.b1);
+            b2[i] = _mm_setr_pd(k0.b2, k1.b2);
+            a1[i] = _mm_setr_pd(k0.a1, k1.a1);
+            a2[i] = _mm_setr_pd(k0.a2, k1.a2);
+
+            s1[i] = _mm_setr_pd(states[0]->m_s1[i], states[1]->m_s1[i]);
+            s2[i] = _mm_setr_pd(states[0]->m_s2[i], states[1]->m_s2[i]);
+        }
+
+        __m128d vsa = _mm_setr_pd(states[0]->m_vsa, states[1]->m_vsa);
+        const __m128d sign = _mm_set1_pd(-0.0);
+
+        float* const d0 = dest[0];
+        float* const d1 = dest[1];
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            __m128d x = _mm_setr_pd(d0[n], d1[n]);
+
+            for (int i = 0; i < MaxStages; ++i)
+            {
+                const __m128d out = _mm_add_pd(_mm_add_pd(_mm_mul_pd(b0[i], x), s1[i]), vsa);
+                s1[i] = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1[i], x), _mm_mul_pd(a1[i], out)), s2[i]);
+                s2[i] = _mm_sub_pd(_mm_mul_pd(b2[i], x), _mm_mul_pd(a2[i], out));
+                x = out;
+            }
+
+            double out[2];
+            _mm_storeu_pd(out, x);
+
+            d0[n] = float(out[0]);
+            d1[n] = float(out[1]);
+
+            vsa = _mm_xor_pd(vsa, sign);
+        }
+
+        double lanes[2];
+
+        for (int i = 0; i < MaxStages; ++i)
+        {
+            _mm_storeu_pd(lanes, s1[i]);
+            states[0]->m_s1[i] = lanes[0];
+            states[1]->m_s1[i] = lanes[1];
+
+            _mm_storeu_pd(lanes, s2[i]);
+            states[0]->m_s2[i] = lanes[0];
+            states[1]->m_s2[i] = lanes[1];
+        }
+
+        _mm_storeu_pd(lanes, vsa);
+        states[0]->m_vsa = lanes[0];
+        states[1]->m_vsa = lanes[1];
+#else
+        for (int c = 0; c < 2; ++c)
+            cascades[c]->process(numSamples, dest[c], *states[c]);
+#endif
+    }
+
+private:
+    struct Coefficients
+    {
+        Real b0;
+        Real b1;
+        Real b2;
+        Real a1;
+        Real a2;
+    };
+
+    void copyStage(int index, const BiquadBase& stage)
+    {
+        m_stages[index].b0 = Real(stage.m_b0);
+        m_stages[index].b1 = Real(stage.m_b1);
+        m_stages[index].b2 = Real(stage.m_b2);
+        m_stages[index].a1 = Real(stage.m_a1);
+        m_stages[index].a2 = Real(stage.m_a2);
+    }
+
+    void setIdentity(int stage)
+    {
+        m_stages[stage].b0 = 1;
+        m_stages[stage].b1 = 0;
+        m_stages[stage].b2 = 0;
+        m_stages[stage].a1 = 0;
+        m_stages[stage].a2 = 0;
+    }
+
+#if DSP_TRANSPOSED_USE_SSE
+    static inline __m128 filterFour(__m128 x,
+                                    const __m128* b0, const __m128* b1, const __m128* b2,
+                                    const __m128* a1, const __m128* a2,
+                                    __m128* s1, __m128* s2, __m128 vsa)
+    {
+        for (int i = 0; i < MaxStages; ++i)
+        {
+            const __m128 out = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0[i], x), s1[i]), vsa);
+            s1[i] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1[i], x), _mm_mul_ps(a1[i], out)), s2[i]);
+            s2[i] = _mm_sub_ps(_mm_mul_ps(b2[i], x), _mm_mul_ps(a2[i], out));
+            x = out;
+        }
+
+        return x;
+    }
+#endif
+
+    int m_numStages;
+    Coefficients m_stages[MaxStages];
+};
+
+//------------------------------------------------------------------------------
+
+/*
+ * TransposedDesign
+ *
+ * Wraps a Design (e.g. Butterworth::Design::BandPass <2>) so that setting
+ * its parameters also refreshes a TransposedCascade copy of its
+ * coefficients. The design itself stays available in double precision.
+ * It has the Design's NumParams and setParams(), so it can be shared
+ * between channels through a DesignCache.
+ *
+ */
+template <class DesignClass, int MaxStages, typename Real = float>
+class TransposedDesign : public TransposedCascade <MaxStages, Real>
+{
+public:
+    enum { NumParams = DesignClass::NumParams };
+
+    void setParams(const Params& parameters)
+    {
+        m_design.setParams(parameters);
+        this->setCascade(m_design);
+    }
+
+    const DesignClass& getDesign() const
+    {
+        return m_design;
+    }
+
+private:
+    DesignClass m_design;
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef DSPFILTERS_ZEROPHASE_H
+#define DSPFILTERS_ZEROPHASE_H
+
+#include "Common.h"
+#include "Cascade.h"
+
+namespace Dsp
+{
+
+/*
+ * Zero-phase filtering
+ *
+ * Running a filter forward and then backward over the same block cancels
+ * its phase response and squares its magnitude response (filtfilt). This
+ * needs the whole block up front, so it is only for offline or delayed
+ * processing; Cascade::process remains the causal path.
+ *
+ * Each pass starts from the steady state of the filter for the first
+ * sample it sees, rather than from silence, and zeroPhaseFilter() also
+ * pads the block at both ends with its odd reflection, so the edges of
+ * the block carry no start-up transient.
+ *
+ * The state passed in is any Design::State (for example
+ * Butterworth::Design::BandPass <2>::State <DirectFormII>); its previous
+ * contents are ignored.
+ *
+ */
+
+// Number of samples of reflection used at each end by zeroPhaseFilter().
+inline int getZeroPhasePadLength(const Cascade& filter)
+{
+    return 3 * (2 * filter.getNumStages() + 1);
+}
+
+// Filters data[0 .. numSamples-1] in place, first sample first.
+template <class StateType, typename Sample>
+void processForward(const Cascade& filter, StateType& state, int numSamples, Sample* data)
+{
+    if (numSamples <= 0)
+        return;
+
+    state.setSteadyState(data[0], filter);
+
+    for (int i = 0; i < numSamples; ++i)
+        data[i] = state.process(data[i], filter);
+}
+
+// Filters data[0 .. numSamples-1] in place, last sample first.
+template <class StateType, typename Sample>
+void processBackward(const Cascade& filter, StateType& state, int numSamples, Sample* data)
+{
+    if (numSamples <= 0)
+        return;
+
+    state.setSteadyState(data[numSamples - 1], filter);
+
+    for (int i = numSamples; --i >= 0;)
+        data[i] = state.process(data[i], filter);
+}
+
+// Zero-phase filters a whole block in place. scratch is resized to hold
+// the block and its padding; reuse it between calls to avoid allocating.
+template <class StateType, typename Sample>
+void zeroPhaseFilter(const Cascade& filter, StateType& state,
+                     int numSamples, Sample* data, std::vector<Sample>& scratch)
+{
+    if (numSamples < 2)
+        return;
+
+    const int pad = std::min(getZeroPhasePadLength(filter), numSamples - 1);
+    const int total = numSamples + 2 * pad;
+
+    scratch.resize(total);
+    Sample* const x = &scratch[0];
+
+    // odd reflection keeps the signal and its slope continuous at the edges
+    for (int i = 0; i < pad; ++i)
+    {
+        x[i] = 2 * data[0] - data[pad - i];
+        x[pad + numSamples + i] = 2 * data[numSamples - 1] - data[numSamples - 2 - i];
+    }
+
+    std::copy(data, data + numSamples, x + pad);
+
+    processForward(filter, state, total, x);
+    processBackward(filter, state, total, x);
+
+    std::copy(x + pad, x + pad + numSamples, data);
+}
+
+}
+
+#endif
@@ -27,6 +27,7 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainWindow.h"
 #include "UI/CustomLookAndFeel.h"
+#include "UI/StartupTrace.h"
 
 #include <stdio.h>
 
@@ -55,6 +56,8 @@ public:
     //==============================================================================
     void initialise(const String& commandLine)
     {
+        StartupTrace::begin();
+
         StringArray parameters;
         parameters.addTokens(commandLine," ","\"");
 #ifdef WIN32
@@ -75,9 +78,11 @@ public:
         customLookAndFeel = new CustomLookAndFeel();
         LookAndFeel::setDefaultLookAndFeel(customLookAndFeel);
 
-        mainWindow = new MainWindow();
+        StartupTrace::phase("Look and feel");
 
+        mainWindow = new MainWindow();
 
+        StartupTrace::finishWhenIdle();
 
     }
 
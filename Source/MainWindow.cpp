@@ -22,6 +22,7 @@
 */
 
 #include "MainWindow.h"
+#include "UI/StartupTrace.h"
 #include <stdio.h>
 
 //-----------------------------------------------------------------------
@@ -42,8 +43,11 @@ MainWindow::MainWindow()
     // Callbacks will be set by the play button in the control panel
 
     processorGraph = new ProcessorGraph();
+    StartupTrace::phase("Processor graph");
+
     audioComponent = new AudioComponent();
     audioComponent->connectToProcessorGraph(processorGraph);
+    StartupTrace::phase("Audio device");
 
     setContentOwned(new UIComponent(this, processorGraph, audioComponent), true);
 
@@ -55,12 +59,14 @@ MainWindow::MainWindow()
     ui->setApplicationCommandManagerToWatch(&commandManager);
 
     addKeyListener(commandManager.getKeyMappings());
+    StartupTrace::phase("Commands");
 
     loadWindowBounds();
     setUsingNativeTitleBar(true);
     Component::addToDesktop(getDesktopWindowStyleFlags());  // prevents the maximize
     // button from randomly disappearing
     setVisible(true);
+    StartupTrace::phase("Main window");
 
 }
 
@@ -0,0 +1,244 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "AllocationTracker.h"
+
+#if OPEN_EPHYS_TRACK_ALLOCATIONS
+
+#include "GenericProcessor.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <new>
+
+#if JUCE_WINDOWS
+#include <crtdbg.h>
+#define ALLOCATION_TRACKER_TLS __declspec(thread)
+#else
+#define ALLOCATION_TRACKER_TLS __thread
+#endif
+
+namespace
+{
+
+// plain thread-local storage: JUCE's ThreadLocalValue allocates on first use,
+// which would recurse straight back into the allocator
+ALLOCATION_TRACKER_TLS GenericProcessor* currentProcessor = 0;
+ALLOCATION_TRACKER_TLS bool isReporting = false;
+
+}
+
+AllocationTracker::ScopedProcessor::ScopedProcessor(GenericProcessor* p)
+    : previous(currentProcessor)
+{
+    currentProcessor = p;
+}
+
+AllocationTracker::ScopedProcessor::~ScopedProcessor()
+{
+    currentProcessor = previous;
+}
+
+void AllocationTracker::allocationMade(size_t numBytes)
+{
+    if (currentProcessor == 0 || isReporting)
+        return;
+
+    // everything below may allocate, and must not be counted again
+    isReporting = true;
+
+    const int64 count = currentProcessor->getStatistics().addAllocation();
+
+    if (count > 0 && count <= MAX_REPORTS_PER_PROCESSOR)
+    {
+        std::cout << "Allocation of " << (int64) numBytes << " bytes on the audio thread in "
+                  << currentProcessor->getName() << " (" << currentProcessor->getNodeId() << "):"
+                  << std::endl
+                  << SystemStats::getStackBacktrace() << std::endl;
+    }
+
+    isReporting = false;
+}
+
+//==============================================================================
+#if JUCE_LINUX
+
+// glibc's operator new calls malloc, so hooking the C allocator catches both
+// (and HeapBlock, which AudioSampleBuffer uses). The aligned entry points don't
+// go through malloc, so they are hooked as well
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+
+    void* malloc(size_t size)
+    {
+        AllocationTracker::allocationMade(size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t num, size_t size)
+    {
+        AllocationTracker::allocationMade(num * size);
+        return __libc_calloc(num, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        AllocationTracker::allocationMade(size);
+        return __libc_realloc(ptr, size);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        AllocationTracker::allocationMade(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        AllocationTracker::allocationMade(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** ptr, size_t alignment, size_t size)
+    {
+        // same checks as glibc: a power of two, and a multiple of sizeof(void*)
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0)
+            return EINVAL;
+
+        AllocationTracker::allocationMade(size);
+
+        void* p = __libc_memalign(alignment, size);
+
+        if (p == 0)
+            return ENOMEM;
+
+        *ptr = p;
+        return 0;
+    }
+}
+
+#elif JUCE_WINDOWS
+
+// only available with the debug CRT; release builds track nothing
+#ifdef _DEBUG
+
+namespace
+{
+
+int allocationHook(int allocType, void*, size_t size, int blockType,
+                   long, const unsigned char*, int)
+{
+    if (blockType != _CRT_BLOCK && (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC))
+        AllocationTracker::allocationMade(size);
+
+    return TRUE;
+}
+
+struct AllocationHookInstaller
+{
+    AllocationHookInstaller()
+    {
+        _CrtSetAllocHook(allocationHook);
+    }
+};
+
+AllocationHookInstaller allocationHookInstaller;
+
+}
+
+#endif
+
+#else
+
+// elsewhere, replace the global operator new
+#if __cplusplus >= 201103L
+#define ALLOCATION_TRACKER_THROWS
+#define ALLOCATION_TRACKER_NOTHROW noexcept
+#else
+#define ALLOCATION_TRACKER_THROWS throw(std::bad_alloc)
+#define ALLOCATION_TRACKER_NOTHROW throw()
+#endif
+
+void* operator new(size_t size) ALLOCATION_TRACKER_THROWS
+{
+    AllocationTracker::allocationMade(size);
+
+    void* ptr = ::malloc(size == 0 ? 1 : size);
+
+    if (ptr == 0)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void* operator new[](size_t size) ALLOCATION_TRACKER_THROWS
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) ALLOCATION_TRACKER_NOTHROW
+{
+    AllocationTracker::allocationMade(size);
+    return ::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) ALLOCATION_TRACKER_NOTHROW
+{
+    AllocationTracker::allocationMade(size);
+    return ::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) ALLOCATION_TRACKER_NOTHROW
+{
+    ::free(ptr);
+}
+
+void operator delete[](void* ptr) ALLOCATION_TRACKER_NOTHROW
+{
+    ::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) ALLOCATION_TRACKER_NOTHROW
+{
+    ::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) ALLOCATION_TRACKER_NOTHROW
+{
+    ::free(ptr);
+}
+
+#endif
+
+#else
+
+void AllocationTracker::allocationMade(size_t)
+{
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __ALLOCATIONTRACKER_H_9D41E2B7__
+#define __ALLOCATIONTRACKER_H_9D41E2B7__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+/** Build with -D OPEN_EPHYS_TRACK_ALLOCATIONS=1 to catch heap allocations made
+    on the audio thread. It is off by default, and costs nothing when off. */
+#ifndef OPEN_EPHYS_TRACK_ALLOCATIONS
+#define OPEN_EPHYS_TRACK_ALLOCATIONS 0
+#endif
+
+class GenericProcessor;
+
+/**
+
+  Debug tool for finding heap allocations in processBlock().
+
+  When OPEN_EPHYS_TRACK_ALLOCATIONS is set, the allocator is intercepted
+  (malloc/calloc/realloc and the aligned allocators on Linux, the debug CRT
+  allocation hook on Windows, operator new elsewhere). Any allocation made
+  while a ScopedProcessor is alive on the calling thread is counted in that
+  processor's ProcessorStatistics.
+  Once a processor is past its warm-up blocks, its first few allocations after
+  each reset are also printed with a stack backtrace.
+
+  The counts are shown in the Processing Times overlay and written to the
+  exported CSV. Tests/AllocationTest runs the signal-processing nodes through
+  a synthetic chain and fails if any of them allocates after warm-up.
+
+  @see ProcessorStatistics, GenericProcessor::processBlock()
+
+*/
+
+class AllocationTracker
+{
+public:
+
+    /** Marks the calling thread as working on behalf of a processor until
+        the object goes out of scope. */
+    class ScopedProcessor
+    {
+    public:
+#if OPEN_EPHYS_TRACK_ALLOCATIONS
+        ScopedProcessor(GenericProcessor* p);
+        ~ScopedProcessor();
+
+    private:
+        GenericProcessor* previous;
+#else
+        ScopedProcessor(GenericProcessor*) {}
+#endif
+    };
+
+    /** Returns true if this build intercepts allocations. */
+    static bool isEnabled()
+    {
+        return OPEN_EPHYS_TRACK_ALLOCATIONS != 0;
+    }
+
+    /** Called by the intercepted allocator. Must not allocate, except
+        while reporting (which is guarded against re-entry). */
+    static void allocationMade(size_t numBytes);
+
+    /** The number of backtraces printed per processor after each reset. */
+    enum { MAX_REPORTS_PER_PROCESSOR = 3 };
+
+};
+
+
+#endif  // __ALLOCATIONTRACKER_H_9D41E2B7__
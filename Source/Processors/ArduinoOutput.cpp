@@ -42,11 +42,11 @@ AudioProcessorEditor* ArduinoOutput::createEditor()
     return editor;
 }
 
-void ArduinoOutput::handleEvent(int eventType, MidiMessage& event, int sampleNum)
+void ArduinoOutput::handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum)
 {
     if (eventType == TTL)
     {
-        const uint8* dataptr = event.getRawData();
+        const uint8* dataptr = eventData;
 
         int eventNodeId = *(dataptr+1);
         int eventId = *(dataptr+2);
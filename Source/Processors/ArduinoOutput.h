@@ -58,7 +58,7 @@ public:
     void setParameter(int parameterIndex, float newValue);
 
     /** Convenient interface for responding to incoming events. */
-    void handleEvent(int eventType, MidiMessage& event, int sampleNum);
+    void handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum);
 
     /** Called immediately prior to the start of data acquisition. */
     bool enable();
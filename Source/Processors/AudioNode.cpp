@@ -179,7 +179,7 @@ void AudioNode::process(AudioSampleBuffer& buffer,
 
             if (channelPointers[i-2]->isMonitored)
             {
-                gain=volume/(float(0x7fff) * channelPointers[i-2]->bitVolts);
+                gain=volume/(float(0x7fff) * channelPointers[i-2]->getBitVolts());
                 buffer.addFrom(0,  		// destination channel
                                0,  			// destination start sample
                                buffer,      // source
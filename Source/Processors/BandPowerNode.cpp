@@ -0,0 +1,319 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include "BandPowerNode.h"
+#include "Editors/BandPowerEditor.h"
+
+#define SCRATCH_SIZE 1024
+#define MAX_HILBERT_TAPS 8191
+
+BandPowerNode::BandPowerNode()
+    : GenericProcessor("Band Power"), lowCut(150.0), highCut(250.0), method(HILBERT),
+      output(AMPLITUDE), threshold(50.0f), rmsWindowMs(20.0), rmsWindow(1), rmsIndex(0),
+      bandPassDelay(0.0)
+{
+
+    imaginary.calloc(SCRATCH_SIZE);
+
+}
+
+BandPowerNode::~BandPowerNode()
+{
+
+}
+
+AudioProcessorEditor* BandPowerNode::createEditor()
+{
+    editor = new BandPowerEditor(this, true);
+
+    std::cout << "Creating editor." << std::endl;
+
+    return editor;
+}
+
+void BandPowerNode::updateSettings()
+{
+
+    while (channels.size() < getNumInputs())
+        channels.add(new ChannelState());
+
+    channels.removeLast(channels.size() - getNumInputs());
+
+    prepare();
+
+}
+
+bool BandPowerNode::enable()
+{
+
+    prepare();
+
+    return true;
+
+}
+
+void BandPowerNode::prepare()
+{
+
+    const double sampleRate = getSampleRate();
+
+    if (sampleRate <= 0)
+        return;
+
+    Dsp::Params params;
+    params[0] = sampleRate; // sample rate
+    params[1] = 2; // order
+    params[2] = (highCut + lowCut)/2; // center frequency
+    params[3] = highCut - lowCut; // bandwidth
+
+    bandPassDesign.setParams(params);
+    bandPass.setCascade(bandPassDesign);
+
+    // group delay at the centre of the band, from the slope of the phase
+    const double centre = params[2] / sampleRate;
+    const double step = 0.001 * (highCut - lowCut) / sampleRate;
+
+    const std::complex<double> below = bandPassDesign.response(centre - step);
+    const std::complex<double> above = bandPassDesign.response(centre + step);
+
+    bandPassDelay = -std::arg(above * std::conj(below)) / (2.0 * double_Pi * 2.0 * step);
+
+    const int numTaps = Dsp::HilbertFir::getNumTapsForFrequency(sampleRate, lowCut);
+
+    if (numTaps > MAX_HILBERT_TAPS)
+    {
+        std::cout << "Band power: a Hilbert filter flat down to " << lowCut << " Hz would need "
+                  << numTaps << " taps; using " << MAX_HILBERT_TAPS << "." << std::endl;
+    }
+
+    hilbert.setNumTaps(jmin(numTaps, MAX_HILBERT_TAPS));
+
+    rmsWindow = jmax(1, roundDoubleToInt(rmsWindowMs * sampleRate / 1000.0));
+    rmsIndex = 0;
+
+    for (int n = 0; n < channels.size(); n++)
+    {
+        ChannelState* channel = channels[n];
+
+        channel->bandPass.reset();
+
+        if (method == HILBERT)
+        {
+            hilbert.prepareState(channel->hilbert);
+            channel->squares.free();
+        }
+        else
+        {
+            channel->hilbert = Dsp::HilbertFir::State();
+            channel->squares.calloc(rmsWindow);
+        }
+
+        channel->sumOfSquares = 0;
+        channel->isAbove = false;
+    }
+
+}
+
+int BandPowerNode::getLatency()
+{
+
+    const double delay = bandPassDelay + (method == HILBERT ? hilbert.getDelay()
+                                          : (rmsWindow - 1) / 2.0);
+
+    return roundDoubleToInt(delay);
+
+}
+
+void BandPowerNode::setParameter(int parameterIndex, float newValue)
+{
+
+    if (parameterIndex == 0 || parameterIndex == 1)
+    {
+        if (newValue <= 0.01f || newValue >= 10000.0f)
+            return;
+
+        if (parameterIndex == 0)
+            lowCut = newValue;
+        else
+            highCut = newValue;
+
+        prepare();
+    }
+    else if (parameterIndex == 2)
+    {
+        method = (newValue < 0.5f) ? HILBERT : RMS;
+        prepare();
+    }
+    else if (parameterIndex == 3)
+    {
+        threshold = newValue;
+    }
+    else if (parameterIndex == 4)
+    {
+        output = (newValue < 0.5f) ? AMPLITUDE : PHASE;
+    }
+    else if (parameterIndex == 5)
+    {
+        if (newValue <= 0.0f)
+            return;
+
+        rmsWindowMs = newValue;
+        prepare();
+    }
+
+}
+
+void BandPowerNode::process(AudioSampleBuffer& buffer,
+                            MidiBuffer& events,
+                            int& nSamples)
+{
+
+    const int numChannels = jmin(getNumOutputs(), channels.size());
+
+    // band-pass two channels at a time
+    const BandPassCascade* cascades[2] = { &bandPass, &bandPass };
+
+    int chan = 0;
+
+    for (; chan + 2 <= numChannels; chan += 2)
+    {
+        float* dest[2] = { buffer.getSampleData(chan), buffer.getSampleData(chan + 1) };
+        BandPassCascade::State* states[2] = { &channels[chan]->bandPass, &channels[chan + 1]->bandPass };
+
+        BandPassCascade::processTwo(nSamples, dest, cascades, states);
+    }
+
+    if (chan < numChannels)
+        bandPass.process(nSamples, buffer.getSampleData(chan), channels[chan]->bandPass);
+
+    for (chan = 0; chan < numChannels; chan++)
+    {
+        if (method == HILBERT)
+            processHilbert(channels[chan], chan, buffer.getSampleData(chan), nSamples, events);
+        else
+            processRms(channels[chan], chan, buffer.getSampleData(chan), nSamples, events);
+    }
+
+    if (method == RMS)
+        rmsIndex = (rmsIndex + nSamples) % rmsWindow;
+
+}
+
+void BandPowerNode::processHilbert(ChannelState* channel, int chan, float* data,
+                                   int nSamples, MidiBuffer& events)
+{
+
+    const float degrees = float(180.0 / double_Pi);
+
+    for (int start = 0; start < nSamples; start += SCRATCH_SIZE)
+    {
+        const int count = jmin(SCRATCH_SIZE, nSamples - start);
+
+        float* const real = data + start;
+        float* const imag = imaginary;
+
+        // the real part is the band-passed signal, delayed to match
+        hilbert.process(count, real, real, imag, channel->hilbert);
+
+        for (int i = 0; i < count; i++)
+        {
+            const float amplitude = sqrtf(real[i] * real[i] + imag[i] * imag[i]);
+
+            if (output == PHASE)
+                real[i] = atan2f(imag[i], real[i]) * degrees;
+            else
+                real[i] = amplitude;
+
+            imag[i] = amplitude;
+        }
+
+        addThresholdEvents(channel, chan, imag, start, count, events);
+    }
+
+}
+
+void BandPowerNode::processRms(ChannelState* channel, int chan, float* data,
+                               int nSamples, MidiBuffer& events)
+{
+
+    float* const squares = channel->squares;
+
+    if (squares == nullptr)
+        return;
+
+    double sum = channel->sumOfSquares;
+    int index = rmsIndex;
+
+    const double scale = 2.0 / rmsWindow; // so that a sine gives its amplitude
+
+    for (int i = 0; i < nSamples; i++)
+    {
+        const float square = data[i] * data[i];
+
+        sum += square - squares[index];
+        squares[index] = square;
+
+        if (++index == rmsWindow)
+        {
+            index = 0;
+
+            // start each window afresh, so rounding errors can't build up
+            sum = 0;
+            for (int j = 0; j < rmsWindow; j++)
+                sum += squares[j];
+        }
+
+        data[i] = float(sqrt(jmax(0.0, sum * scale)));
+    }
+
+    channel->sumOfSquares = sum;
+
+    addThresholdEvents(channel, chan, data, 0, nSamples, events);
+
+}
+
+void BandPowerNode::addThresholdEvents(ChannelState* channel, int chan, const float* amplitude,
+                                       int firstSample, int nSamples, MidiBuffer& events)
+{
+
+    bool isAbove = channel->isAbove;
+
+    for (int i = 0; i < nSamples; i++)
+    {
+        if (isAbove != (amplitude[i] > threshold))
+        {
+            isAbove = !isAbove;
+
+            addEvent(events,    // MidiBuffer
+                     TTL,       // eventType
+                     firstSample + i, // sampleNum
+                     isAbove ? 1 : 0, // eventID
+                     chan);     // eventChannel
+        }
+    }
+
+    channel->isAbove = isAbove;
+
+}
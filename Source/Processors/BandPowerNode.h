@@ -0,0 +1,153 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __BANDPOWERNODE_H_2D6B81F3__
+#define __BANDPOWERNODE_H_2D6B81F3__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+#include "../Dsp/Dsp.h"
+#include "GenericProcessor.h"
+
+/**
+
+  Replaces every channel with the instantaneous amplitude (or phase) of
+  one frequency band, for closed-loop control.
+
+  Each channel is band-passed (2nd-order Butterworth, in double precision,
+  two channels per SSE2 register), and then either:
+
+  - run through a streaming FIR Hilbert transformer (Dsp::HilbertFir),
+    which gives both amplitude and phase, or
+  - squared and averaged over a sliding window, for an RMS amplitude that
+    is cheaper and has less delay, but no phase.
+
+  Whenever a channel's amplitude rises above the threshold, a TTL event
+  (id 1) goes out on the event channel with that channel's number; when it
+  falls back below, an event with id 0 follows.
+
+  Everything adds a fixed delay. getLatency() reports it, from the band-pass
+  group delay at the centre of the band plus the delay of the Hilbert filter
+  or half the RMS window, and the editor shows it.
+
+  Parameters: 0 = low cut (Hz), 1 = high cut (Hz), 2 = method,
+  3 = threshold, 4 = output, 5 = RMS window (ms).
+
+  @see GenericProcessor, BandPowerEditor, Dsp::HilbertFir
+
+*/
+
+class BandPowerNode : public GenericProcessor
+
+{
+public:
+
+    BandPowerNode();
+    ~BandPowerNode();
+
+    void process(AudioSampleBuffer& buffer, MidiBuffer& midiMessages, int& nSamples);
+    void setParameter(int parameterIndex, float newValue);
+
+    AudioProcessorEditor* createEditor();
+
+    bool hasEditor() const
+    {
+        return true;
+    }
+
+    void updateSettings();
+
+    bool enable();
+
+    enum Method
+    {
+        HILBERT = 0,   /**< Amplitude and phase from the analytic signal. */
+        RMS            /**< Amplitude from a sliding RMS window. */
+    };
+
+    enum Output
+    {
+        AMPLITUDE = 0, /**< Instantaneous amplitude, in input units. */
+        PHASE          /**< Instantaneous phase in degrees (Hilbert only). */
+    };
+
+    /** Returns the delay between a change in the input and the matching
+        change in the output (and its events), in samples. */
+    int getLatency();
+
+private:
+
+    typedef Dsp::Butterworth::Design::BandPass <2> BandPassDesign;
+    typedef Dsp::TransposedCascade <2, double> BandPassCascade;
+
+    struct ChannelState
+    {
+        BandPassCascade::State bandPass;
+
+        Dsp::HilbertFir::State hilbert;
+
+        /** RMS only: the last window of squares, and their sum. */
+        HeapBlock<float> squares;
+        double sumOfSquares;
+
+        bool isAbove;
+    };
+
+    /** Designs the band-pass and the Hilbert filter and sizes every channel's
+        state. Not for the audio thread; parameters that need it can only be
+        changed while acquisition is stopped. */
+    void prepare();
+
+    void processHilbert(ChannelState* channel, int chan, float* data,
+                        int nSamples, MidiBuffer& events);
+    void processRms(ChannelState* channel, int chan, float* data,
+                    int nSamples, MidiBuffer& events);
+
+    void addThresholdEvents(ChannelState* channel, int chan, const float* amplitude,
+                            int firstSample, int nSamples, MidiBuffer& events);
+
+    double lowCut, highCut;
+    Method method;
+    Output output;
+    float threshold;
+    double rmsWindowMs;
+
+    BandPassDesign bandPassDesign;
+    BandPassCascade bandPass;
+
+    Dsp::HilbertFir hilbert;
+
+    int rmsWindow;
+    int rmsIndex;
+
+    OwnedArray<ChannelState> channels;
+
+    double bandPassDelay;
+
+    /** Scratch space for the imaginary part of the analytic signal. */
+    HeapBlock<float> imaginary;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BandPowerNode);
+
+};
+
+#endif  // __BANDPOWERNODE_H_2D6B81F3__
@@ -23,30 +23,41 @@
 
 #include "Channel.h"
 
+ChannelInfo::ChannelInfo() :
+    sampleRate(44100.0f), bitVolts(1.0f), eventType(0), isEventChannel(false)
+{
+}
+
+ChannelInfo::ChannelInfo(const ChannelInfo& other) :
+    name(other.name), sampleRate(other.sampleRate), bitVolts(other.bitVolts),
+    eventType(other.eventType), isEventChannel(other.isEventChannel)
+{
+}
 
 Channel::Channel(GenericProcessor* p, int n) :
-    num(n), eventType(0), isEventChannel(false), isRecording(false),
-    isMonitored(false), isEnabled(true), processor(p),
-    sampleRate(44100.0f), bitVolts(1.0f)
+    num(n), isRecording(false), isMonitored(false), isEnabled(true),
+    processor(p), file(nullptr), info(new ChannelInfo())
 {
     nodeId = p->getNodeId();
 
     createDefaultName();
 }
 
-Channel::Channel(const Channel& ch)
+Channel::Channel(const Channel& ch) :
+    file(nullptr)
+{
+    inherit(ch);
+}
+
+void Channel::inherit(const Channel& ch)
 {
     processor = ch.processor;
-    isEventChannel = ch.isEventChannel;
     isEnabled = ch.isEnabled;
     isRecording = false;
     isMonitored = false;
-    sampleRate = ch.sampleRate;
-    bitVolts = ch.bitVolts;
-    name = ch.name;
-    eventType = ch.eventType;
     nodeId = ch.nodeId;
     num = ch.num;
+    info = ch.info;
 }
 
 void Channel::setProcessor(GenericProcessor* p)
@@ -55,28 +66,57 @@ void Channel::setProcessor(GenericProcessor* p)
     nodeId = p->getNodeId();
 }
 
-String Channel::getName()
+ChannelInfo* Channel::getWritableInfo()
 {
-    return name;
+    if (info->getReferenceCount() > 1)
+        info = new ChannelInfo(*info);
 
+    return info;
 }
 
 void Channel::setName(String name_)
 {
-    name = name_;
+    if (name_ != info->name)
+        getWritableInfo()->name = name_;
+}
+
+void Channel::setSampleRate(float sampleRate)
+{
+    if (sampleRate != info->sampleRate)
+        getWritableInfo()->sampleRate = sampleRate;
+}
+
+void Channel::setBitVolts(float bitVolts)
+{
+    if (bitVolts != info->bitVolts)
+        getWritableInfo()->bitVolts = bitVolts;
+}
+
+void Channel::setEventType(int eventType)
+{
+    if (eventType != info->eventType)
+        getWritableInfo()->eventType = eventType;
+}
+
+void Channel::setEventChannel(bool isEvent)
+{
+    if (isEvent != info->isEventChannel)
+        getWritableInfo()->isEventChannel = isEvent;
 }
 
 void Channel::reset()
 {
     createDefaultName();
 
-    sampleRate = 44100.0f;
-    bitVolts = 1.0f;
+    setSampleRate(44100.0f);
+    setBitVolts(1.0f);
 
 }
 
 void Channel::createDefaultName()
 {
-    name = String("CH");
+    String name("CH");
     name += (num + 1);
+
+    setName(name);
 }
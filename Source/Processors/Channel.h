@@ -33,6 +33,44 @@
 
 class GenericProcessor;
 
+/**
+
+  The metadata a channel carries from one processor to the next.
+
+  A ChannelInfo is reference-counted and shared by every Channel that
+  describes the same data, all the way down the signal chain. Channels
+  only make their own copy when a processor changes something (for
+  example, the ResamplingNode's sample rate), so an update that leaves
+  a channel alone costs no more than a pointer copy.
+
+  @see Channel
+
+*/
+
+class ChannelInfo : public ReferenceCountedObject
+
+{
+public:
+
+    ChannelInfo();
+
+    /** Copies the metadata, for a Channel that is about to change it. */
+    ChannelInfo(const ChannelInfo& other);
+
+    typedef ReferenceCountedObjectPtr<ChannelInfo> Ptr;
+
+    String name;
+
+    float sampleRate;
+    float bitVolts;
+
+    /** Used for EventChannels only.*/
+    int eventType;
+
+    bool isEventChannel;
+
+};
+
 /**
 
   Holds metadata about a given channel within a processor.
@@ -43,7 +81,11 @@ class GenericProcessor;
   AudioNode and RecordNode, which need to access/update Channel
   information for multiple processors at once.
 
-  @see GenericProcessor, RecordNode, AudioNode
+  The name, sample rate, bitVolts and event type live in a ChannelInfo
+  that is shared with the upstream channel this one was copied from;
+  the setters below copy it first if it is shared and the value changes.
+
+  @see GenericProcessor, RecordNode, AudioNode, ChannelInfo
 
 */
 
@@ -55,15 +97,52 @@ public:
     /** Default constructor for creating Channels from scratch. */
     Channel(GenericProcessor* p, int n);
 
-    /** Copy constructor. */
+    /** Copy constructor. Shares the metadata of the original. */
     Channel(const Channel& ch);
 
+    /** Takes on the metadata of another channel (sharing it, not copying it),
+        as the copy constructor does, so that Channels can be reused. */
+    void inherit(const Channel& ch);
+
     /** Returns the name of a given channel. */
-    String getName();
+    String getName() const
+    {
+        return info->name;
+    }
 
     /** Sets the name of a given channel. */
     void setName(String);
 
+    float getSampleRate() const
+    {
+        return info->sampleRate;
+    }
+
+    void setSampleRate(float);
+
+    /** Returns the size of one bit of the channel's samples, in microvolts. */
+    float getBitVolts() const
+    {
+        return info->bitVolts;
+    }
+
+    void setBitVolts(float);
+
+    /** Used for EventChannels only.*/
+    int getEventType() const
+    {
+        return info->eventType;
+    }
+
+    void setEventType(int);
+
+    bool isEventChannel() const
+    {
+        return info->isEventChannel;
+    }
+
+    void setEventChannel(bool);
+
     /** Restores the default settings for a given channel. */
     void reset();
 
@@ -76,11 +155,7 @@ public:
     /** The ID of the channel's processor.*/
     int nodeId;
 
-    /** Used for EventChannels only.*/
-    int eventType;
-
     // boolean values:
-    bool isEventChannel;
     bool isRecording;
     bool isMonitored;
     bool isEnabled;
@@ -88,21 +163,21 @@ public:
     /** Pointer to the channel's parent processor. */
     GenericProcessor* processor;
 
-    // crucial information:
-    float sampleRate;
-    float bitVolts;
-
     // file info (for disk writing):
     String filename;
     FILE* file;
 
-    String name;
-
 private:
 
+    /** Makes sure no other Channel shares this one's metadata,
+        before it is changed. */
+    ChannelInfo* getWritableInfo();
+
     /** Generates a default name, based on the channel number. */
     void createDefaultName();
 
+    ChannelInfo::Ptr info;
+
 };
 
 #endif  // __CHANNEL_H_DABDFE3F__
@@ -24,10 +24,10 @@
 #include "DataBuffer.h"
 
 DataBuffer::DataBuffer(int chans, int size)
-    : abstractFifo(size), buffer(chans, size), numChans(chans)
+    : abstractFifo(size), buffer(chans, size), numChans(chans), numSamplesRead(0)
 {
-    timestampBuffer = new uint64[size];
-    eventCodeBuffer = new int16[size];
+    timestampBuffer.malloc(size);
+    eventCodeBuffer.malloc(size);
 
 }
 
@@ -42,31 +42,79 @@ void DataBuffer::clear()
 void DataBuffer::resize(int chans, int size)
 {
     buffer.setSize(chans, size);
-    timestampBuffer = new uint64[size];
-    eventCodeBuffer = new int16[size];
+    abstractFifo.setTotalSize(size);
+    numSamplesRead = numSamplesWritten.get(); // whatever was waiting is gone
+    timestampBuffer.malloc(size);
+    eventCodeBuffer.malloc(size);
 
     numChans = chans;
 }
 
 void DataBuffer::addToBuffer(float* data, uint64* timestamps, int16* eventCodes, int numItems)
 {
-    // writes one sample for all channels
     int startIndex1, blockSize1, startIndex2, blockSize2;
     abstractFifo.prepareToWrite(numItems, startIndex1, blockSize1, startIndex2, blockSize2);
 
-    for (int chan = 0; chan < numChans; chan++)
+    // anything that doesn't fit is lost, so only commit what was granted
+    const int numWritten = blockSize1 + blockSize2;
+
+    for (int i = 0; i < numWritten; i++)
     {
+        const int index = (i < blockSize1) ? startIndex1 + i : startIndex2 + (i - blockSize1);
 
-        buffer.copyFrom(chan, // int destChannel
-                        startIndex1, // int destStartSample
-                        data + chan,  // const float* source
-                        1); // int num samples
+        for (int chan = 0; chan < numChans; chan++)
+        {
+            *buffer.getSampleData(chan, index) = data[i*numChans + chan];
+        }
+
+        timestampBuffer[index] = timestamps[i];
+        eventCodeBuffer[index] = eventCodes[i];
     }
 
-    *(timestampBuffer + startIndex1) = *timestamps;
-    *(eventCodeBuffer + startIndex1) = *eventCodes;
+    finishedWrite(numWritten);
+
+    if (numWritten < numItems)
+        samplesDropped(numSamplesWritten.get(), numItems - numWritten);
+}
+
+void DataBuffer::prepareToWrite(int numItems, int& startIndex1, int& blockSize1,
+                                int& startIndex2, int& blockSize2)
+{
+    abstractFifo.prepareToWrite(numItems, startIndex1, blockSize1, startIndex2, blockSize2);
+
+    const int numWritable = blockSize1 + blockSize2;
 
+    // the dropped samples are the ones after those about to be written
+    if (numWritable < numItems)
+        samplesDropped(numSamplesWritten.get() + numWritable, numItems - numWritable);
+}
+
+void DataBuffer::samplesDropped(int64 position, int numDropped)
+{
+    // store the position first, so a reader that sees the new count also sees where it happened
+    lastLossPosition = position;
+    numSamplesLost += (int64) numDropped;
+}
+
+float* DataBuffer::getWritePointer(int chan, int index)
+{
+    return buffer.getSampleData(chan, index);
+}
+
+uint64* DataBuffer::getTimestampWritePointer(int index)
+{
+    return timestampBuffer + index;
+}
+
+int16* DataBuffer::getEventCodeWritePointer(int index)
+{
+    return eventCodeBuffer + index;
+}
+
+void DataBuffer::finishedWrite(int numItems)
+{
     abstractFifo.finishedWrite(numItems);
+    numSamplesWritten += (int64) numItems;
 }
 
 int DataBuffer::getNumSamples()
@@ -74,8 +122,23 @@ int DataBuffer::getNumSamples()
     return abstractFifo.getNumReady();
 }
 
+int64 DataBuffer::getNumSamplesLost()
+{
+    return numSamplesLost.get();
+}
+
+int64 DataBuffer::getLastLossPosition()
+{
+    return lastLossPosition.get();
+}
 
-int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamp, int16* eventCodes, int maxSize)
+int64 DataBuffer::getNumSamplesRead()
+{
+    return numSamplesRead;
+}
+
+
+int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamps, int16* eventCodes, int maxSize)
 {
     // check to see if the maximum size is smaller than the total number of available ints
     int numItems = (maxSize < abstractFifo.getNumReady()) ?
@@ -97,13 +160,9 @@ int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamp, in
                           blockSize1); // numSamples
         }
 
-        memcpy(timestamp, timestampBuffer+startIndex1, 8);
+        memcpy(timestamps, timestampBuffer+startIndex1, blockSize1*8);
         memcpy(eventCodes, eventCodeBuffer+startIndex1, blockSize1*2);
     }
-    else
-    {
-        memcpy(timestamp, timestampBuffer+startIndex2, 8);
-    }
 
     if (blockSize2 > 0)
     {
@@ -117,11 +176,13 @@ int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamp, in
                           startIndex2,     // sourceStartSample
                           blockSize2); // numSamples
         }
+        memcpy(timestamps + blockSize1, timestampBuffer+startIndex2, blockSize2*8);
         memcpy(eventCodes + blockSize1, eventCodeBuffer+startIndex2, blockSize2*2);
     }
 
     abstractFifo.finishedRead(numItems);
+    numSamplesRead += numItems;
 
     return numItems;
 
-}
\ No newline at end of file
+}
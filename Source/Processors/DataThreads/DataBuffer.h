@@ -44,27 +44,74 @@ public:
     /** Clears the buffer.*/
     void clear();
 
-    /** Add an array of floats to the buffer.*/
+    /** Add an array of floats to the buffer. The data must be interleaved
+        (all channels for the first sample, then all channels for the next),
+        with one timestamp and one event code per sample.
+
+        If the buffer is full, the samples that don't fit are dropped and
+        counted; see getNumSamplesLost().*/
     void addToBuffer(float* data, uint64* ts, int16* eventCodes, int numItems);
 
+    /** Reserves space for up to numItems samples so that a DataThread can write them
+        in place, without building an interleaved array first. The space is returned as
+        up to two contiguous regions (as with AbstractFifo::prepareToWrite); fill them
+        using the write pointers below, then call finishedWrite() with the number of
+        samples written. Any part of numItems that doesn't fit is counted as lost.*/
+    void prepareToWrite(int numItems, int& startIndex1, int& blockSize1,
+                        int& startIndex2, int& blockSize2);
+
+    /** Returns a pointer to a channel's storage at an index returned by prepareToWrite().*/
+    float* getWritePointer(int chan, int index);
+
+    /** Returns a pointer to the timestamp storage at an index returned by prepareToWrite().*/
+    uint64* getTimestampWritePointer(int index);
+
+    /** Returns a pointer to the event code storage at an index returned by prepareToWrite().*/
+    int16* getEventCodeWritePointer(int index);
+
+    /** Makes samples written through prepareToWrite() available to the reader.*/
+    void finishedWrite(int numItems);
+
     /** Returns the number of samples currently available in the buffer.*/
     int getNumSamples();
 
-    /** Copies as many samples as possible from the DataBuffer to an AudioSampleBuffer.*/
+    /** Copies as many samples as possible from the DataBuffer to an AudioSampleBuffer.
+        One timestamp and one event code per sample are copied into the arrays
+        provided, which must hold at least maxSize values.*/
     int readAllFromBuffer(AudioSampleBuffer& data, uint64* ts, int16* eventCodes, int maxSize);
 
     /** Resizes the data buffer */
     void resize(int chans, int size);
 
+    /** Returns the total number of samples that were dropped because the buffer
+        was full when the DataThread tried to write them. Safe to call from any thread.*/
+    int64 getNumSamplesLost();
+
+    /** Returns where the most recent drop happened, as a count of the samples
+        written before it. Compare with getNumSamplesRead() to find the gap in a
+        block that has just been read. Safe to call from any thread.*/
+    int64 getLastLossPosition();
+
+    /** Returns the total number of samples read by readAllFromBuffer().
+        Only meaningful on the reading thread.*/
+    int64 getNumSamplesRead();
+
 private:
     AbstractFifo abstractFifo;
     AudioSampleBuffer buffer;
 
-    uint64* timestampBuffer;
-    int16* eventCodeBuffer;
+    HeapBlock<uint64> timestampBuffer;
+    HeapBlock<int16> eventCodeBuffer;
 
     int numChans;
 
+    Atomic<int64> numSamplesLost;
+    Atomic<int64> numSamplesWritten;
+    Atomic<int64> lastLossPosition;
+    int64 numSamplesRead;
+
+    void samplesDropped(int64 position, int numDropped);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DataBuffer);
 
 };
@@ -96,6 +96,15 @@ public:
     /** Changes the names of channels, if the thread needs custom names. */
     virtual void updateChannelNames() { }
 
+    /** Returns true if the timestamp of each sample is exactly one greater
+    than the timestamp of the previous sample, so that the SourceNode can
+    detect gaps in the data stream. Sources that stamp samples with a clock
+    time instead should return false.*/
+    virtual bool hasContinuousTimestamps()
+    {
+        return true;
+    }
+
     SourceNode* sn;
 
     int16 eventCode;
@@ -25,11 +25,11 @@
 #include "FileReaderThread.h"
 
 FileReaderThread::FileReaderThread(SourceNode* sn) :
-    DataThread(sn), lengthOfInputFile(0), bufferSize(0), input(0)
+    DataThread(sn), bufferSize(4800),
+    samplesOwed(0.0), lastUpdateTicks(0)
 {
 
-    bufferSize = 1600;
-    dataBuffer = new DataBuffer(16, bufferSize*3);
+    dataBuffer = new DataBuffer(16, bufferSize);
 
     eventCode = 0;
 
@@ -39,8 +39,7 @@ FileReaderThread::FileReaderThread(SourceNode* sn) :
 
 FileReaderThread::~FileReaderThread()
 {
-    if (input)
-        fclose(input);
+
 }
 
 void FileReaderThread::setFile(String fullpath)
@@ -48,26 +47,12 @@ void FileReaderThread::setFile(String fullpath)
 
     filePath = fullpath;
 
-    const char* path = filePath.getCharPointer();
-
-    if (input)
-        fclose(input);
-
-    input = fopen(path, "r");
-
-    // Avoid a segfault if file isn't found
-    if (!input)
-    {
-        std::cout << "Can't find data file "
-                  << '"' << path << "\""
-                  << std::endl;
+    if (!playbackFile.open(File(filePath)))
         return;
-    }
-
-    fseek(input, 0, SEEK_END);
-    lengthOfInputFile = ftell(input);
-    rewind(input);
 
+    // hold one second of data, so playback can run well ahead of the audio callbacks
+    bufferSize = jmax(4800, roundFloatToInt(playbackFile.getSampleRate()));
+    dataBuffer->resize(playbackFile.getNumChannels(), bufferSize);
 
     sn->tryEnablingEditor();
 
@@ -78,31 +63,40 @@ String FileReaderThread::getFile()
     return filePath;
 }
 
+int64 FileReaderThread::getNumSamplesInFile()
+{
+    return playbackFile.getNumSamples();
+}
+
 bool FileReaderThread::foundInputSource()
 {
-    return input != 0;
+    return playbackFile.isOpen();
 }
 
 int FileReaderThread::getNumChannels()
 {
-    return 16;
+    return playbackFile.getNumChannels();
 }
 
 float FileReaderThread::getSampleRate()
 {
-    return 28000.0f;
+    return playbackFile.getSampleRate();
 }
 
 float FileReaderThread::getBitVolts()
 {
-    return 0.0305f;
+    return playbackFile.getBitVolts();
 }
 
 bool FileReaderThread::startAcquisition()
 {
-    if (!input)
+    if (!playbackFile.isOpen())
         return false;
 
+    dataBuffer->clear();
+    samplesOwed = 0.0;
+    lastUpdateTicks = Time::getHighResolutionTicks();
+
     startThread();
     return true;
 }
@@ -118,50 +112,59 @@ bool FileReaderThread::stopAcquisition()
     return true;
 }
 
-bool FileReaderThread::updateBuffer()
+void FileReaderThread::writeToBuffer(int startIndex, int numSamples)
 {
-    if (!input)
-        return false;
-    if (dataBuffer->getNumSamples() < bufferSize)
+    if (numSamples <= 0)
+        return;
+
+    for (int chan = 0; chan < playbackFile.getNumChannels(); chan++)
     {
-        //       // std::cout << dataBuffer->getNumSamples() << std::endl;
+        playbackFile.readChannel(chan, dataBuffer->getWritePointer(chan, startIndex), numSamples);
+    }
 
-        if (ftell(input) >= lengthOfInputFile - bufferSize)
-        {
-            rewind(input);
-        }
+    uint64* ts = dataBuffer->getTimestampWritePointer(startIndex);
+    int16* codes = dataBuffer->getEventCodeWritePointer(startIndex);
 
-        size_t a = fread(readBuffer, 2, bufferSize, input);
+    for (int i = 0; i < numSamples; i++)
+    {
+        ts[i] = timestamp++;
+        codes[i] = eventCode;
+    }
 
-        int chan = 0;
+    playbackFile.advance(numSamples);
+}
 
-        for (int n = 0; n < bufferSize; n++)
-        {
-            thisSample[chan] = float(-readBuffer[n]) * 0.0305; // previously 0.035
+bool FileReaderThread::updateBuffer()
+{
+    if (!playbackFile.isOpen())
+        return false;
 
-            if (chan == 15)
-            {
+    // work out how many samples are due since the last update
+    const int64 now = Time::getHighResolutionTicks();
 
-                timestamp++; // = (0 << 0) + (0 << 8) + (0 << 16) + (0 << 24); // +
-                //(4 << 32); // + (3 << 40) + (2 << 48) + (1 << 56);
+    samplesOwed += double(now - lastUpdateTicks) * playbackFile.getSampleRate()
+                   / double(Time::getHighResolutionTicksPerSecond());
+    lastUpdateTicks = now;
 
-                //timestamp++; // = timer.getHighResolutionTicks();
-                dataBuffer->addToBuffer(thisSample, &timestamp, &eventCode, 1);
-                chan = 0;
-            }
-            else
-            {
-                chan++;
-            }
+    // never write more than there is room for; if the reader falls behind,
+    // playback pauses rather than dropping data
+    const int space = bufferSize - 1 - dataBuffer->getNumSamples();
+    const int numSamples = jmin((int) samplesOwed, space);
 
+    if (numSamples > 0)
+    {
+        int startIndex1, blockSize1, startIndex2, blockSize2;
+        dataBuffer->prepareToWrite(numSamples, startIndex1, blockSize1, startIndex2, blockSize2);
 
-        }
+        writeToBuffer(startIndex1, blockSize1);
+        writeToBuffer(startIndex2, blockSize2);
 
+        dataBuffer->finishedWrite(blockSize1 + blockSize2);
     }
-    else
-    {
-        wait(50); // pause for 50 ms to decrease sample rate
-    }
+
+    samplesOwed = jmin(samplesOwed - numSamples, double(bufferSize));
+
+    wait(5);
 
     return true;
 }
@@ -26,19 +26,20 @@
 
 #include "../../../JuceLibraryCode/JuceHeader.h"
 
-#include <stdio.h>
-#include <time.h>
 #include "DataThread.h"
+#include "PlaybackFile.h"
 
 class SourceNode;
 
 /**
 
-  Fills a buffer with data from a file.
+  Fills a buffer with data from a recorded file.
 
-  Has issues with setting the correct sampling rate.
+  The file is memory-mapped by a PlaybackFile, and each block is decoded
+  directly into the DataBuffer. Playback is paced against the high-resolution
+  clock.
 
-  @see DataThread
+  @see DataThread, PlaybackFile
 
 */
 
@@ -59,16 +60,21 @@ public:
     void setFile(String fullpath);
     String getFile();
 
+    /** Returns the number of samples per channel in the file.*/
+    int64 getNumSamplesInFile();
+
 private:
-    int lengthOfInputFile;
-    FILE* input;
 
-    float thisSample[16];
-    int16 readBuffer[1600];
+    PlaybackFile playbackFile;
+
+    String filePath;
 
     int bufferSize;
 
-    String filePath;
+    double samplesOwed;
+    int64 lastUpdateTicks;
+
+    void writeToBuffer(int startIndex, int numSamples);
 
     bool updateBuffer();
 
@@ -52,6 +52,12 @@ public:
     float getBitVolts();
     int getNumEventChannels();
 
+    /** Samples are stamped with the system clock, not a sample count. */
+    bool hasContinuousTimestamps()
+    {
+        return false;
+    }
+
 private:
 
     struct ftdi_context ftdic;
@@ -0,0 +1,323 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "PlaybackFile.h"
+
+// layout of the .continuous format written by the RecordNode
+#define CONTINUOUS_HEADER_SIZE 1024
+#define CONTINUOUS_BLOCK_LENGTH 1024
+#define CONTINUOUS_TIMESTAMP_BYTES 8
+#define CONTINUOUS_COUNT_BYTES 2
+#define CONTINUOUS_MARKER_BYTES 10
+
+namespace
+{
+
+/** Orders channel files by name, comparing any trailing channel number
+    numerically so that CH2 comes before CH10. */
+struct ChannelFileSorter
+{
+    static int compareElements(const File& first, const File& second)
+    {
+        const String a = first.getFileNameWithoutExtension();
+        const String b = second.getFileNameWithoutExtension();
+
+        const String stemA = a.trimCharactersAtEnd("0123456789");
+        const String stemB = b.trimCharactersAtEnd("0123456789");
+
+        const int stemOrder = stemA.compare(stemB);
+
+        if (stemOrder != 0)
+            return stemOrder;
+
+        const int numA = a.getTrailingIntValue();
+        const int numB = b.getTrailingIntValue();
+
+        return (numA < numB) ? -1 : ((numB < numA) ? 1 : 0);
+    }
+};
+
+}
+
+PlaybackFile::PlaybackFile()
+    : isContinuous(false), numChannels(0), sampleRate(0.0f), bitVolts(1.0f),
+      rawNumChannels(16), rawSampleRate(28000.0f), rawBitVolts(0.0305f),
+      numSamples(0), position(0),
+      headerBytes(CONTINUOUS_HEADER_SIZE), blockLength(CONTINUOUS_BLOCK_LENGTH), recordBytes(0)
+{
+
+}
+
+PlaybackFile::~PlaybackFile()
+{
+
+}
+
+void PlaybackFile::setRawFormat(int numChannels_, float sampleRate_, float bitVolts_)
+{
+    rawNumChannels = jmax(1, numChannels_);
+    rawSampleRate = sampleRate_;
+    rawBitVolts = bitVolts_;
+}
+
+void PlaybackFile::close()
+{
+    mappedFiles.clear();
+
+    numChannels = 0;
+    numSamples = 0;
+    position = 0;
+}
+
+bool PlaybackFile::open(const File& file)
+{
+    close();
+
+    if (!file.existsAsFile())
+    {
+        std::cout << "Can't find data file \"" << file.getFullPathName() << "\"" << std::endl;
+        return false;
+    }
+
+    bool success;
+
+    if (file.hasFileExtension(".continuous"))
+        success = openContinuous(file);
+    else
+        success = openRaw(file);
+
+    if (!success)
+    {
+        close();
+        return false;
+    }
+
+    std::cout << "Mapped " << numChannels << " channels of "
+              << numSamples << " samples at " << sampleRate << " Hz." << std::endl;
+
+    return true;
+}
+
+bool PlaybackFile::openRaw(const File& file)
+{
+    MemoryMappedFile* mapped = new MemoryMappedFile(file, MemoryMappedFile::readOnly);
+    mappedFiles.add(mapped);
+
+    if (mapped->getData() == nullptr)
+    {
+        std::cout << "Unable to map " << file.getFullPathName() << std::endl;
+        return false;
+    }
+
+    isContinuous = false;
+
+    numChannels = rawNumChannels;
+    sampleRate = rawSampleRate;
+    bitVolts = rawBitVolts;
+
+    numSamples = (int64) mapped->getSize() / (2 * numChannels);
+
+    return numSamples > 0;
+}
+
+bool PlaybackFile::openContinuous(const File& file)
+{
+    // every channel of a processor shares the "<nodeId>_" prefix
+    const String name = file.getFileNameWithoutExtension();
+    const int underscore = name.indexOfChar('_');
+    const String prefix = (underscore > 0) ? name.substring(0, underscore + 1) : name;
+
+    Array<File> channelFiles;
+    file.getParentDirectory().findChildFiles(channelFiles, File::findFiles, false,
+                                             prefix + "*.continuous");
+
+    if (channelFiles.size() == 0)
+        channelFiles.add(file);
+
+    ChannelFileSorter sorter;
+    channelFiles.sort(sorter);
+
+    // the header is a plain-text block at the start of each file
+    String header;
+    {
+        FileInputStream stream(channelFiles[0]);
+
+        if (stream.failedToOpen())
+            return false;
+
+        MemoryBlock headerData;
+        stream.readIntoMemoryBlock(headerData, CONTINUOUS_HEADER_SIZE);
+        header = headerData.toString();
+    }
+
+    if (!header.startsWith("header."))
+    {
+        std::cout << channelFiles[0].getFileName() << " does not have an Open Ephys header." << std::endl;
+        return false;
+    }
+
+    const String headerSize = getHeaderField(header, "header_bytes");
+    const String blockSize = getHeaderField(header, "blockLength");
+
+    headerBytes = headerSize.isEmpty() ? CONTINUOUS_HEADER_SIZE : headerSize.getLargeIntValue();
+    blockLength = blockSize.isEmpty() ? CONTINUOUS_BLOCK_LENGTH : blockSize.getIntValue();
+
+    sampleRate = getHeaderField(header, "sampleRate").getFloatValue();
+    bitVolts = getHeaderField(header, "bitVolts").getFloatValue();
+
+    if (blockLength <= 0 || sampleRate <= 0.0f)
+        return false;
+
+    if (bitVolts <= 0.0f)
+        bitVolts = 1.0f;
+
+    recordBytes = CONTINUOUS_TIMESTAMP_BYTES + CONTINUOUS_COUNT_BYTES
+                  + 2 * (int64) blockLength + CONTINUOUS_MARKER_BYTES;
+
+    isContinuous = true;
+    numSamples = -1;
+
+    for (int i = 0; i < channelFiles.size(); i++)
+    {
+        MemoryMappedFile* mapped = new MemoryMappedFile(channelFiles[i], MemoryMappedFile::readOnly);
+
+        if (mapped->getData() == nullptr)
+        {
+            std::cout << "Unable to map " << channelFiles[i].getFullPathName() << std::endl;
+            delete mapped;
+            continue;
+        }
+
+        // only complete records are played; a partially written last record is ignored
+        const int64 numRecords = ((int64) mapped->getSize() - headerBytes) / recordBytes;
+        const int64 length = jmax((int64) 0, numRecords) * blockLength;
+
+        numSamples = (numSamples < 0) ? length : jmin(numSamples, length);
+
+        mappedFiles.add(mapped);
+    }
+
+    numChannels = mappedFiles.size();
+
+    if (numSamples < 0)
+        numSamples = 0;
+
+    return numChannels > 0 && numSamples > 0;
+}
+
+String PlaybackFile::getHeaderField(const String& header, const String& name)
+{
+    // fields look like "header.sampleRate = 30000;\n"
+    const String key = "header." + name;
+    int index = header.indexOf(key);
+
+    while (index >= 0)
+    {
+        const String rest = header.substring(index + key.length()).trimStart();
+
+        if (rest.startsWithChar('='))
+        {
+            return rest.substring(1).upToFirstOccurrenceOf(";", false, false)
+                                    .trim()
+                                    .unquoted();
+        }
+
+        index = header.indexOf(index + key.length(), key);
+    }
+
+    return String::empty;
+}
+
+void PlaybackFile::setPosition(int64 sample)
+{
+    if (numSamples <= 0)
+    {
+        position = 0;
+        return;
+    }
+
+    position = sample % numSamples;
+
+    if (position < 0)
+        position += numSamples;
+}
+
+void PlaybackFile::advance(int n)
+{
+    setPosition(position + n);
+}
+
+void PlaybackFile::readChannel(int chan, float* dest, int n) const
+{
+    if (chan < 0 || chan >= numChannels || numSamples <= 0)
+    {
+        FloatVectorOperations::clear(dest, n);
+        return;
+    }
+
+    int64 pos = position;
+
+    while (n > 0)
+    {
+        if (isContinuous)
+        {
+            const int64 record = pos / blockLength;
+            const int offset = (int)(pos % blockLength);
+
+            const int count = (int) jmin((int64) n, (int64)(blockLength - offset), numSamples - pos);
+
+            const char* src = (const char*) mappedFiles.getUnchecked(chan)->getData()
+                              + headerBytes + record * recordBytes
+                              + CONTINUOUS_TIMESTAMP_BYTES + CONTINUOUS_COUNT_BYTES
+                              + 2 * offset;
+
+            // samples are stored big-endian, scaled by 1/bitVolts
+            for (int i = 0; i < count; i++)
+                dest[i] = float((int16) ByteOrder::bigEndianShort(src + 2 * i)) * bitVolts;
+
+            dest += count;
+            n -= count;
+            pos += count;
+        }
+        else
+        {
+            const int count = (int) jmin((int64) n, numSamples - pos);
+
+            const char* src = (const char*) mappedFiles.getUnchecked(0)->getData()
+                              + 2 * (pos * numChannels + chan);
+
+            const int stride = 2 * numChannels;
+
+            // raw files are stored with inverted polarity, as the old reader assumed
+            for (int i = 0; i < count; i++)
+                dest[i] = float(-(int16) ByteOrder::littleEndianShort(src + i * stride)) * bitVolts;
+
+            dest += count;
+            n -= count;
+            pos += count;
+        }
+
+        if (pos >= numSamples)
+            pos = 0;
+    }
+}
@@ -0,0 +1,142 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __PLAYBACKFILE_H_5E0B7C21__
+#define __PLAYBACKFILE_H_5E0B7C21__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+
+/**
+
+  Memory-mapped access to previously recorded data.
+
+  Two formats are understood:
+
+  - Open Ephys .continuous files, as written by the RecordNode. Selecting any
+    one file opens every file in the same directory that shares its processor
+    prefix (e.g. "100_CH1.continuous" opens all "100_*.continuous" files), one
+    channel per file. The sample rate and bitVolts are taken from the header.
+
+  - Anything else is treated as raw interleaved little-endian int16 data, using
+    the format given to setRawFormat().
+
+  Nothing is read up front; samples are decoded straight from the mapped pages
+  into the caller's buffer. Playback loops back to the start of the file when
+  it reaches the end.
+
+  @see FileReader, FileReaderThread
+
+*/
+
+class PlaybackFile
+{
+public:
+
+    PlaybackFile();
+    ~PlaybackFile();
+
+    /** Sets the channel count, sample rate and bitVolts used for raw files, which
+        have no header. Takes effect the next time open() is called.*/
+    void setRawFormat(int numChannels, float sampleRate, float bitVolts);
+
+    /** Maps a file (or group of .continuous files). Returns false if nothing could be opened.*/
+    bool open(const File& file);
+
+    /** Unmaps all files.*/
+    void close();
+
+    bool isOpen() const
+    {
+        return numSamples > 0;
+    }
+
+    int getNumChannels() const
+    {
+        return numChannels;
+    }
+
+    float getSampleRate() const
+    {
+        return sampleRate;
+    }
+
+    float getBitVolts() const
+    {
+        return bitVolts;
+    }
+
+    /** Returns the number of samples per channel.*/
+    int64 getNumSamples() const
+    {
+        return numSamples;
+    }
+
+    /** Returns the index of the next sample to be read.*/
+    int64 getPosition() const
+    {
+        return position;
+    }
+
+    /** Moves the read position, wrapping it into the length of the file.*/
+    void setPosition(int64 sample);
+
+    /** Decodes numSamples values of one channel, starting at the current position,
+        into dest (already scaled to microvolts). Wraps around at the end of the file.
+        Does not move the read position; call advance() once all channels have been read.*/
+    void readChannel(int chan, float* dest, int numSamples) const;
+
+    /** Moves the read position forward, wrapping around at the end of the file.*/
+    void advance(int numSamples);
+
+private:
+
+    bool openContinuous(const File& file);
+    bool openRaw(const File& file);
+
+    static String getHeaderField(const String& header, const String& name);
+
+    OwnedArray<MemoryMappedFile> mappedFiles;
+
+    bool isContinuous;
+
+    int numChannels;
+    float sampleRate;
+    float bitVolts;
+
+    int rawNumChannels;
+    float rawSampleRate;
+    float rawBitVolts;
+
+    int64 numSamples;
+    int64 position;
+
+    int64 headerBytes;
+    int blockLength;
+    int64 recordBytes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlaybackFile);
+
+};
+
+
+#endif  // __PLAYBACKFILE_H_5E0B7C21__
@@ -50,10 +50,8 @@ AudioWindowButton::AudioWindowButton()
 {
     setClickingTogglesState(true);
 
-    MemoryInputStream mis(BinaryData::silkscreenserialized, BinaryData::silkscreenserializedSize, false);
-    Typeface::Ptr typeface = new CustomTypeface(mis);
-    font = Font(typeface);
-    font.setHeight(12);
+    // the look and feel's copy of the typeface, rather than parsing another one
+    font = Font("Small Text", 12, Font::plain);
 }
 
 AudioWindowButton::~AudioWindowButton()
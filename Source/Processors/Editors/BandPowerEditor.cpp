@@ -0,0 +1,294 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "BandPowerEditor.h"
+#include "../BandPowerNode.h"
+#include <stdio.h>
+
+
+BandPowerEditor::BandPowerEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors=true)
+    : GenericEditor(parentNode, useDefaultParameterEditors)
+
+{
+    desiredWidth = 250;
+
+    lastLowCutString = "150";
+    lastHighCutString = "250";
+    lastThresholdString = "50";
+    lastWindowString = "20";
+
+    lowCutValue = createValue("low cut value", "Low cut:", lastLowCutString, 10, 25);
+    highCutValue = createValue("high cut value", "High cut:", lastHighCutString, 10, 75);
+
+    methodSelector = createSelector("method", "Method:", 85, 25);
+    methodSelector->addItem("Hilbert", 1);
+    methodSelector->addItem("RMS", 2);
+    methodSelector->setSelectedId(1, true);
+    methodSelector->setTooltip("Hilbert gives amplitude and phase; a sliding RMS window "
+                               "gives amplitude only, with less delay.");
+
+    outputSelector = createSelector("output", "Output:", 85, 75);
+    outputSelector->addItem("Amplitude", 1);
+    outputSelector->addItem("Phase", 2);
+    outputSelector->setSelectedId(1, true);
+    outputSelector->setTooltip("Phase is in degrees, and needs the Hilbert method. Events "
+                               "always follow the amplitude.");
+
+    thresholdValue = createValue("threshold value", "Threshold:", lastThresholdString, 170, 25);
+    thresholdValue->setTooltip("An event goes out when a channel's amplitude crosses this value.");
+
+    windowValue = createValue("window value", "RMS (ms):", lastWindowString, 170, 75);
+    windowValue->setEditable(false);
+
+    latencyLabel = new Label("latency", String::empty);
+    latencyLabel->setBounds(5,105,240,20);
+    latencyLabel->setFont(Font("Small Text", 12, Font::plain));
+    latencyLabel->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(latencyLabel);
+
+    updateLatencyLabel();
+
+}
+
+BandPowerEditor::~BandPowerEditor()
+{
+
+}
+
+Label* BandPowerEditor::createValue(const String& name, const String& label,
+                                    const String& value, int x, int y)
+{
+    Label* l = new Label(name + " label", label);
+    l->setBounds(x - 5, y, 80, 20);
+    l->setFont(Font("Small Text", 12, Font::plain));
+    l->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(l);
+    labels.add(l);
+
+    Label* v = new Label(name, value);
+    v->setBounds(x, y + 20, 60, 20);
+    v->setFont(Font("Default", 15, Font::plain));
+    v->setColour(Label::textColourId, Colours::white);
+    v->setColour(Label::backgroundColourId, Colours::grey);
+    v->setEditable(true);
+    v->addListener(this);
+    addAndMakeVisible(v);
+
+    return v;
+}
+
+ComboBox* BandPowerEditor::createSelector(const String& name, const String& label, int x, int y)
+{
+    Label* l = new Label(name + " label", label);
+    l->setBounds(x - 5, y, 80, 20);
+    l->setFont(Font("Small Text", 12, Font::plain));
+    l->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(l);
+    labels.add(l);
+
+    ComboBox* selector = new ComboBox(name);
+    selector->setBounds(x, y + 20, 75, 20);
+    selector->addListener(this);
+    addAndMakeVisible(selector);
+
+    return selector;
+}
+
+void BandPowerEditor::labelTextChanged(Label* label)
+{
+    BandPowerNode* bp = (BandPowerNode*) getProcessor();
+
+    Value val = label->getTextValue();
+    double requestedValue = double(val.getValue());
+
+    if (label == thresholdValue)
+    {
+        bp->setParameter(3, requestedValue);
+        lastThresholdString = label->getText();
+        return;
+    }
+
+    if (label == windowValue)
+    {
+        if (requestedValue < 1 || requestedValue > 1000)
+        {
+            sendActionMessage("RMS window out of range (1-1000 ms).");
+            label->setText(lastWindowString, dontSendNotification);
+            return;
+        }
+
+        bp->setParameter(5, requestedValue);
+        lastWindowString = label->getText();
+    }
+    else
+    {
+        const double lowCut = (label == lowCutValue) ? requestedValue
+                              : lastLowCutString.getDoubleValue();
+        const double highCut = (label == highCutValue) ? requestedValue
+                               : lastHighCutString.getDoubleValue();
+
+        if (requestedValue < 0.01 || requestedValue > 10000 || lowCut >= highCut)
+        {
+            sendActionMessage("Value out of range.");
+
+            if (label == highCutValue)
+                label->setText(lastHighCutString, dontSendNotification);
+            else
+                label->setText(lastLowCutString, dontSendNotification);
+
+            return;
+        }
+
+        if (label == lowCutValue)
+        {
+            bp->setParameter(0, requestedValue);
+            lastLowCutString = label->getText();
+        }
+        else
+        {
+            bp->setParameter(1, requestedValue);
+            lastHighCutString = label->getText();
+        }
+    }
+
+    updateLatencyLabel();
+}
+
+void BandPowerEditor::comboBoxChanged(ComboBox* comboBox)
+{
+    BandPowerNode* bp = (BandPowerNode*) getProcessor();
+
+    if (comboBox == methodSelector)
+    {
+        const bool isRms = comboBox->getSelectedId() == 2;
+
+        bp->setParameter(2, isRms ? 1.0f : 0.0f);
+
+        // RMS has no phase
+        if (isRms)
+            outputSelector->setSelectedId(1);
+
+        outputSelector->setEnabled(!isRms);
+        windowValue->setEditable(isRms);
+
+        updateLatencyLabel();
+    }
+    else if (comboBox == outputSelector)
+    {
+        bp->setParameter(4, float(comboBox->getSelectedId() - 1));
+    }
+}
+
+void BandPowerEditor::updateSettings()
+{
+    // the latency depends on the sample rate
+    updateLatencyLabel();
+}
+
+void BandPowerEditor::updateLatencyLabel()
+{
+    BandPowerNode* bp = (BandPowerNode*) getProcessor();
+
+    const float sampleRate = bp->getSampleRate();
+
+    if (sampleRate <= 0)
+    {
+        latencyLabel->setText(String::empty, dontSendNotification);
+        return;
+    }
+
+    const int latency = bp->getLatency();
+
+    latencyLabel->setText("Latency: " + String(latency) + " samples ("
+                          + String(1000.0f * latency / sampleRate, 1) + " ms)",
+                          dontSendNotification);
+}
+
+void BandPowerEditor::startAcquisition()
+{
+    GenericEditor::startAcquisition();
+
+    // these redesign the filters and reallocate every channel's state
+    lowCutValue->setEditable(false);
+    highCutValue->setEditable(false);
+    windowValue->setEditable(false);
+    methodSelector->setEnabled(false);
+}
+
+void BandPowerEditor::stopAcquisition()
+{
+    GenericEditor::stopAcquisition();
+
+    lowCutValue->setEditable(true);
+    highCutValue->setEditable(true);
+    windowValue->setEditable(methodSelector->getSelectedId() == 2);
+    methodSelector->setEnabled(true);
+}
+
+void BandPowerEditor::saveEditorParameters(XmlElement* xml)
+{
+
+    xml->setAttribute("Type", "BandPowerEditor");
+
+    XmlElement* values = xml->createNewChildElement("VALUES");
+    values->setAttribute("LowCut",lastLowCutString);
+    values->setAttribute("HighCut",lastHighCutString);
+    values->setAttribute("Method",methodSelector->getSelectedId());
+    values->setAttribute("Output",outputSelector->getSelectedId());
+    values->setAttribute("Threshold",lastThresholdString);
+    values->setAttribute("Window",lastWindowString);
+
+}
+
+void BandPowerEditor::loadEditorParameters(XmlElement* xml)
+{
+
+    forEachXmlChildElement(*xml, xmlNode)
+    {
+        if (xmlNode->hasTagName("VALUES"))
+        {
+            BandPowerNode* bp = (BandPowerNode*) getProcessor();
+
+            lastLowCutString = xmlNode->getStringAttribute("LowCut", lastLowCutString);
+            lastHighCutString = xmlNode->getStringAttribute("HighCut", lastHighCutString);
+            lastThresholdString = xmlNode->getStringAttribute("Threshold", lastThresholdString);
+            lastWindowString = xmlNode->getStringAttribute("Window", lastWindowString);
+
+            lowCutValue->setText(lastLowCutString, dontSendNotification);
+            highCutValue->setText(lastHighCutString, dontSendNotification);
+            thresholdValue->setText(lastThresholdString, dontSendNotification);
+            windowValue->setText(lastWindowString, dontSendNotification);
+
+            bp->setParameter(0, lastLowCutString.getFloatValue());
+            bp->setParameter(1, lastHighCutString.getFloatValue());
+            bp->setParameter(3, lastThresholdString.getFloatValue());
+            bp->setParameter(5, lastWindowString.getFloatValue());
+
+            methodSelector->setSelectedId(xmlNode->getIntAttribute("Method", 1));
+            outputSelector->setSelectedId(xmlNode->getIntAttribute("Output", 1));
+
+            updateLatencyLabel();
+        }
+    }
+
+}
@@ -0,0 +1,86 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __BANDPOWEREDITOR_H_5C13E9A7__
+#define __BANDPOWEREDITOR_H_5C13E9A7__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "GenericEditor.h"
+
+/**
+
+  User interface for the BandPowerNode processor.
+
+  @see BandPowerNode
+
+*/
+
+class BandPowerEditor : public GenericEditor,
+    public Label::Listener,
+    public ComboBox::Listener
+{
+public:
+    BandPowerEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors);
+    virtual ~BandPowerEditor();
+
+    void labelTextChanged(Label* label);
+
+    void comboBoxChanged(ComboBox* comboBox);
+
+    void updateSettings();
+
+    void startAcquisition();
+    void stopAcquisition();
+
+    void saveEditorParameters(XmlElement* xml);
+    void loadEditorParameters(XmlElement* xml);
+
+private:
+
+    Label* createValue(const String& name, const String& label, const String& value, int x, int y);
+    ComboBox* createSelector(const String& name, const String& label, int x, int y);
+
+    void updateLatencyLabel();
+
+    String lastLowCutString;
+    String lastHighCutString;
+    String lastThresholdString;
+    String lastWindowString;
+
+    ScopedPointer<Label> lowCutValue;
+    ScopedPointer<Label> highCutValue;
+    ScopedPointer<Label> thresholdValue;
+    ScopedPointer<Label> windowValue;
+
+    ScopedPointer<ComboBox> methodSelector;
+    ScopedPointer<ComboBox> outputSelector;
+
+    ScopedPointer<Label> latencyLabel;
+
+    OwnedArray<Label> labels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BandPowerEditor);
+
+};
+
+#endif  // __BANDPOWEREDITOR_H_5C13E9A7__
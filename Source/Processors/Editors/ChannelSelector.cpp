@@ -29,23 +29,38 @@
 #include "../ProcessorGraph.h"
 
 ChannelSelector::ChannelSelector(bool createButtons, Font& titleFont_) :
-    eventsOnly(false), paramsToggled(true), paramsActive(true),
+    eventsOnly(false), numChannels(0), dragType(-1), dragAnchor(-1), dragValue(false),
+    lastClickedType(-1), lastClickedChannel(-1), paramsToggled(true), paramsActive(true),
     radioStatus(false), isNotSink(createButtons), moveRight(false),
     moveLeft(false), offsetLR(0), offsetUD(0), desiredOffset(0),
     titleFont(titleFont_), acquisitionIsActive(false)
 {
 
+    // the buttons are created when the selector is first shown
+    audioButton = recordButton = paramsButton = allButton = noneButton = nullptr;
+    channelSelectorRegion = nullptr;
+
+    // set button layout parameters
+    parameterOffset = 0;
+    recordOffset = getDesiredWidth();
+    audioOffset = getDesiredWidth()*2;
+
+}
+
+void ChannelSelector::createChildren()
+{
+
     // initialize buttons
     audioButton = new EditorButton("AUDIO", titleFont);
     audioButton->addListener(this);
     addAndMakeVisible(audioButton);
-    if (!createButtons)
+    if (!isNotSink)
         audioButton->setState(false);
 
     recordButton = new EditorButton("REC", titleFont);
     recordButton->addListener(this);
     addAndMakeVisible(recordButton);
-    if (!createButtons)
+    if (!isNotSink)
         recordButton->setState(false);
 
     paramsButton = new EditorButton("PARAM", titleFont);
@@ -54,16 +69,6 @@ ChannelSelector::ChannelSelector(bool createButtons, Font& titleFont_) :
 
     paramsButton->setToggleState(true, false);
 
-    audioButtons.clear();
-    recordButtons.clear();
-
-    // set button layout parameters
-    parameterOffset = 0;
-    recordOffset = getDesiredWidth();
-    audioOffset = getDesiredWidth()*2;
-
-    parameterButtons.clear();
-
     allButton = new EditorButton("all", titleFont);
     allButton->addListener(this);
     addAndMakeVisible(allButton);
@@ -78,6 +83,27 @@ ChannelSelector::ChannelSelector(bool createButtons, Font& titleFont_) :
 
 }
 
+void ChannelSelector::visibilityChanged()
+{
+
+    // the buttons and channels are only needed once the drawer is opened,
+    // which it never is for most editors
+    if (isVisible() && channelSelectorRegion == nullptr)
+    {
+        createChildren();
+        refreshButtonBoundaries();
+    }
+
+}
+
+void ChannelSelector::repaintChannels()
+{
+
+    if (channelSelectorRegion != nullptr)
+        channelSelectorRegion->repaint();
+
+}
+
 ChannelSelector::~ChannelSelector()
 {
     deleteAllChildren();
@@ -109,25 +135,28 @@ void ChannelSelector::paint(Graphics& g)
 void ChannelSelector::setNumChannels(int numChans)
 {
 
-    int difference = numChans - parameterButtons.size();
-
-    std::cout << difference << " buttons needed." << std::endl;
+    std::cout << numChans - numChannels << " channels added." << std::endl;
 
-    if (difference > 0)
+    if (numChans > numChannels)
     {
-        for (int n = 0; n < difference; n++)
-        {
-            addButton();
-        }
+        // new channels start out like the old buttons did
+        paramStates.setRange(numChannels, numChans - numChannels, paramsToggled && !radioStatus);
     }
-    else if (difference < 0)
+    else
     {
-        for (int n = 0; n < -difference; n++)
-        {
-            removeButton();
-        }
+        paramStates.setRange(numChans, numChannels - numChans, false);
+        recordStates.setRange(numChans, numChannels - numChans, false);
+        audioStates.setRange(numChans, numChannels - numChans, false);
     }
 
+    numChannels = numChans;
+
+    if (dragAnchor >= numChannels)
+        dragType = -1;
+
+    if (lastClickedChannel >= numChannels)
+        lastClickedChannel = -1;
+
     refreshButtonBoundaries();
 
 }
@@ -135,15 +164,13 @@ void ChannelSelector::setNumChannels(int numChans)
 void ChannelSelector::shiftChannelsVertical(float amount)
 {
 
-    if (parameterButtons.size() > 32)
+    if (numChannels > 32)
     {
         offsetUD -= amount*10;
         offsetUD = jmin(offsetUD, 0.0f);
-        offsetUD = jmax(offsetUD, float(parameterButtons.size())/8*-10.68f);
+        offsetUD = jmax(offsetUD, float(numChannels)/8*-10.68f);
     }
 
-    std::cout << "offsetUD = " << offsetUD << std::endl;
-
     refreshButtonBoundaries();
 
 }
@@ -151,34 +178,11 @@ void ChannelSelector::shiftChannelsVertical(float amount)
 void ChannelSelector::refreshButtonBoundaries()
 {
 
-    channelSelectorRegion->setBounds(0,20,getWidth(),getHeight()-35);
-
-    int nColumns = 8;
-    int columnWidth = getDesiredWidth()/(nColumns + 1);
-    int rowHeight = 14;
-
-    for (int i = 0; i < parameterButtons.size(); i++)
-    {
-
-        parameterButtons[i]->setBounds(columnWidth/2 + offsetLR +
-                                       columnWidth*((i)%nColumns),
-                                       floor(double(i)/nColumns)*rowHeight+(int) offsetUD,
-                                       columnWidth, rowHeight);
-
-        if (isNotSink)
-        {
-            recordButtons[i]->setBounds(columnWidth/2 + offsetLR +
-                                        columnWidth*((i)%nColumns) - getDesiredWidth(),
-                                        floor(double(i)/nColumns)*rowHeight+(int) offsetUD,
-                                        columnWidth, rowHeight);
-            audioButtons[i]->setBounds(columnWidth/2 + offsetLR +
-                                       columnWidth*((i)%nColumns) -
-                                       getDesiredWidth()*2,
-                                       floor(double(i)/nColumns)*rowHeight+(int) offsetUD,
-                                       columnWidth, rowHeight);
-        }
+    if (channelSelectorRegion == nullptr)
+        return;
 
-    }
+    channelSelectorRegion->setBounds(0,20,getWidth(),getHeight()-35);
+    channelSelectorRegion->repaint();
 
     int w = getWidth()/3;
     int h = 15;
@@ -225,57 +229,83 @@ void ChannelSelector::timerCallback()
 
 }
 
-void ChannelSelector::addButton()
+BigInteger& ChannelSelector::getStates(int type)
 {
+    if (type == RECORD)
+        return recordStates;
+    else if (type == AUDIO)
+        return audioStates;
+    else
+        return paramStates;
+}
 
-    int size = parameterButtons.size();
-
-    ChannelSelectorButton* b = new ChannelSelectorButton(size+1, PARAMETER, titleFont);
-    parameterButtons.add(b);
-    channelSelectorRegion->addAndMakeVisible(b);
+bool ChannelSelector::hasTab(int type)
+{
+    return type == PARAMETER || isNotSink;
+}
 
-    if (paramsToggled)
-        b->setToggleState(true, false);
+int ChannelSelector::getVisibleTab()
+{
+    if (offsetLR == parameterOffset)
+        return PARAMETER;
+    else if (offsetLR == recordOffset)
+        return RECORD;
+    else if (offsetLR == audioOffset)
+        return AUDIO;
     else
-        b->setToggleState(false, false);
+        return -1;
+}
 
-    if (!paramsActive)
-        b->setActive(false);
+int ChannelSelector::getTabOrigin(int type)
+{
+    const int columnWidth = getDesiredWidth()/(NUM_COLUMNS + 1);
 
-    b->addListener(this);
+    int offset = parameterOffset;
 
-    if (isNotSink)
-    {
-        ChannelSelectorButton* br = new ChannelSelectorButton(size+1, RECORD, titleFont);
-        recordButtons.add(br);
-        channelSelectorRegion->addAndMakeVisible(br);
-        br->addListener(this);
+    if (type == RECORD)
+        offset = recordOffset;
+    else if (type == AUDIO)
+        offset = audioOffset;
 
-        ChannelSelectorButton* ba = new ChannelSelectorButton(size+1, AUDIO, titleFont);
-        audioButtons.add(ba);
-        channelSelectorRegion->addAndMakeVisible(ba);
-        ba->addListener(this);
-    }
+    return columnWidth/2 + offsetLR - offset;
 }
 
-void ChannelSelector::removeButton()
+int ChannelSelector::getChannelAt(int type, int x, int y, bool clamp)
 {
-    int size = parameterButtons.size();
+    if (numChannels == 0)
+        return -1;
+
+    const int columnWidth = getDesiredWidth()/(NUM_COLUMNS + 1);
 
-    ChannelSelectorButton* b = parameterButtons.remove(size-1);
-    channelSelectorRegion->removeChildComponent(b);
-    deleteAndZero(b);
+    int column = (x - getTabOrigin(type));
+    int row = (y - (int) offsetUD);
 
-    if (isNotSink)
+    if (column < 0 || row < 0)
     {
-        ChannelSelectorButton* br = recordButtons.remove(size-1);
-        channelSelectorRegion->removeChildComponent(br);
-        deleteAndZero(br);
+        if (!clamp)
+            return -1;
 
-        ChannelSelectorButton* ba = audioButtons.remove(size-1);
-        channelSelectorRegion->removeChildComponent(ba);
-        deleteAndZero(ba);
+        column = jmax(column, 0);
+        row = jmax(row, 0);
     }
+
+    column /= columnWidth;
+    row /= ROW_HEIGHT;
+
+    if (column >= NUM_COLUMNS)
+    {
+        if (!clamp)
+            return -1;
+
+        column = NUM_COLUMNS - 1;
+    }
+
+    const int chan = row*NUM_COLUMNS + column;
+
+    if (chan >= numChannels)
+        return clamp ? numChannels - 1 : -1;
+
+    return chan;
 }
 
 Array<int> ChannelSelector::getActiveChannels()
@@ -284,10 +314,10 @@ Array<int> ChannelSelector::getActiveChannels()
 
     if (!eventsOnly)
     {
-        for (int i = 0; i < parameterButtons.size(); i++)
+        for (int i = paramStates.findNextSetBit(0); i >= 0 && i < numChannels;
+             i = paramStates.findNextSetBit(i + 1))
         {
-            if (parameterButtons[i]->getToggleState())
-                a.add(i);
+            a.add(i);
         }
     }
     else
@@ -303,15 +333,15 @@ void ChannelSelector::setActiveChannels(Array<int> a)
 
     std::cout << "Setting active channels!" << std::endl;
 
-    for (int i = 0; i < parameterButtons.size(); i++)
-    {
-        parameterButtons[i]->setToggleState(false,false);
-    }
+    paramStates.clear();
 
     for (int i = 0; i < a.size(); i++)
     {
-        parameterButtons[a[i]]->setToggleState(true,false);
+        if (a[i] >= 0 && a[i] < numChannels)
+            paramStates.setBit(a[i]);
     }
+
+    repaintChannels();
 }
 
 void ChannelSelector::inactivateButtons()
@@ -319,11 +349,7 @@ void ChannelSelector::inactivateButtons()
 
     paramsActive = false;
 
-    for (int i = 0; i < parameterButtons.size(); i++)
-    {
-        parameterButtons[i]->setActive(false);
-        parameterButtons[i]->repaint();
-    }
+    repaintChannels();
 }
 
 void ChannelSelector::activateButtons()
@@ -331,11 +357,7 @@ void ChannelSelector::activateButtons()
 
     paramsActive = true;
 
-    for (int i = 0; i < parameterButtons.size(); i++)
-    {
-        parameterButtons[i]->setActive(true);
-        parameterButtons[i]->repaint();
-    }
+    repaintChannels();
 
 }
 
@@ -357,19 +379,9 @@ void ChannelSelector::setRadioStatus(bool radioOn)
 
         radioStatus = radioOn;
 
-        for (int i = 0; i < parameterButtons.size(); i++)
-        {
-            if (radioOn)
-            {
-                parameterButtons[i]->setToggleState(false, false);
-                parameterButtons[i]->setRadioGroupId(999);
-            }
-            else
-            {
-                parameterButtons[i]->setToggleState(false, false);
-                parameterButtons[i]->setRadioGroupId(0);
-            }
-        }
+        paramStates.clear();
+
+        repaintChannels();
 
     }
 
@@ -380,8 +392,8 @@ void ChannelSelector::setRadioStatus(bool radioOn)
 bool ChannelSelector::getParamStatus(int chan)
 {
 
-    if (chan >= 0 && chan < parameterButtons.size())
-        return parameterButtons[chan]->getToggleState();
+    if (chan >= 0 && chan < numChannels)
+        return paramStates[chan];
     else
         return false;
 
@@ -390,8 +402,8 @@ bool ChannelSelector::getParamStatus(int chan)
 bool ChannelSelector::getRecordStatus(int chan)
 {
 
-    if (chan >= 0 && chan < recordButtons.size())
-        return recordButtons[chan]->getToggleState();
+    if (chan >= 0 && chan < numChannels && isNotSink)
+        return recordStates[chan];
     else
         return false;
 
@@ -400,8 +412,8 @@ bool ChannelSelector::getRecordStatus(int chan)
 bool ChannelSelector::getAudioStatus(int chan)
 {
 
-    if (chan >= 0 && chan < audioButtons.size())
-        return audioButtons[chan]->getToggleState();
+    if (chan >= 0 && chan < numChannels && isNotSink)
+        return audioStates[chan];
     else
         return false;
 
@@ -410,24 +422,43 @@ bool ChannelSelector::getAudioStatus(int chan)
 void ChannelSelector::setParamStatus(int chan, bool b)
 {
 
-    if (chan >= 0 && chan < parameterButtons.size())
-        parameterButtons[chan]->setToggleState(b, true);
+    if (chan >= 0 && chan < numChannels && paramStates[chan] != b)
+    {
+        BigInteger newStates(paramStates);
+
+        if (radioStatus && b)
+            newStates.clear();
+
+        newStates.setBit(chan, b);
+
+        applyStates(PARAMETER, newStates);
+    }
 
 }
 
 void ChannelSelector::setRecordStatus(int chan, bool b)
 {
 
-    if (chan >= 0 && chan < recordButtons.size())
-        recordButtons[chan]->setToggleState(b, true);
+    if (chan >= 0 && chan < numChannels && isNotSink && recordStates[chan] != b)
+    {
+        BigInteger newStates(recordStates);
+        newStates.setBit(chan, b);
+
+        applyStates(RECORD, newStates);
+    }
 
 }
 
 void ChannelSelector::setAudioStatus(int chan, bool b)
 {
 
-    if (chan >= 0 && chan < audioButtons.size())
-        audioButtons[chan]->setToggleState(b, true);
+    if (chan >= 0 && chan < numChannels && isNotSink && audioStates[chan] != b)
+    {
+        BigInteger newStates(audioStates);
+        newStates.setBit(chan, b);
+
+        applyStates(AUDIO, newStates);
+    }
 
 }
 
@@ -438,6 +469,256 @@ int ChannelSelector::getDesiredWidth()
     return 150;
 }
 
+void ChannelSelector::applyStates(int type, const BigInteger& newStates)
+{
+    BigInteger& states = getStates(type);
+
+    BigInteger changed(states);
+    changed ^= newStates;
+
+    for (int i = changed.findNextSetBit(0); i >= 0 && i < numChannels;
+         i = changed.findNextSetBit(i + 1))
+    {
+        states.setBit(i, newStates[i]);
+        channelStateChanged(type, i, newStates[i]);
+    }
+
+    repaintChannels();
+}
+
+void ChannelSelector::channelStateChanged(int type, int chan, bool status)
+{
+    GenericEditor* editor = (GenericEditor*) getParentComponent();
+
+    if (type == AUDIO)
+    {
+        // get audio node, and inform it of the change
+        Channel* ch = editor->getChannel(chan);
+
+        if (acquisitionIsActive) // use setParameter to change parameter safely
+        {
+            editor->getProcessorGraph()->
+            getAudioNode()->
+            setChannelStatus(ch, status);
+        }
+        else     // change parameter directly
+        {
+            ch->isMonitored = status;
+        }
+
+    }
+    else if (type == RECORD)
+    {
+        // get record node, and inform it of the change
+        Channel* ch = editor->getChannel(chan);
+
+        if (acquisitionIsActive) // use setParameter to change parameter safely
+        {
+            editor->getProcessorGraph()->
+            getRecordNode()->
+            setChannelStatus(ch, status);
+        }
+        else     // change parameter directly
+        {
+            ch->isRecording = status;
+        }
+
+    }
+    else
+    {
+        if (radioStatus && status) // if radio buttons are active
+        {
+            // send a message to parent
+            editor->channelChanged(chan + 1);
+        }
+    }
+}
+
+void ChannelSelector::channelClicked(int type, int chan, const ModifierKeys& mods)
+{
+    dragType = -1;
+
+    if (type == PARAMETER && !paramsActive)
+        return;
+
+    BigInteger& states = getStates(type);
+
+    if (type == PARAMETER && radioStatus)
+    {
+        if (!states[chan])
+        {
+            BigInteger newStates;
+            newStates.setBit(chan);
+
+            applyStates(PARAMETER, newStates);
+        }
+        else
+        {
+            // already selected, but let the editor know it was clicked again
+            GenericEditor* editor = (GenericEditor*) getParentComponent();
+            editor->channelChanged(chan + 1);
+        }
+
+        refreshParameterColors();
+        return;
+    }
+
+    dragType = type;
+    dragSnapshot = states;
+
+    if (mods.isShiftDown() && lastClickedType == type && lastClickedChannel >= 0)
+    {
+        // extend from the last channel clicked, to its state
+        dragAnchor = lastClickedChannel;
+        dragValue = states[lastClickedChannel];
+    }
+    else
+    {
+        dragAnchor = chan;
+        dragValue = !states[chan];
+    }
+
+    lastClickedType = type;
+    lastClickedChannel = chan;
+
+    channelDragged(chan);
+}
+
+void ChannelSelector::channelDragged(int chan)
+{
+    if (dragType < 0 || chan < 0)
+        return;
+
+    // everything between the anchor and here, over the states as they were
+    BigInteger newStates(dragSnapshot);
+
+    const int first = jmin(dragAnchor, chan);
+    const int last = jmax(dragAnchor, chan);
+
+    newStates.setRange(first, last - first + 1, dragValue);
+
+    applyStates(dragType, newStates);
+
+    if (dragType == PARAMETER)
+        refreshParameterColors();
+}
+
+void ChannelSelector::showSelectionMenu(int type)
+{
+    if (type == PARAMETER && (radioStatus || !paramsActive))
+        return;
+
+    // monitoring every channel at once isn't allowed, as with the "all" button
+    const bool canSelect = (type != AUDIO);
+
+    PopupMenu menu;
+    menu.addItem(1, "Select all", canSelect);
+    menu.addItem(2, "Select none");
+    menu.addItem(3, "Invert selection", canSelect);
+    menu.addSeparator();
+    menu.addItem(4, "Odd channels", canSelect);
+    menu.addItem(5, "Even channels", canSelect);
+    menu.addItem(6, "Select channels...", canSelect);
+
+    const int result = menu.show();
+
+    if (result == 0)
+        return;
+
+    BigInteger newStates;
+
+    if (result == 1)
+    {
+        newStates.setRange(0, numChannels, true);
+    }
+    else if (result == 3)
+    {
+        newStates.setRange(0, numChannels, true);
+        newStates ^= getStates(type);
+    }
+    else if (result == 4 || result == 5)
+    {
+        // numbered from 1, so the odd channels are at even indices
+        for (int i = (result == 4 ? 0 : 1); i < numChannels; i += 2)
+            newStates.setBit(i);
+    }
+    else if (result == 6)
+    {
+        AlertWindow window("Select channels",
+                           "Channel numbers, ranges, and ranges with a step, "
+                           "separated by commas:",
+                           AlertWindow::NoIcon);
+
+        window.addTextEditor("pattern", "1-" + String(numChannels));
+        window.addButton("OK", 1, KeyPress(KeyPress::returnKey));
+        window.addButton("Cancel", 0, KeyPress(KeyPress::escapeKey));
+
+        if (window.runModalLoop() == 0)
+            return;
+
+        if (!parseChannelPattern(window.getTextEditorContents("pattern"), numChannels, newStates))
+        {
+            AlertWindow::showMessageBox(AlertWindow::WarningIcon, "Select channels",
+                                        "Try something like \"1-16, 33, 40-64:4\".");
+            return;
+        }
+    }
+
+    applyStates(type, newStates);
+
+    if (type == PARAMETER)
+        refreshParameterColors();
+}
+
+bool ChannelSelector::parseChannelPattern(const String& pattern, int numChannels, BigInteger& channels)
+{
+    StringArray items;
+    items.addTokens(pattern, ", ", String::empty);
+    items.removeEmptyStrings();
+
+    BigInteger result;
+
+    for (int n = 0; n < items.size(); n++)
+    {
+        const String item = items[n];
+
+        String range = item.upToFirstOccurrenceOf(":", false, false);
+        int step = 1;
+
+        if (item.containsChar(':'))
+        {
+            const String stepText = item.fromFirstOccurrenceOf(":", false, false);
+
+            if (!stepText.containsOnly("0123456789") || stepText.isEmpty())
+                return false;
+
+            step = stepText.getIntValue();
+        }
+
+        const String firstText = range.upToFirstOccurrenceOf("-", false, false);
+        const String lastText = range.containsChar('-') ? range.fromFirstOccurrenceOf("-", false, false)
+                                : firstText;
+
+        if (firstText.isEmpty() || lastText.isEmpty() || step < 1
+            || !firstText.containsOnly("0123456789") || !lastText.containsOnly("0123456789"))
+            return false;
+
+        // numbered from 1
+        const int first = firstText.getIntValue() - 1;
+        const int last = jmin(lastText.getIntValue(), numChannels) - 1;
+
+        if (first < 0)
+            return false;
+
+        for (int i = first; i <= last; i += step)
+            result.setBit(i);
+    }
+
+    channels = result;
+
+    return true;
+}
+
 void ChannelSelector::buttonClicked(Button* button)
 {
     //checkChannelSelectors();
@@ -484,54 +765,24 @@ void ChannelSelector::buttonClicked(Button* button)
     else if (button == allButton)
     {
         // select all active buttons
-        if (offsetLR == recordOffset)
-        {
-
+        const int tab = getVisibleTab();
 
-            for (int i = 0; i < recordButtons.size(); i++)
-            {
-                recordButtons[i]->setToggleState(true, true);
-            }
-
-        }
-        else if (offsetLR == parameterOffset)
+        if (tab == RECORD || (tab == PARAMETER && !radioStatus))
         {
+            BigInteger newStates;
+            newStates.setRange(0, numChannels, true);
 
-
-            for (int i = 0; i < parameterButtons.size(); i++)
-            {
-                parameterButtons[i]->setToggleState(true, true);
-            }
-        }
-        else if (offsetLR == audioOffset)
-        {
-            // do nothing--> button is disabled
+            applyStates(tab, newStates);
         }
+        // audio: do nothing--> button is disabled
     }
     else if (button == noneButton)
     {
         // deselect all active buttons
-        if (offsetLR == recordOffset)
-        {
-            for (int i = 0; i < recordButtons.size(); i++)
-            {
-                recordButtons[i]->setToggleState(false, true);
-            }
-        }
-        else if (offsetLR == parameterOffset)
-        {
-            for (int i = 0; i < parameterButtons.size(); i++)
-            {
-                parameterButtons[i]->setToggleState(false, true);
-            }
-        }
-        else if (offsetLR == audioOffset)
-        {
-            for (int i = 0; i < audioButtons.size(); i++)
-            {
-                audioButtons[i]->setToggleState(false, true);
-            }
-        }
+        const int tab = getVisibleTab();
+
+        if (tab >= 0)
+            applyStates(tab, BigInteger());
 
         if (radioStatus) // if radio buttons are active
         {
@@ -540,66 +791,7 @@ void ChannelSelector::buttonClicked(Button* button)
             editor->channelChanged(-1);
         }
     }
-    else
-    {
-
-        ChannelSelectorButton* b = (ChannelSelectorButton*) button;
-
-        if (b->getType() == AUDIO)
-        {
-            // get audio node, and inform it of the change
-            GenericEditor* editor = (GenericEditor*) getParentComponent();
-
-            Channel* ch = editor->getChannel(b->getChannel()-1);
-            //int channelNum = editor->getStartChannel() + b->getChannel() - 1;
-            bool status = b->getToggleState();
-
-            if (acquisitionIsActive) // use setParameter to change parameter safely
-            {
-                editor->getProcessorGraph()->
-                getAudioNode()->
-                setChannelStatus(ch, status);
-            }
-            else     // change parameter directly
-            {
-                ch->isMonitored = status;
-            }
-
 
-        }
-        else if (b->getType() == RECORD)
-        {
-            // get record node, and inform it of the change
-            GenericEditor* editor = (GenericEditor*) getParentComponent();
-
-            Channel* ch = editor->getChannel(b->getChannel()-1);
-            //int channelNum = editor->getStartChannel() + b->getChannel() - 1;
-            bool status = b->getToggleState();
-
-            if (acquisitionIsActive) // use setParameter to change parameter safely
-            {
-                editor->getProcessorGraph()->
-                getRecordNode()->
-                setChannelStatus(ch, status);
-            }
-            else     // change parameter directly
-            {
-                ch->isRecording = status;
-            }
-
-        }
-        else
-        {
-            // do nothing
-            if (radioStatus) // if radio buttons are active
-            {
-                // send a message to parent
-                GenericEditor* editor = (GenericEditor*) getParentComponent();
-                editor->channelChanged(b->getChannel());
-            }
-        }
-
-    }
     refreshParameterColors();
 }
 
@@ -766,75 +958,170 @@ void EditorButton::paintButton(Graphics& g, bool isMouseOver, bool isButtonDown)
 }
 
 
-ChannelSelectorButton::ChannelSelectorButton(int num_, int type_, Font& f) : Button("name")
+ChannelSelectorRegion::ChannelSelectorRegion(ChannelSelector* cs)
+    : channelSelector(cs), hoverType(-1), hoverChannel(-1)
 {
-    isActive = true;
-    num = num_;
-    type = type_;
-
-    setClickingTogglesState(true);
+    channelFont = cs->titleFont;
+    channelFont.setHeight(10);
+}
 
-    buttonFont = f;
-    buttonFont.setHeight(10);
+ChannelSelectorRegion::~ChannelSelectorRegion()
+{
+    deleteAllChildren();
 }
 
+void ChannelSelectorRegion::mouseWheelMove(const MouseEvent& event,
+                                           const MouseWheelDetails& wheel)
+{
+
+    channelSelector->shiftChannelsVertical(wheel.deltaY);
+}
 
-void ChannelSelectorButton::paintButton(Graphics& g, bool isMouseOver, bool isButtonDown)
+bool ChannelSelectorRegion::hitTestChannel(int x, int y, int& type, int& chan)
 {
-    if (isActive)
-    {
-        if (getToggleState() == true)
-            g.setColour(Colours::orange);
-        else
-            g.setColour(Colours::darkgrey);
+    const int types[3] = { ChannelSelector::PARAMETER, ChannelSelector::RECORD, ChannelSelector::AUDIO };
 
-        if (isMouseOver)
-            g.setColour(Colours::white);
-    }
-    else
+    for (int t = 0; t < 3; t++)
     {
-        if (getToggleState() == true)
-            g.setColour(Colours::yellow);
-        else
-            g.setColour(Colours::lightgrey);
+        if (!channelSelector->hasTab(types[t]))
+            continue;
+
+        chan = channelSelector->getChannelAt(types[t], x, y, false);
+
+        if (chan >= 0)
+        {
+            type = types[t];
+            return true;
+        }
     }
 
-    // g.fillRect(0,0,getWidth(),getHeight());
+    return false;
+}
 
-    g.setFont(buttonFont);
+void ChannelSelectorRegion::mouseMove(const MouseEvent& event)
+{
+    int type = -1;
+    int chan = -1;
 
-    // g.drawRect(0,0,getWidth(),getHeight(),1.0);
+    if (!hitTestChannel(event.x, event.y, type, chan))
+    {
+        type = -1;
+        chan = -1;
+    }
 
-    g.drawText(String(num),0,0,getWidth(),getHeight(),Justification::centred,true);
+    if (type != hoverType || chan != hoverChannel)
+    {
+        hoverType = type;
+        hoverChannel = chan;
+        repaint();
+    }
 }
 
-void ChannelSelectorButton::setActive(bool t)
+void ChannelSelectorRegion::mouseExit(const MouseEvent& event)
 {
-    isActive = t;
-    setClickingTogglesState(t);
+    hoverType = -1;
+    hoverChannel = -1;
+    repaint();
 }
 
-ChannelSelectorRegion::ChannelSelectorRegion(ChannelSelector* cs)
+void ChannelSelectorRegion::mouseDown(const MouseEvent& event)
 {
-    channelSelector = cs;
+    int type, chan;
+
+    if (event.mods.isPopupMenu())
+    {
+        const int tab = channelSelector->getVisibleTab();
+
+        if (tab >= 0 && channelSelector->hasTab(tab))
+            channelSelector->showSelectionMenu(tab);
 
-    addMouseListener((MouseListener*) this, true);
+        return;
+    }
+
+    if (hitTestChannel(event.x, event.y, type, chan))
+        channelSelector->channelClicked(type, chan, event.mods);
 }
 
-ChannelSelectorRegion::~ChannelSelectorRegion()
+void ChannelSelectorRegion::mouseDrag(const MouseEvent& event)
 {
-    deleteAllChildren();
+    if (channelSelector->dragType < 0)
+        return;
+
+    const int chan = channelSelector->getChannelAt(channelSelector->dragType,
+                                                   event.x, event.y, true);
+
+    channelSelector->channelDragged(chan);
+
+    hoverType = channelSelector->dragType;
+    hoverChannel = chan;
 }
 
-void ChannelSelectorRegion::mouseWheelMove(const MouseEvent& event,
-                                           const MouseWheelDetails& wheel)
+void ChannelSelectorRegion::mouseUp(const MouseEvent& event)
 {
-
-    std::cout << "Got wheel move: " << wheel.deltaY << std::endl;
-    channelSelector->shiftChannelsVertical(wheel.deltaY);
+    channelSelector->dragType = -1;
 }
 
 void ChannelSelectorRegion::paint(Graphics& g)
 {
-    // g.fillAll(Colours::white);
-}
\ No newline at end of file
+    const int numChannels = channelSelector->numChannels;
+
+    if (numChannels == 0)
+        return;
+
+    const int columnWidth = channelSelector->getDesiredWidth()/(ChannelSelector::NUM_COLUMNS + 1);
+    const int rowHeight = ChannelSelector::ROW_HEIGHT;
+    const int numColumns = ChannelSelector::NUM_COLUMNS;
+    const int offsetUD = (int) channelSelector->offsetUD;
+
+    // only the rows that can be seen
+    const int firstRow = jmax(0, -offsetUD / rowHeight);
+    const int lastRow = jmin((numChannels - 1) / numColumns, (getHeight() - offsetUD) / rowHeight);
+
+    g.setFont(channelFont);
+
+    const int types[3] = { ChannelSelector::PARAMETER, ChannelSelector::RECORD, ChannelSelector::AUDIO };
+
+    for (int t = 0; t < 3; t++)
+    {
+        const int type = types[t];
+        const int origin = channelSelector->getTabOrigin(type);
+
+        if (!channelSelector->hasTab(type) || origin >= getWidth() ||
+            origin + numColumns * columnWidth <= 0)
+            continue;
+
+        const BigInteger& states = channelSelector->getStates(type);
+        const bool isActive = (type != ChannelSelector::PARAMETER) || channelSelector->paramsActive;
+
+        for (int row = firstRow; row <= lastRow; row++)
+        {
+            for (int column = 0; column < numColumns; column++)
+            {
+                const int chan = row * numColumns + column;
+
+                if (chan >= numChannels)
+                    break;
+
+                if (isActive)
+                {
+                    if (type == hoverType && chan == hoverChannel)
+                        g.setColour(Colours::white);
+                    else if (states[chan])
+                        g.setColour(Colours::orange);
+                    else
+                        g.setColour(Colours::darkgrey);
+                }
+                else
+                {
+                    if (states[chan])
+                        g.setColour(Colours::yellow);
+                    else
+                        g.setColour(Colours::lightgrey);
+                }
+
+                g.drawText(String(chan + 1), origin + column * columnWidth, row * rowHeight + offsetUD,
+                           columnWidth, rowHeight, Justification::centred, true);
+            }
+        }
+    }
+}
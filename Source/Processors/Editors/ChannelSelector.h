@@ -33,7 +33,6 @@
 #include <stdio.h>
 
 class ChannelSelectorRegion;
-class ChannelSelectorButton;
 class EditorButton;
 
 /**
@@ -43,6 +42,16 @@ class EditorButton;
   Contains tabs for "Params", "Audio", and "Record", which allow
   channels to be selected for different purposes.
 
+  The channels aren't components: each tab's states are kept in a bitset,
+  and a single ChannelSelectorRegion paints the visible ones and works out
+  which channel was clicked, so that a source with a thousand channels costs
+  no more to lay out than one with eight. Dragging across channels (or
+  shift-clicking) sets a whole range, and right-clicking offers odd, even,
+  inverted and typed-in selections such as "1-16, 33, 40-64:4".
+
+  The tab buttons and the ChannelSelectorRegion are only created the first
+  time the selector is shown, when the editor's drawer is opened.
+
   @see GenericEditor
 
 */
@@ -76,7 +85,7 @@ public:
     /** get the total number of channels. */
     int getNumChannels()
     {
-        return parameterButtons.size();
+        return numChannels;
     }
 
     /** Return whether a particular channel should be recording. */
@@ -106,10 +115,10 @@ public:
     /** Called immediately after data acquisition ends.*/
     void stopAcquisition();
 
-    /** Inactivates all the ChannelSelectorButtons under the "param" tab.*/
+    /** Stops the channels under the "param" tab from being clicked.*/
     void inactivateButtons();
 
-    /** Activates all the ChannelSelectorButtons under the "param" tab.*/
+    /** Lets the channels under the "param" tab be clicked again.*/
     void activateButtons();
 
     /** Refreshes Parameter Colors on change*/
@@ -119,11 +128,16 @@ public:
         p->updateParameterButtons(-1);
     }
 
-    /** Controls the behavior of ChannelSelectorButtons; they can either behave
+    /** Controls the behavior of the "param" channels; they can either behave
     like radio buttons (only one selected at a time) or like toggle buttons (an
     arbitrary number can be selected at once).*/
     void setRadioStatus(bool);
 
+    /** Selects the channels described by a pattern of 1-based channel numbers,
+    ranges and strided ranges, separated by commas: "1-16, 33, 40-64:4".
+    Returns false, without changing anything, if the pattern can't be read.*/
+    static bool parseChannelPattern(const String& pattern, int numChannels, BigInteger& channels);
+
     void paramButtonsToggledByDefault(bool t)
     {
         paramsToggled = t;
@@ -137,23 +151,60 @@ public:
 
 private:
 
+    friend class ChannelSelectorRegion;
+
     EditorButton* audioButton;
     EditorButton* recordButton;
     EditorButton* paramsButton;
     EditorButton* allButton;
     EditorButton* noneButton;
 
-    /** An array of ChannelSelectorButtons used to select the channels that
-       will be updated when a parameter is changed. */
-    Array<ChannelSelectorButton*> parameterButtons;
+    int numChannels;
+
+    /** The channels that will be updated when a parameter is changed. */
+    BigInteger paramStates;
+
+    /** The channels that will be written to disk when the record button is pressed. */
+    BigInteger recordStates;
+
+    /** The channels that are sent to the audio monitor. */
+    BigInteger audioStates;
+
+    BigInteger& getStates(int type);
+
+    /** Whether a tab exists; sinks have no record or audio tabs. */
+    bool hasTab(int type);
+
+    /** Which tab is showing, or -1 while they slide. */
+    int getVisibleTab();
+
+    /** x position of a tab's first column, as it slides. */
+    int getTabOrigin(int type);
 
-    /** An array of ChannelSelectorButtons used to select the channels that
-       are sent to the audio monitor. */
-    Array<ChannelSelectorButton*> audioButtons;
+    /** Returns the channel at (x, y) in the region within a tab, or -1.
+    With clamp, points beyond the grid give the nearest channel. */
+    int getChannelAt(int type, int x, int y, bool clamp);
 
-    /** An array of ChannelSelectorButtons used to select the channels that
-       will be written to disk when the record button is pressed. */
-    Array<ChannelSelectorButton*> recordButtons;
+    void channelClicked(int type, int chan, const ModifierKeys& mods);
+    void channelDragged(int chan);
+    void showSelectionMenu(int type);
+
+    /** Changes a tab's states to newStates, informing whoever needs to know
+    of each channel that actually changes. */
+    void applyStates(int type, const BigInteger& newStates);
+
+    /** Passes on a change to one channel: to the record or audio node, or
+    to the editor when the "param" channels behave as radio buttons. */
+    void channelStateChanged(int type, int chan, bool status);
+
+    // drag selection
+    int dragType;
+    int dragAnchor;
+    bool dragValue;
+    BigInteger dragSnapshot;
+
+    int lastClickedType;
+    int lastClickedChannel;
 
     bool paramsToggled;
     bool paramsActive;
@@ -174,10 +225,15 @@ private:
 
     void resized();
 
-    void addButton();
-    void removeButton();
     void refreshButtonBoundaries();
 
+    /** Creates the tab buttons and the channels, the first time they're shown. */
+    void visibilityChanged();
+    void createChildren();
+
+    /** Repaints the channels, if they've been created. */
+    void repaintChannels();
+
     /** Controls the speed of animations. */
     void timerCallback();
 
@@ -188,6 +244,12 @@ private:
 
     enum {AUDIO, RECORD, PARAMETER};
 
+    enum
+    {
+        NUM_COLUMNS = 8,
+        ROW_HEIGHT = 14
+    };
+
     bool acquisitionIsActive;
 
     ChannelSelectorRegion* channelSelectorRegion;
@@ -247,7 +309,8 @@ private:
 
 /**
 
-  Holds the ChannelSelector buttons.
+  Draws the channels of every ChannelSelector tab, and turns mouse
+  events into the channels they land on.
 
   @see ChannelSelector
 
@@ -262,47 +325,26 @@ public:
 
     /** Allows the user to scroll the channels if they are not all visible.*/
     void mouseWheelMove(const MouseEvent& event, const MouseWheelDetails& wheel);
-    void paint(Graphics& g);
 
-private:
-    ChannelSelector* channelSelector;
+    void mouseMove(const MouseEvent& event);
+    void mouseExit(const MouseEvent& event);
+    void mouseDown(const MouseEvent& event);
+    void mouseDrag(const MouseEvent& event);
+    void mouseUp(const MouseEvent& event);
 
-};
-
-/**
-
-  A button within the ChannelSelector representing an individual channel.
-
-  @see ChannelSelector
-
-*/
+    void paint(Graphics& g);
 
-class ChannelSelectorButton : public Button
-{
-public:
-    ChannelSelectorButton(int num, int type, Font& f);
-    ~ChannelSelectorButton() {}
+private:
+    /** Finds the tab and channel under a point; returns false if there's none. */
+    bool hitTestChannel(int x, int y, int& type, int& chan);
 
-    int getType()
-    {
-        return type;
-    }
-    int getChannel()
-    {
-        return num;
-    }
-    //Channel* getChannel() {return ch;}
-    void setActive(bool t);
+    ChannelSelector* channelSelector;
 
-private:
-    void paintButton(Graphics& g, bool isMouseOver, bool isButtonDown);
+    Font channelFont;
 
-    //Channel* ch;
+    int hoverType;
+    int hoverChannel;
 
-    int type;
-    int num;
-    Font buttonFont;
-    bool isActive;
 };
 
 
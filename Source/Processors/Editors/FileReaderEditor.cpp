@@ -24,6 +24,7 @@
 #include "FileReaderEditor.h"
 
 #include "../FileReader.h"
+#include "../../UI/EditorViewport.h"
 
 #include <stdio.h>
 
@@ -38,13 +39,31 @@ FileReaderEditor::FileReaderEditor(GenericProcessor* parentNode, bool useDefault
 
     fileButton = new UtilityButton("Select file",Font("Small Text", 13, Font::plain));
     fileButton->addListener(this);
-    fileButton->setBounds(30,50,120,25);
+    fileButton->setBounds(30,30,120,22);
     addAndMakeVisible(fileButton);
 
     fileNameLabel = new Label("FileNameLabel", "No file selected.");
-    fileNameLabel->setBounds(20,80,140,25);
+    fileNameLabel->setBounds(20,55,140,22);
     addAndMakeVisible(fileNameLabel);
 
+    // the faster speeds are added by updateSpeedSelector() once there's a file
+    speedSelector = new ComboBox("Playback speed");
+    speedSelector->addItem("x1", 1);
+    speedSelector->setSelectedId(1, true);
+    speedSelector->setTooltip("Playback speed, as a multiple of real time. Only speeds up to the audio device's sample rate divided by the file's are offered");
+    speedSelector->setBounds(15,85,55,20);
+    speedSelector->addListener(this);
+    addAndMakeVisible(speedSelector);
+
+    positionSlider = new PlaybackPositionSlider(fileReader);
+    positionSlider->setSliderStyle(Slider::LinearBar);
+    positionSlider->setRange(0.0, 100.0, 0.1);
+    positionSlider->setTextValueSuffix(" %");
+    positionSlider->setTooltip("Position in the file; drag to jump");
+    positionSlider->setBounds(75,85,90,20);
+    positionSlider->addListener(this);
+    addAndMakeVisible(positionSlider);
+
     desiredWidth = 180;
 
     setEnabledState(false);
@@ -64,11 +83,51 @@ void FileReaderEditor::setFile(String file)
     fileReader->setFile(fileToRead.getFullPathName());
     fileNameLabel->setText(fileToRead.getFileName(), dontSendNotification);
 
+    positionSlider->setValue(0.0, dontSendNotification);
+
+    updateSpeedSelector();
+
     setEnabledState(true);
 
+    // the channel count and sample rate come from the file
+    getEditorViewport()->makeEditorVisible(this, false, true);
+
     repaint();
 }
 
+void FileReaderEditor::updateSpeedSelector()
+{
+
+    const float maxSpeed = fileReader->getMaxPlaybackSpeed();
+    const int selectedSpeed = speedSelector->getSelectedId();
+
+    // item IDs are the speeds; x1 is always offered, and plays as fast as
+    // possible when even real time is out of reach
+    speedSelector->clear(true);
+
+    for (int speed = 1; speed <= 16; speed *= 2)
+    {
+        if (speed == 1 || speed <= maxSpeed)
+            speedSelector->addItem("x" + String(speed), speed);
+    }
+
+    const int newSpeed = (selectedSpeed <= maxSpeed) ? jmax(1, selectedSpeed) : 1;
+
+    // only tell the File Reader if its speed has to drop
+    speedSelector->setSelectedId(newSpeed, newSpeed == selectedSpeed);
+
+}
+
+void FileReaderEditor::startAcquisition()
+{
+
+    GenericEditor::startAcquisition();
+
+    // the device rate is only certain once the graph is running
+    updateSpeedSelector();
+
+}
+
 void FileReaderEditor::buttonEvent(Button* button)
 {
 
@@ -98,6 +157,26 @@ void FileReaderEditor::buttonEvent(Button* button)
     }
 }
 
+void FileReaderEditor::sliderEvent(Slider* slider)
+{
+
+    if (slider == positionSlider)
+    {
+        fileReader->setParameter(1, float(slider->getValue() / 100.0));
+    }
+
+}
+
+void FileReaderEditor::comboBoxChanged(ComboBox* c)
+{
+
+    if (c == speedSelector)
+    {
+        fileReader->setParameter(0, float(c->getSelectedId()));
+    }
+
+}
+
 void FileReaderEditor::saveEditorParameters(XmlElement* xml)
 {
 
@@ -120,4 +199,19 @@ void FileReaderEditor::loadEditorParameters(XmlElement* xml)
     //       }
     //   }
 
+}
+
+PlaybackPositionSlider::PlaybackPositionSlider(FileReader* p)
+    : Slider("Position"), processor(p)
+{
+    startTimer(200);
+}
+
+void PlaybackPositionSlider::timerCallback()
+{
+    // leave the slider where it is while it's being dragged
+    if (!isShowing() || isMouseButtonDown())
+        return;
+
+    setValue(processor->getPlaybackPosition() * 100.0, dontSendNotification);
 }
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "GenericEditor.h"
 
 class FileReader;
+class PlaybackPositionSlider;
 
 
 /**
@@ -39,7 +40,8 @@ class FileReader;
 
 */
 
-class FileReaderEditor : public GenericEditor
+class FileReaderEditor : public GenericEditor,
+    public ComboBox::Listener
 
 {
 public:
@@ -48,17 +50,29 @@ public:
 
     void buttonEvent(Button* button);
 
+    void sliderEvent(Slider* slider);
+
+    void comboBoxChanged(ComboBox* c);
+
     void setFile(String file);
 
     void saveEditorParameters(XmlElement*);
 
     void loadEditorParameters(XmlElement*);
 
+    void startAcquisition();
+
 private:
 
+    /** Offers only the speeds the File Reader can reach with the current file and device.*/
+    void updateSpeedSelector();
+
     ScopedPointer<UtilityButton> fileButton;
     ScopedPointer<Label> fileNameLabel;
 
+    ScopedPointer<ComboBox> speedSelector;
+    ScopedPointer<PlaybackPositionSlider> positionSlider;
+
     FileReader* fileReader;
 
     File lastFilePath;
@@ -67,6 +81,28 @@ private:
 
 };
 
+/**
+
+  Follows the playback position while the file plays, and seeks
+  when it's dragged.
+
+  @see FileReaderEditor
+
+*/
+
+class PlaybackPositionSlider : public Slider,
+    public Timer
+{
+public:
+    PlaybackPositionSlider(FileReader* p);
+    ~PlaybackPositionSlider() {}
+
+private:
+    void timerCallback();
+
+    FileReader* processor;
+};
+
 
 
 #endif  // __FILEREADEREDITOR_H_D6EC8B48__
@@ -30,10 +30,11 @@ FilterEditor::FilterEditor(GenericProcessor* parentNode, bool useDefaultParamete
     : GenericEditor(parentNode, useDefaultParameterEditors)
 
 {
-    desiredWidth = 150;
+    desiredWidth = 270;
 
     lastHighCutString = "6000";
     lastLowCutString = "600";
+    lastTapsString = "255";
 
     highCutLabel = new Label("high cut label", "High cut:");
     highCutLabel->setBounds(35,80,180,20);
@@ -65,6 +66,54 @@ FilterEditor::FilterEditor(GenericProcessor* parentNode, bool useDefaultParamete
     highCutValue->addListener(this);
     addAndMakeVisible(highCutValue);
 
+    typeLabel = new Label("type label", "Type:");
+    typeLabel->setBounds(105,30,180,20);
+    typeLabel->setFont(Font("Small Text", 12, Font::plain));
+    typeLabel->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(typeLabel);
+
+    typeSelector = new ComboBox("filter type");
+    typeSelector->setBounds(110,50,70,20);
+    typeSelector->addItem("IIR", 1);
+    typeSelector->addItem("FIR", 2);
+    typeSelector->addItem("Zero-phase", 3);
+    typeSelector->setSelectedId(1, true);
+    typeSelector->addListener(this);
+    addAndMakeVisible(typeSelector);
+
+    tapsLabel = new Label("taps label", "FIR taps:");
+    tapsLabel->setBounds(105,80,180,20);
+    tapsLabel->setFont(Font("Small Text", 12, Font::plain));
+    tapsLabel->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(tapsLabel);
+
+    tapsValue = new Label("taps value", lastTapsString);
+    tapsValue->setBounds(110,100,60,20);
+    tapsValue->setFont(Font("Default", 15, Font::plain));
+    tapsValue->setColour(Label::textColourId, Colours::white);
+    tapsValue->setColour(Label::backgroundColourId, Colours::grey);
+    tapsValue->setEditable(true);
+    tapsValue->addListener(this);
+    addAndMakeVisible(tapsValue);
+
+    precisionLabel = new Label("precision label", "Precision:");
+    precisionLabel->setBounds(185,30,180,20);
+    precisionLabel->setFont(Font("Small Text", 12, Font::plain));
+    precisionLabel->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(precisionLabel);
+
+    precisionSelector = new ComboBox("precision");
+    precisionSelector->setBounds(190,50,65,20);
+    precisionSelector->addItem("Double", 1);
+    precisionSelector->addItem("Single", 2);
+    precisionSelector->setSelectedId(1, true);
+    precisionSelector->setTooltip("Arithmetic precision of the IIR filter. Single precision "
+                                  "filters four channels at a time.");
+    precisionSelector->addListener(this);
+    addAndMakeVisible(precisionSelector);
+
+    updateDelayTooltip();
+
 }
 
 FilterEditor::~FilterEditor()
@@ -80,6 +129,26 @@ void FilterEditor::labelTextChanged(Label* label)
     Value val = label->getTextValue();
     double requestedValue = double(val.getValue());
 
+    if (label == tapsValue)
+    {
+        if (requestedValue < 3 || requestedValue > 8191)
+        {
+            sendActionMessage("Number of taps out of range (3-8191).");
+            label->setText(lastTapsString, dontSendNotification);
+            return;
+        }
+
+        fn->setParameter(3, requestedValue);
+
+        // the filter rounds up to an odd length
+        lastTapsString = String(fn->getNumFirTaps());
+        label->setText(lastTapsString, dontSendNotification);
+
+        updateDelayTooltip();
+
+        return;
+    }
+
     if (requestedValue < 0.01 || requestedValue > 10000)
     {
         sendActionMessage("Value out of range.");
@@ -106,11 +175,11 @@ void FilterEditor::labelTextChanged(Label* label)
 
         if (label == highCutValue)
         {
-            double minVal = fn->getLowCutValueForChannel(n);
+            double minVal = fn->getLowCutValueForChannel(chans[n]);
 
             if (requestedValue > minVal)
             {
-                fn->setCurrentChannel(n);
+                fn->setCurrentChannel(chans[n]);
                 fn->setParameter(1, requestedValue);
             }
 
@@ -119,11 +188,11 @@ void FilterEditor::labelTextChanged(Label* label)
         }
         else
         {
-            double maxVal = fn->getHighCutValueForChannel(n);
+            double maxVal = fn->getHighCutValueForChannel(chans[n]);
 
             if (requestedValue < maxVal)
             {
-                fn->setCurrentChannel(n);
+                fn->setCurrentChannel(chans[n]);
                 fn->setParameter(0, requestedValue);
             }
 
@@ -132,6 +201,77 @@ void FilterEditor::labelTextChanged(Label* label)
 
     }
 
+    // the zero-phase delay follows the lowest low cut
+    updateDelayTooltip();
+
+}
+
+void FilterEditor::comboBoxChanged(ComboBox* comboBox)
+{
+    if (comboBox == typeSelector)
+    {
+        FilterNode* fn = (FilterNode*) getProcessor();
+
+        fn->setParameter(2, float(comboBox->getSelectedId() - 1));
+
+        updateDelayTooltip();
+    }
+    else if (comboBox == precisionSelector)
+    {
+        FilterNode* fn = (FilterNode*) getProcessor();
+
+        fn->setParameter(4, float(comboBox->getSelectedId() - 1));
+    }
+}
+
+void FilterEditor::updateDelayTooltip()
+{
+    FilterNode* fn = (FilterNode*) getProcessor();
+
+    String description;
+
+    switch (fn->getFilterType())
+    {
+        case FilterNode::FIR_FILTER:
+            description = "Linear-phase FIR.";
+            break;
+        case FilterNode::ZERO_PHASE_FILTER:
+            description = "Butterworth run forward and backward, a few time constants of the low cut at a time.";
+            break;
+        default:
+            description = "2nd-order Butterworth.";
+            break;
+    }
+
+    if (fn->getGroupDelay() > 0)
+    {
+        const float delayMs = 1000.0f * fn->getGroupDelay() / fn->getSampleRate();
+
+        description << " Output delay: " << String(fn->getGroupDelay()) << " samples ("
+                    << String(delayMs, 1) << " ms), subtracted from timestamps.";
+    }
+
+    typeSelector->setTooltip(description);
+    tapsValue->setTooltip(fn->getFilterType() == FilterNode::FIR_FILTER ? description : String::empty);
+}
+
+void FilterEditor::startAcquisition()
+{
+    GenericEditor::startAcquisition();
+
+    // changing the filter type or length reallocates every channel's state
+    typeSelector->setEnabled(false);
+    tapsValue->setEditable(false);
+    precisionSelector->setEnabled(false);
+}
+
+void FilterEditor::stopAcquisition()
+{
+    GenericEditor::stopAcquisition();
+
+    typeSelector->setEnabled(true);
+    tapsValue->setEditable(true);
+    precisionSelector->setEnabled(true);
 }
 
 void FilterEditor::buttonEvent(Button* button)
@@ -174,6 +314,9 @@ void FilterEditor::saveEditorParameters(XmlElement* xml)
     XmlElement* textLabelValues = xml->createNewChildElement("VALUES");
     textLabelValues->setAttribute("HighCut",lastHighCutString);
     textLabelValues->setAttribute("LowCut",lastLowCutString);
+    textLabelValues->setAttribute("Type",typeSelector->getSelectedId());
+    textLabelValues->setAttribute("Taps",lastTapsString);
+    textLabelValues->setAttribute("Precision",precisionSelector->getSelectedId());
 }
 
 void FilterEditor::loadEditorParameters(XmlElement* xml)
@@ -185,6 +328,10 @@ void FilterEditor::loadEditorParameters(XmlElement* xml)
         {
             highCutValue->setText(xmlNode->getStringAttribute("HighCut"),dontSendNotification);
             lowCutValue->setText(xmlNode->getStringAttribute("LowCut"),dontSendNotification);
+
+            tapsValue->setText(xmlNode->getStringAttribute("Taps", lastTapsString), sendNotificationSync);
+            typeSelector->setSelectedId(xmlNode->getIntAttribute("Type", 1));
+            precisionSelector->setSelectedId(xmlNode->getIntAttribute("Precision", 1));
         }
     }
 }
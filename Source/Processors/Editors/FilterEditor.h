@@ -39,7 +39,8 @@ class FilterViewport;
 */
 
 class FilterEditor : public GenericEditor,
-    public Label::Listener
+    public Label::Listener,
+    public ComboBox::Listener
 {
 public:
     FilterEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors);
@@ -48,6 +49,11 @@ public:
 
     void labelTextChanged(Label* label);
 
+    void comboBoxChanged(ComboBox* comboBox);
+
+    void startAcquisition();
+    void stopAcquisition();
+
     void saveEditorParameters(XmlElement* xml);
     void loadEditorParameters(XmlElement* xml);
 
@@ -55,6 +61,9 @@ private:
 
     String lastHighCutString;
     String lastLowCutString;
+    String lastTapsString;
+
+    void updateDelayTooltip();
 
     ScopedPointer<Label> highCutLabel;
     ScopedPointer<Label> lowCutLabel;
@@ -62,6 +71,15 @@ private:
     ScopedPointer<Label> highCutValue;
     ScopedPointer<Label> lowCutValue;
 
+    ScopedPointer<Label> typeLabel;
+    ScopedPointer<ComboBox> typeSelector;
+
+    ScopedPointer<Label> tapsLabel;
+    ScopedPointer<Label> tapsValue;
+
+    ScopedPointer<Label> precisionLabel;
+    ScopedPointer<ComboBox> precisionSelector;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilterEditor);
 
 };
@@ -30,13 +30,14 @@
 #include "../../UI/ProcessorList.h"
 
 #include "../../UI/EditorViewport.h"
+#include "../AllocationTracker.h"
 
 #include <math.h>
 
 GenericEditor::GenericEditor(GenericProcessor* owner, bool useDefaultParameterEditors=true)
     : AudioProcessorEditor(owner),
       desiredWidth(150), isFading(false), accumulator(0.0), acquisitionIsActive(false),
-      drawerButton(0), channelSelector(0),
+      drawerButton(0), channelSelector(0), statisticsLabel(0),
       isSelected(false),  isEnabled(true), tNum(-1)
 {
     constructorInitialize(owner, useDefaultParameterEditors);
@@ -103,6 +104,9 @@ void GenericEditor::constructorInitialize(GenericProcessor* owner, bool useDefau
 
     addParameterEditors(useDefaultParameterEditors);
 
+    statisticsLabel = new ProcessorStatisticsLabel(owner);
+    addChildComponent(statisticsLabel);
+
     backgroundColor = Colour(10,10,10);
 
     //fadeIn();
@@ -175,6 +179,9 @@ void GenericEditor::resized()
 
     if (channelSelector != 0)
         channelSelector->setBounds(desiredWidth - drawerWidth, 30, channelSelector->getDesiredWidth(), getHeight()-45);
+
+    if (statisticsLabel != 0)
+        statisticsLabel->setBounds(getWidth()-85, 5, 80, 15);
 }
 
 
@@ -540,6 +547,12 @@ void GenericEditor::loadEditorParameters(XmlElement* xml)
 }
 
 
+void GenericEditor::setStatisticsVisible(bool t)
+{
+    if (statisticsLabel != 0)
+        statisticsLabel->setVisible(t);
+}
+
 /////////////////////// BUTTONS ///////////////////////////////
 
 DrawerButton::DrawerButton(const String& name) : Button(name)
@@ -835,3 +848,64 @@ void GenericEditor::updateParameterButtons(int parameterIndex)
         //std::cout << "updateParameterButtons" << std::endl;
     }
 }
+
+ProcessorStatisticsLabel::ProcessorStatisticsLabel(GenericProcessor* p)
+    : processor(p), font("Small Text", 10, Font::plain)
+{
+    setInterceptsMouseClicks(true, false); // needed for the tooltip
+}
+
+void ProcessorStatisticsLabel::visibilityChanged()
+{
+    if (isVisible())
+        startTimer(500);
+    else
+        stopTimer();
+}
+
+void ProcessorStatisticsLabel::timerCallback()
+{
+    if (!isShowing())
+        return;
+
+    ProcessorStatistics::Summary s = processor->getStatistics().getSummary();
+
+    String tip;
+    tip << "blocks: " << String(s.numBlocks)
+        << "  min: " << String(s.minMs, 3)
+        << "  mean: " << String(s.meanMs, 3)
+        << "  p99: " << String(s.p99Ms, 3)
+        << "  max: " << String(s.maxMs, 3) << " ms"
+        << "  budget: " << String(s.budgetFraction * 100.0, 1) << "%"
+        << "  overruns: " << String(s.numOverruns);
+
+    if (AllocationTracker::isEnabled())
+        tip << "  allocations: " << String(s.numAllocations);
+
+    setTooltip(tip);
+
+    repaint();
+}
+
+void ProcessorStatisticsLabel::paint(Graphics& g)
+{
+    ProcessorStatistics::Summary s = processor->getStatistics().getSummary();
+
+    if (s.numAllocations > 0)
+        g.setColour(Colours::orangered);
+    else if (s.numOverruns > 0)
+        g.setColour(Colours::yellow);
+    else
+        g.setColour(Colours::white.withAlpha(0.8f));
+
+    g.setFont(font);
+
+    String text;
+
+    if (s.numBlocks > 0)
+        text << String(s.meanMs, 2) << " | " << String(s.p99Ms, 2) << " ms";
+    else
+        text << "-- ms";
+
+    g.drawText(text, 0, 0, getWidth(), getHeight(), Justification::right, false);
+}
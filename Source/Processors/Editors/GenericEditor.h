@@ -39,6 +39,7 @@ class UtilityButton;
 class ParameterEditor;
 class ChannelSelector;
 class Channel;
+class ProcessorStatisticsLabel;
 
 
 /**
@@ -239,6 +240,10 @@ public:
 
     /** Syncs parametereditor colors with parameter values */
     void updateParameterButtons(int parameterIndex = -1);
+
+    /** Shows or hides the processing-time overlay in the editor's title bar. */
+    void setStatisticsVisible(bool);
+
 protected:
 
     /** A pointer to the button that opens the drawer for the ChannelSelector. */
@@ -256,6 +261,9 @@ protected:
     /** A pointer to the editor's ChannelSelector. */
     ChannelSelector* channelSelector;
 
+    /** A pointer to the overlay that displays the processor's timing statistics. */
+    ProcessorStatisticsLabel* statisticsLabel;
+
 
 
 private:
@@ -375,4 +383,37 @@ private:
 };
 
 
+/**
+
+  Displays the mean and 99th-percentile time spent in a processor's
+  process() method, as recorded by its ProcessorStatistics.
+
+  Sits in the title bar of every GenericEditor and refreshes itself
+  twice per second while visible. The tooltip shows the full summary.
+
+  @see GenericEditor, ProcessorStatistics
+
+*/
+
+class ProcessorStatisticsLabel : public Component,
+    public Timer,
+    public SettableTooltipClient
+{
+public:
+    ProcessorStatisticsLabel(GenericProcessor* p);
+    ~ProcessorStatisticsLabel() {}
+
+    void paint(Graphics& g);
+
+    void visibilityChanged();
+
+private:
+    void timerCallback();
+
+    GenericProcessor* processor;
+
+    Font font;
+};
+
+
 #endif  // __GENERICEDITOR_H_DD406E71__
@@ -0,0 +1,186 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "LineNoiseFilterEditor.h"
+#include "../LineNoiseFilter.h"
+#include <stdio.h>
+
+
+LineNoiseFilterEditor::LineNoiseFilterEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors=true)
+    : GenericEditor(parentNode, useDefaultParameterEditors), previousChannelCount(0)
+
+{
+    desiredWidth = 220;
+
+    frequencySelector = createSelector("line frequency", "Line:", 10, 25, 80);
+    frequencySelector->addItem("50 Hz", 1);
+    frequencySelector->addItem("60 Hz", 2);
+    frequencySelector->setSelectedId(2, true);
+
+    harmonicsSelector = createSelector("harmonics", "Notches:", 110, 25, 80);
+
+    for (int i = 1; i <= LineNoiseFilter::MAX_HARMONICS; i++)
+        harmonicsSelector->addItem(String(i), i);
+
+    harmonicsSelector->setSelectedId(3, true);
+    harmonicsSelector->setTooltip("Number of notches: the line frequency and its harmonics.");
+
+    widths.add("0.5");
+    widths.add("1");
+    widths.add("2");
+    widths.add("4");
+
+    widthSelector = createSelector("notch width", "Width (Hz):", 10, 75, 80);
+    widthSelector->addItemList(widths, 1);
+    widthSelector->setSelectedId(3, true);
+
+    referenceSelector = createSelector("reference", "Track on:", 110, 75, 80);
+    referenceSelector->addItem("None", 1);
+    referenceSelector->setSelectedId(1, true);
+    referenceSelector->setTooltip("Channel on which to measure the line frequency, so that "
+                                  "the notches follow its drift.");
+
+    notchFrequencyLabel = new NotchFrequencyLabel((LineNoiseFilter*) parentNode);
+    notchFrequencyLabel->setBounds(10,108,180,20);
+    notchFrequencyLabel->setFont(Font("Small Text", 12, Font::plain));
+    notchFrequencyLabel->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(notchFrequencyLabel);
+
+}
+
+LineNoiseFilterEditor::~LineNoiseFilterEditor()
+{
+
+}
+
+ComboBox* LineNoiseFilterEditor::createSelector(const String& name, const String& label,
+                                                int x, int y, int width)
+{
+    Label* l = new Label(name + " label", label);
+    l->setBounds(x - 5, y, width + 10, 20);
+    l->setFont(Font("Small Text", 12, Font::plain));
+    l->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(l);
+    labels.add(l);
+
+    ComboBox* selector = new ComboBox(name);
+    selector->setBounds(x, y + 20, width, 20);
+    selector->addListener(this);
+    addAndMakeVisible(selector);
+
+    return selector;
+}
+
+void LineNoiseFilterEditor::updateSettings()
+{
+
+    if (getProcessor()->getNumInputs() != previousChannelCount)
+    {
+        const int selected = referenceSelector->getSelectedId();
+
+        referenceSelector->clear(true);
+        referenceSelector->addItem("None", 1);
+
+        for (int i = 0; i < getProcessor()->getNumInputs(); i++)
+        {
+            referenceSelector->addItem("Ch " + String(i+1), i+2);
+        }
+
+        previousChannelCount = getProcessor()->getNumInputs();
+
+        // keep the reference if it still exists
+        if (selected > 1 && selected <= previousChannelCount + 1)
+            referenceSelector->setSelectedId(selected, true);
+        else
+            referenceSelector->setSelectedId(1);
+    }
+
+}
+
+void LineNoiseFilterEditor::comboBoxChanged(ComboBox* comboBox)
+{
+
+    GenericProcessor* p = getProcessor();
+
+    if (comboBox == frequencySelector)
+    {
+        p->setParameter(0, comboBox->getSelectedId() == 1 ? 50.0f : 60.0f);
+    }
+    else if (comboBox == harmonicsSelector)
+    {
+        p->setParameter(1, float(comboBox->getSelectedId()));
+    }
+    else if (comboBox == widthSelector)
+    {
+        p->setParameter(2, widths[comboBox->getSelectedId()-1].getFloatValue());
+    }
+    else if (comboBox == referenceSelector)
+    {
+        p->setParameter(3, float(comboBox->getSelectedId() - 2)); // "None" is -1
+    }
+
+}
+
+void LineNoiseFilterEditor::saveEditorParameters(XmlElement* xml)
+{
+
+    xml->setAttribute("Type", "LineNoiseFilterEditor");
+
+    XmlElement* values = xml->createNewChildElement("VALUES");
+    values->setAttribute("Frequency",frequencySelector->getSelectedId());
+    values->setAttribute("Harmonics",harmonicsSelector->getSelectedId());
+    values->setAttribute("Width",widthSelector->getSelectedId());
+    values->setAttribute("Reference",referenceSelector->getSelectedId());
+
+}
+
+void LineNoiseFilterEditor::loadEditorParameters(XmlElement* xml)
+{
+
+    forEachXmlChildElement(*xml, xmlNode)
+    {
+        if (xmlNode->hasTagName("VALUES"))
+        {
+            frequencySelector->setSelectedId(xmlNode->getIntAttribute("Frequency", 2));
+            harmonicsSelector->setSelectedId(xmlNode->getIntAttribute("Harmonics", 3));
+            widthSelector->setSelectedId(xmlNode->getIntAttribute("Width", 3));
+            referenceSelector->setSelectedId(xmlNode->getIntAttribute("Reference", 1));
+        }
+    }
+
+}
+
+NotchFrequencyLabel::NotchFrequencyLabel(LineNoiseFilter* p)
+    : Label("notch frequency", String::empty), processor(p)
+{
+    startTimer(500);
+}
+
+void NotchFrequencyLabel::timerCallback()
+{
+    if (!isShowing())
+        return;
+
+    setText("Notches at " + String(processor->getNotchFrequency(), 3) + " Hz",
+            dontSendNotification);
+}
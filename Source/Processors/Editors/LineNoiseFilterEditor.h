@@ -0,0 +1,98 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __LINENOISEFILTEREDITOR_H_7A02F5C1__
+#define __LINENOISEFILTEREDITOR_H_7A02F5C1__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "GenericEditor.h"
+
+class LineNoiseFilter;
+class NotchFrequencyLabel;
+
+/**
+
+  User interface for the LineNoiseFilter processor.
+
+  @see LineNoiseFilter
+
+*/
+
+class LineNoiseFilterEditor : public GenericEditor,
+    public ComboBox::Listener
+{
+public:
+    LineNoiseFilterEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors);
+    virtual ~LineNoiseFilterEditor();
+
+    void comboBoxChanged(ComboBox* comboBox);
+
+    void updateSettings();
+
+    void saveEditorParameters(XmlElement* xml);
+    void loadEditorParameters(XmlElement* xml);
+
+private:
+
+    ComboBox* createSelector(const String& name, const String& label, int x, int y, int width);
+
+    ScopedPointer<ComboBox> frequencySelector;
+    ScopedPointer<ComboBox> harmonicsSelector;
+    ScopedPointer<ComboBox> widthSelector;
+    ScopedPointer<ComboBox> referenceSelector;
+
+    OwnedArray<Label> labels;
+
+    ScopedPointer<NotchFrequencyLabel> notchFrequencyLabel;
+
+    StringArray widths;
+
+    int previousChannelCount;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LineNoiseFilterEditor);
+
+};
+
+/**
+
+  Shows the frequency the notches are tuned to, which follows the
+  measured line frequency when tracking is on.
+
+  @see LineNoiseFilterEditor
+
+*/
+
+class NotchFrequencyLabel : public Label,
+    public Timer
+{
+public:
+    NotchFrequencyLabel(LineNoiseFilter* p);
+    ~NotchFrequencyLabel() {}
+
+private:
+    void timerCallback();
+
+    LineNoiseFilter* processor;
+};
+
+#endif  // __LINENOISEFILTEREDITOR_H_7A02F5C1__
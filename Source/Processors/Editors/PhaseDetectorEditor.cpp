@@ -23,6 +23,7 @@
 
 
 #include "PhaseDetectorEditor.h"
+#include "../PhaseDetector.h"
 
 #include <stdio.h>
 
@@ -34,12 +35,28 @@ PhaseDetectorEditor::PhaseDetectorEditor(GenericProcessor* parentNode, bool useD
     desiredWidth = 180;
 
     channelSelectionBox = new ComboBox();
-    channelSelectionBox->setBounds(15,50,150,25);
+    channelSelectionBox->setBounds(15,30,150,25);
     channelSelectionBox->addListener(this);
     channelSelectionBox->addItem("None", 1);
     channelSelectionBox->setSelectedId(1, false);
     addAndMakeVisible(channelSelectionBox);
 
+    modeSelectionBox = new ComboBox();
+    modeSelectionBox->setBounds(15,65,150,25);
+    modeSelectionBox->addListener(this);
+    modeSelectionBox->addItem("Detect peaks", 1);
+    modeSelectionBox->addItem("Predict peaks", 2);
+    modeSelectionBox->setSelectedId(1, true);
+    modeSelectionBox->setTooltip("Predict forecasts the channel to place each event on the "
+                                 "next peak, rather than just after it. Band-pass it first.");
+    addAndMakeVisible(modeSelectionBox);
+
+    phaseErrorLabel = new PhaseErrorLabel((PhaseDetector*) parentNode);
+    phaseErrorLabel->setBounds(10,100,165,20);
+    phaseErrorLabel->setFont(Font("Small Text", 12, Font::plain));
+    phaseErrorLabel->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(phaseErrorLabel);
+
 }
 
 PhaseDetectorEditor::~PhaseDetectorEditor()
@@ -74,6 +91,12 @@ void PhaseDetectorEditor::updateSettings()
 
 void PhaseDetectorEditor::comboBoxChanged(ComboBox* c)
 {
+    if (c == modeSelectionBox)
+    {
+        getProcessor()->setParameter(2, float(c->getSelectedId() - 1));
+        return;
+    }
+
     float channel;
 
     int id = c->getSelectedId();
@@ -106,6 +129,10 @@ void PhaseDetectorEditor::saveEditorParameters(XmlElement* xml)
 
     selectedChannel->setAttribute("ID",channelSelectionBox->getSelectedId());
 
+    XmlElement* mode = xml->createNewChildElement("MODE");
+
+    mode->setAttribute("ID",modeSelectionBox->getSelectedId());
+
 }
 
 void PhaseDetectorEditor::loadEditorParameters(XmlElement* xml)
@@ -123,5 +150,31 @@ void PhaseDetectorEditor::loadEditorParameters(XmlElement* xml)
             channelSelectionBox->setSelectedId(id, false);
 
         }
+        else if (xmlNode->hasTagName("MODE"))
+        {
+            modeSelectionBox->setSelectedId(xmlNode->getIntAttribute("ID", 1), false);
+        }
     }
-}
\ No newline at end of file
+}
+
+PhaseErrorLabel::PhaseErrorLabel(PhaseDetector* p)
+    : Label("phase error", String::empty), processor(p)
+{
+    startTimer(500);
+}
+
+void PhaseErrorLabel::timerCallback()
+{
+    if (!isShowing())
+        return;
+
+    if (processor->getNumPhaseErrors() == 0)
+    {
+        setText(String::empty, dontSendNotification);
+        return;
+    }
+
+    setText("Error " + String(processor->getPhaseErrorMean(), 0) + " +/- "
+            + String(processor->getPhaseErrorSpread(), 0) + " deg (n = "
+            + String(processor->getNumPhaseErrors()) + ")", dontSendNotification);
+}
@@ -28,6 +28,9 @@
 #include "../../../JuceLibraryCode/JuceHeader.h"
 #include "GenericEditor.h"
 
+class PhaseDetector;
+class PhaseErrorLabel;
+
 /**
 
   User interface for the PhaseDetector processor.
@@ -54,6 +57,9 @@ public:
 private:
 
     ScopedPointer<ComboBox> channelSelectionBox;
+    ScopedPointer<ComboBox> modeSelectionBox;
+
+    ScopedPointer<PhaseErrorLabel> phaseErrorLabel;
 
     int previousChannelCount;
 
@@ -61,6 +67,27 @@ private:
 
 };
 
+/**
+
+  Shows how far from the peaks the events have landed so far.
+
+  @see PhaseDetectorEditor
+
+*/
+
+class PhaseErrorLabel : public Label,
+    public Timer
+{
+public:
+    PhaseErrorLabel(PhaseDetector* p);
+    ~PhaseErrorLabel() {}
+
+private:
+    void timerCallback();
+
+    PhaseDetector* processor;
+};
+
 
 
 #endif  // __PHASEDETECTOREDITOR_H_136829C6__
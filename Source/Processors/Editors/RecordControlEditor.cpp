@@ -73,6 +73,6 @@ void RecordControlEditor::updateSettings()
     availableChans->clear();
     GenericProcessor* processor = getProcessor();
     for (int i = 0; i < processor->eventChannels.size() ; i++)
-        availableChans->addItem(processor->eventChannels[i]->name,i+1);
+        availableChans->addItem(processor->eventChannels[i]->getName(),i+1);
 
 }
\ No newline at end of file
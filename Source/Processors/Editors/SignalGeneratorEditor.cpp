@@ -46,6 +46,15 @@ SignalGeneratorEditor::SignalGeneratorEditor(GenericProcessor* parentNode, bool
         addAndMakeVisible(ws);
     }
 
+    probeButton = new UtilityButton("PRB", Font("Small Text", 10, Font::plain));
+    probeButton->setBounds(8 + buttonWidth*5 + 2, 30, buttonWidth, buttonHeight);
+    probeButton->setRadius(3.0f);
+    probeButton->setRadioGroupId(299);
+    probeButton->setClickingTogglesState(true);
+    probeButton->setTooltip("Synthetic probe: spikes in noise, the same on every run");
+    probeButton->addListener(this);
+    addAndMakeVisible(probeButton);
+
     amplitudeSlider = new Slider("Amplitude Slider");
     amplitudeSlider->setBounds(10,60,50,60);
     amplitudeSlider->setRange(0,1,0.1);
@@ -88,6 +97,18 @@ SignalGeneratorEditor::SignalGeneratorEditor(GenericProcessor* parentNode, bool
     downButton->setBounds(200,75,20,15);
     addAndMakeVisible(downButton);
 
+    noiseLabel = new Label("Noise Label", "Noise:");
+    noiseLabel->setFont(Font("Small Text", 10, Font::plain));
+    noiseLabel->setColour(Label::textColourId, Colours::darkgrey);
+    noiseLabel->setBounds(185,95,40,15);
+    addAndMakeVisible(noiseLabel);
+
+    noiseValue = new Label("Noise Value", "5");
+    noiseValue->setEditable(true);
+    noiseValue->addListener(this);
+    noiseValue->setBounds(190,110,35,15);
+    addAndMakeVisible(noiseValue);
+
 }
 
 SignalGeneratorEditor::~SignalGeneratorEditor()
@@ -144,6 +165,19 @@ void SignalGeneratorEditor::buttonEvent(Button* button)
         }
     }
 
+    if (button == probeButton)
+    {
+        Array<int> chans = getActiveChannels();
+
+        GenericProcessor* p = getProcessor();
+
+        for (int n = 0; n < chans.size(); n++)
+        {
+            p->setCurrentChannel(chans[n]);
+            p->setParameter(3, 6.0f); // PROBE
+        }
+    }
+
     int num = numChannelsLabel->getText().getIntValue();
 
     if (button == upButton)
@@ -197,6 +231,22 @@ void SignalGeneratorEditor::labelTextChanged(Label* label)
 {
 
     SignalGenerator* sg = (SignalGenerator*) getProcessor();
+
+    if (label == noiseValue)
+    {
+        const float level = jmax(0.0f, noiseValue->getText().getFloatValue());
+
+        Array<int> chans = getActiveChannels();
+
+        for (int n = 0; n < chans.size(); n++)
+        {
+            sg->setCurrentChannel(chans[n]);
+            sg->setParameter(4, level);
+        }
+
+        return;
+    }
+
     sg->nOut = numChannelsLabel->getText().getIntValue();
     getEditorViewport()->makeEditorVisible(this);
 }
@@ -36,6 +36,10 @@ class WaveformSelector;
 
   Allows the user to edit the waveform type, amplitude, frequency, and phase of individual channels.
 
+  The PRB button selects a synthetic probe signal instead: spikes at a mean rate
+  set by the frequency slider and a size set by the amplitude slider, in noise
+  whose level is typed in below it.
+
   @see SignalGenerator
 
 */
@@ -62,6 +66,10 @@ private:
 
     Array<WaveformSelector*> waveformSelectors;
 
+    UtilityButton* probeButton;
+    Label* noiseLabel;
+    Label* noiseValue;
+
     enum wvfrm
     {
         SINE, SQUARE, SAW, TRIANGLE, NOISE
@@ -0,0 +1,61 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SPECTRUMEDITOR_H_4F0C2A9E__
+#define __SPECTRUMEDITOR_H_4F0C2A9E__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "GenericEditor.h"
+#include "../SpectrumNode.h"
+#include "../Visualization/SpectrumCanvas.h"
+#include "VisualizerEditor.h"
+
+class Visualizer;
+
+/**
+
+  User interface for the SpectrumNode sink.
+
+  The channel selector picks the channels to analyse; everything else
+  is set from the canvas.
+
+  @see SpectrumNode, SpectrumCanvas
+
+*/
+
+class SpectrumEditor : public VisualizerEditor
+{
+public:
+    SpectrumEditor(GenericProcessor*, bool useDefaultParameterEditors);
+    ~SpectrumEditor();
+
+    Visualizer* createNewCanvas();
+
+private:
+
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumEditor);
+
+};
+
+#endif  // __SPECTRUMEDITOR_H_4F0C2A9E__
@@ -56,7 +56,7 @@ void EventNode::updateSettings()
     // add event channels
 
     Channel* ch = new Channel(this, 1);
-    ch->name = "Trigger";
+    ch->setName("Trigger");
 
     eventChannels.add(ch);
 
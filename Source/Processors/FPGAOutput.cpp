@@ -61,12 +61,12 @@ AudioProcessorEditor* FPGAOutput::createEditor()
     return editor;
 }
 
-void FPGAOutput::handleEvent(int eventType, MidiMessage& event, int sampleNum)
+void FPGAOutput::handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum)
 {
     if (eventType == TTL && isEnabled)
     {
 
-        const uint8* dataptr = event.getRawData();
+        const uint8* dataptr = eventData;
 
         // int eventNodeId = *(dataptr+1);
         int eventId = *(dataptr+2);
@@ -52,7 +52,7 @@ public:
     void process(AudioSampleBuffer& buffer, MidiBuffer& midiMessages, int& nSamples);
     void setParameter(int parameterIndex, float newValue);
 
-    void handleEvent(int eventType, MidiMessage& event, int sampleNum);
+    void handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum);
 
     AudioProcessorEditor* createEditor();
 
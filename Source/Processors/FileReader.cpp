@@ -23,34 +23,22 @@
 
 #include "FileReader.h"
 #include "Editors/FileReaderEditor.h"
-#include <stdio.h>
 
 FileReader::FileReader()
-    : GenericProcessor("File Reader")
+    : GenericProcessor("File Reader"), timestamp(0),
+      playbackSpeed(1.0f), samplesOwed(0.0), pendingSeek(-1), playbackPosition(0)
 {
 
-    input = 0;
-    timestamp = 0;
+    // format assumed for raw files, which have no header
+    playbackFile.setRawFormat(64, 40000.0f, 0.05f);
 
     enabledState(false);
 
-    // check endianness of the platform
-    uint32 magic = 0x00000001;
-    uint8 black_magic = *(uint8 *)&magic;
-
-    if (black_magic > 0)
-    {
-        isLittleEndian = true;
-    } else {
-        isLittleEndian = false;
-    }
-
 }
 
 FileReader::~FileReader()
 {
-    if (input)
-        fclose(input);
+
 }
 
 AudioProcessorEditor* FileReader::createEditor()
@@ -63,13 +51,14 @@ AudioProcessorEditor* FileReader::createEditor()
 
 bool FileReader::isReady()
 {
-    if (input == 0)
+    if (!playbackFile.isOpen())
     {
         sendActionMessage("No file selected in File Reader.");
         return false;
     }
     else
     {
+        samplesOwed = 0.0;
         return true;
     }
 }
@@ -77,17 +66,26 @@ bool FileReader::isReady()
 
 float FileReader::getDefaultSampleRate()
 {
-    return 40000.0f;
+    if (playbackFile.isOpen())
+        return playbackFile.getSampleRate();
+    else
+        return 40000.0f;
 }
 
 int FileReader::getDefaultNumOutputs()
 {
-    return 64;
+    if (playbackFile.isOpen())
+        return playbackFile.getNumChannels();
+    else
+        return 64;
 }
 
 float FileReader::getDefaultBitVolts()
 {
-    return 0.05f;
+    if (playbackFile.isOpen())
+        return playbackFile.getBitVolts();
+    else
+        return 0.05f;
 }
 
 void FileReader::enabledState(bool t)
@@ -103,32 +101,44 @@ void FileReader::setFile(String fullpath)
 
     filePath = fullpath;
 
-    const char* path = filePath.getCharPointer();
+    playbackFile.open(File(filePath));
 
-    if (input)
-        fclose(input);
+    playbackPosition.set(0);
 
-    input = fopen(path, "r");
+}
 
-    // Avoid a segfault if file isn't found
-    if (!input)
-    {
-        std::cout << "Can't find data file "
-                  << '"' << path << "\""
-                  << std::endl;
-        return;
-    }
 
-    fseek(input, 0, SEEK_END);
-    lengthOfInputFile = ftell(input);
-    rewind(input);
+String FileReader::getFile()
+{
+    return filePath;
+}
 
+int64 FileReader::getNumSamplesInFile()
+{
+    return playbackFile.getNumSamples();
 }
 
+float FileReader::getMaxPlaybackSpeed()
+{
+    const double deviceRate = (AudioProcessor::getSampleRate() > 0) ? AudioProcessor::getSampleRate() : 44100.0;
 
-String FileReader::getFile()
+    if (!playbackFile.isOpen() || playbackFile.getSampleRate() <= 0)
+        return 1.0f;
+
+    return float(deviceRate / playbackFile.getSampleRate());
+}
+
+float FileReader::getPlaybackPosition()
 {
-    return filePath;
+    const int64 numSamples = playbackFile.getNumSamples();
+
+    if (numSamples <= 0)
+        return 0.0f;
+
+    const int64 seekTarget = pendingSeek.get();
+    const int64 position = (seekTarget >= 0) ? seekTarget : playbackPosition.get();
+
+    return float(double(position) / double(numSamples));
 }
 
 void FileReader::updateSettings()
@@ -141,6 +151,11 @@ void FileReader::updateSettings()
 void FileReader::process(AudioSampleBuffer& buffer, MidiBuffer& events, int& nSamples)
 {
 
+    const int64 seekTarget = pendingSeek.exchange(-1);
+
+    if (seekTarget >= 0)
+        playbackFile.setPosition(seekTarget);
+
     uint8 data[8];
     memcpy(data, &timestamp, 8);
 
@@ -154,42 +169,29 @@ void FileReader::process(AudioSampleBuffer& buffer, MidiBuffer& events, int& nSa
              data   // data
             );
 
-    // FIXME: needs to account for the fact that the ratio might not be an exact
-    //        integer value
-    int samplesNeeded = (int) float(buffer.getNumSamples()) * (getDefaultSampleRate()/44100.0f);
+    // the callback covers buffer.getNumSamples() samples at the device rate;
+    // work out how many file samples that corresponds to at the current speed.
+    // No more than one buffer fits, which caps the speed at getMaxPlaybackSpeed()
+    const double deviceRate = (AudioProcessor::getSampleRate() > 0) ? AudioProcessor::getSampleRate() : 44100.0;
+    const float speed = jmin(playbackSpeed, getMaxPlaybackSpeed());
 
-    if (ftell(input) >= lengthOfInputFile - samplesNeeded)
-    {
-        rewind(input);
-    }
+    samplesOwed += double(buffer.getNumSamples()) * playbackFile.getSampleRate() * speed / deviceRate;
 
-    size_t numRead = fread(readBuffer, 2, samplesNeeded*buffer.getNumChannels(), input);
+    const int samplesNeeded = jmin((int) samplesOwed, buffer.getNumSamples());
 
-    int chan = 0;
-    int samp = 0;
-
-    for (size_t n = 0; n < numRead; n++)
-    {
-
-        if (chan == buffer.getNumChannels())
-        {
-            samp++;
-            timestamp++;
-            chan = 0;
-        }
+    samplesOwed = jmin(samplesOwed - samplesNeeded, double(buffer.getNumSamples()));
 
-        int16 sample = readBuffer[n];
+    const int numChannels = jmin(buffer.getNumChannels(), playbackFile.getNumChannels());
 
-        if (!isLittleEndian) // most likely on Windows
-        {
-            // reverse the byte order
-            sample = (((sample >> 0) & 0xff) << 8) | 
-                     (((sample >> 8) & 0xff) << 0);
-        }
+    for (int chan = 0; chan < numChannels; chan++)
+    {
+        playbackFile.readChannel(chan, buffer.getSampleData(chan, 0), samplesNeeded);
+    }
 
-        *buffer.getSampleData(chan++, samp) = float(-sample) * getDefaultBitVolts(); // previously 0.035
+    playbackFile.advance(samplesNeeded);
+    timestamp += samplesNeeded;
 
-    }
+    playbackPosition.set(playbackFile.getPosition());
 
     nSamples = samplesNeeded;
 
@@ -199,6 +201,16 @@ void FileReader::process(AudioSampleBuffer& buffer, MidiBuffer& events, int& nSa
 void FileReader::setParameter(int parameterIndex, float newValue)
 {
 
+    if (parameterIndex == 0)
+    {
+        playbackSpeed = jmax(0.01f, newValue);
+    }
+    else if (parameterIndex == 1)
+    {
+        const int64 target = (int64)(jlimit(0.0f, 1.0f, newValue) * double(playbackFile.getNumSamples()));
+        pendingSeek.set(target);
+    }
+
 }
 
 
@@ -230,4 +242,4 @@ void FileReader::loadCustomParametersFromXml()
         }
     }
 
-}
\ No newline at end of file
+}
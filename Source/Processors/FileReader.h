@@ -29,14 +29,26 @@
 #include "../../JuceLibraryCode/JuceHeader.h"
 
 #include "GenericProcessor.h"
-
-#define BUFFER_SIZE 102400
+#include "DataThreads/PlaybackFile.h"
 
 /**
 
-  Reads data from a file.
+  Plays back previously recorded data.
+
+  Open Ephys .continuous files and raw interleaved int16 files are memory-mapped
+  by a PlaybackFile and decoded straight into the output buffer. The channel
+  count, sample rate and bitVolts come from the file header when there is one.
+  Playback can be sped up, and can seek while running. Each callback delivers
+  at most one device buffer of samples, so the speed is limited to the device
+  rate divided by the file's sample rate; see getMaxPlaybackSpeed(). A 30 kHz
+  recording on a 44.1 kHz device can't go past x1.47, so x2 needs a device
+  running at twice the file's rate, and the editor only offers the speeds
+  that fit.
+
+  Parameters: 0 = playback speed (multiple of real time),
+              1 = position (fraction of the file length).
 
-  @see GenericProcessor
+  @see GenericProcessor, PlaybackFile
 
 */
 
@@ -76,6 +88,19 @@ public:
     void setFile(String fullpath);
     String getFile();
 
+    /** Returns the number of samples per channel in the current file.*/
+    int64 getNumSamplesInFile();
+
+    /** Returns the fastest speed the current file can be played at, as a
+        multiple of real time. Can be below 1 for files recorded faster than
+        the audio device runs.*/
+    float getMaxPlaybackSpeed();
+
+    /** Returns how far playback has got through the file, as a fraction of
+        its length, including any seek that hasn't happened yet. Safe to
+        call from the message thread.*/
+    float getPlaybackPosition();
+
     void saveCustomParametersToXml(XmlElement* parentElement);
     void loadCustomParametersFromXml();
 
@@ -83,16 +108,20 @@ private:
 
     uint64 timestamp;
 
-    int lengthOfInputFile;
-    FILE* input;
+    PlaybackFile playbackFile;
+
+    String filePath;
 
-    int16 readBuffer[BUFFER_SIZE];
+    float playbackSpeed;
 
-    int bufferSize;
+    /** Fractional samples carried over between blocks, so the playback rate
+        stays exact when it isn't an integer multiple of the block size.*/
+    double samplesOwed;
 
-    String filePath;
+    Atomic<int64> pendingSeek;
 
-    bool isLittleEndian;
+    /** Read position after the last block, for the editor.*/
+    Atomic<int64> playbackPosition;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileReader);
 
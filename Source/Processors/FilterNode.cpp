@@ -25,8 +25,33 @@
 #include "FilterNode.h"
 #include "Editors/FilterEditor.h"
 
+/** Runs the zero-phase backward passes of every step-th channel. */
+class FilterNode::ZeroPhaseJob : public ThreadPoolJob
+{
+public:
+    ZeroPhaseJob(FilterNode* n, int first_, int step_)
+        : ThreadPoolJob("Zero-phase filter"), node(n), first(first_), step(step_) {}
+
+    JobStatus runJob()
+    {
+        for (int chan = first; chan < node->filters.size(); chan += step)
+            node->runBackwardPass(chan);
+
+        return jobHasFinished;
+    }
+
+private:
+    FilterNode* node;
+    int first;
+    int step;
+};
+
 FilterNode::FilterNode()
-    : GenericProcessor("Bandpass Filter")
+    : GenericProcessor("Bandpass Filter"), designSampleRate(0),
+      filterType(IIR_FILTER), numFirTaps(255),
+      useSinglePrecision(false),
+      zeroPhaseChunkSize(0), zeroPhaseFill(0), zeroPhaseChunk(0), zeroPhaseBackwardChunk(0),
+      zeroPhaseStarted(false), acquisitionActive(false)
 
 {
 
@@ -51,7 +76,13 @@ FilterNode::FilterNode()
 
 FilterNode::~FilterNode()
 {
+    finishZeroPhase();
+    zeroPhasePool = nullptr;
 
+    filters.clear();
+    designCache.clear();
+    singleDesignCache.clear();
+    firDesignCache.clear();
 }
 
 AudioProcessorEditor* FilterNode::createEditor()
@@ -124,40 +155,53 @@ AudioProcessorEditor* FilterNode::createEditor()
 void FilterNode::updateSettings()
 {
 
-    if (getNumInputs() < 1024 && getNumInputs() != filters.size())
-    {
+    // only channels that came or went are touched; the others keep
+    // their filters and cutoffs
+    const int previousCount = filters.size();
 
-        filters.clear();
-        lowCuts.clear();
-        highCuts.clear();
+    while (filters.size() > getNumInputs())
+    {
+        ChannelFilter* filter = filters.getLast();
 
-        for (int n = 0; n < getNumInputs(); n++)
-        {
+        designCache.release(filter->design);
+        singleDesignCache.release(filter->singleDesign);
+        firDesignCache.release(filter->firDesign);
 
-             std::cout << "Creating filter number " << n << std::endl;
+        filters.removeLast();
+        lowCuts.removeLast();
+        highCuts.removeLast();
+    }
 
-            filters.add(new Dsp::SmoothedFilterDesign
-                        <Dsp::Butterworth::Design::BandPass 	// design type
-                        <2>,								 	// order
-                        1,										// number of channels (must be const)
-                        Dsp::DirectFormII>						// realization
-                        (1));
+    if (getSampleRate() != designSampleRate)
+    {
+        designSampleRate = getSampleRate();
 
+        for (int n = 0; n < filters.size(); n++)
+            setFilterParameters(lowCuts[n], highCuts[n], n);
+    }
 
-            //Parameter& p1 =  parameters.getReference(0);
-            //p1.setValue(600.0f, n);
-            //Parameter& p2 =  parameters.getReference(1);
-            //p2.setValue(6000.0f, n);
+    if (filters.size() < getNumInputs())
+        std::cout << "Creating " << getNumInputs() - filters.size() << " filters." << std::endl;
 
-            // restore defaults
-            lowCuts.add(600.0f);
-            highCuts.add(6000.0f);
+    while (filters.size() < getNumInputs())
+    {
+        filters.add(new ChannelFilter());
 
-            setFilterParameters(600.0f, 6000.0f, n);
-        }
+        // restore defaults
+        lowCuts.add(600.0f);
+        highCuts.add(6000.0f);
 
+        setFilterParameters(600.0f, 6000.0f, filters.size() - 1);
     }
 
+    // nothing is processing during an update
+    designCache.purge();
+    singleDesignCache.purge();
+    firDesignCache.purge();
+
+    if (filters.size() != previousCount && filterType == ZERO_PHASE_FILTER)
+        prepareZeroPhase();
+
 }
 
 double FilterNode::getLowCutValueForChannel(int chan)
@@ -173,20 +217,292 @@ double FilterNode::getHighCutValueForChannel(int chan)
 void FilterNode::setFilterParameters(double lowCut, double highCut, int chan)
 {
 
-    Dsp::Params params;
-    params[0] = getSampleRate(); // sample rate
-    params[1] = 2; // order
-    params[2] = (highCut + lowCut)/2; // center frequency
-    params[3] = highCut - lowCut; // bandwidth
+    if (filters.size() <= chan)
+        return;
+
+    ChannelFilter* filter = filters[chan];
+
+    // acquire before releasing, so a design shared with other
+    // channels is never designed twice
+    const BandPassDesign* oldDesign = filter->design;
+    const SingleBandPassDesign* oldSingleDesign = filter->singleDesign;
+    const Dsp::FirBandPass* oldFirDesign = filter->firDesign;
+
+    if (filterType == FIR_FILTER)
+    {
+        Dsp::Params params;
+        params[0] = getSampleRate(); // sample rate
+        params[1] = numFirTaps; // number of taps
+        params[2] = lowCut; // low cut
+        params[3] = highCut; // high cut
+
+        filter->design = 0;
+        filter->singleDesign = 0;
+        filter->firDesign = firDesignCache.acquire(params);
+
+        if (oldFirDesign == 0 || oldFirDesign->getNumTaps() != filter->firDesign->getNumTaps())
+            filter->firDesign->prepareState(filter->firState);
+    }
+    else
+    {
+        Dsp::Params params;
+        params[0] = getSampleRate(); // sample rate
+        params[1] = 2; // order
+        params[2] = (highCut + lowCut)/2; // center frequency
+        params[3] = highCut - lowCut; // bandwidth
+
+        filter->design = designCache.acquire(params);
+        filter->firDesign = 0;
+
+        // the zero-phase filter always runs in double precision
+        if (useSinglePrecision && filterType == IIR_FILTER)
+            filter->singleDesign = singleDesignCache.acquire(params);
+        else
+            filter->singleDesign = 0;
+    }
+
+    designCache.release(oldDesign);
+    singleDesignCache.release(oldSingleDesign);
+    firDesignCache.release(oldFirDesign);
+
+}
+
+void FilterNode::setFilterType(FilterType type, int numTaps)
+{
+
+    filterType = type;
+    numFirTaps = jlimit(3, 8191, numTaps) | 1;
+
+    const int fftSize = Dsp::FirBandPass::getFftSizeForTaps(numFirTaps);
+
+    if (filterType != FIR_FILTER)
+        firFft = nullptr;
+    else if (firFft == nullptr || firFft->getSize() != fftSize)
+        firFft = new Dsp::FFT(fftSize);
+
+    for (int n = 0; n < filters.size(); n++)
+        setFilterParameters(lowCuts[n], highCuts[n], n);
+
+    if (filterType == ZERO_PHASE_FILTER)
+    {
+        prepareZeroPhase();
+    }
+    else
+    {
+        finishZeroPhase();
+        zeroPhasePool = nullptr;
+        zeroPhaseJobs.clear();
+
+        for (int n = 0; n < filters.size(); n++)
+        {
+            filters[n]->forwardChunks.free();
+            filters[n]->zeroPhaseOutput.free();
+        }
+    }
+
+    if (filterType != IIR_FILTER)
+    {
+        std::cout << "FilterNode: using a "
+                  << (filterType == FIR_FILTER ? String(numFirTaps) + "-tap FIR" : String("zero-phase"))
+                  << " filter, delay of " << getGroupDelay() << " samples." << std::endl;
+    }
+
+}
+
+int FilterNode::getGroupDelay()
+{
+
+    if (filterType == FIR_FILTER)
+    {
+        // the delay depends only on the number of taps
+        const int fftSize = Dsp::FirBandPass::getFftSizeForTaps(numFirTaps);
+
+        return (fftSize - numFirTaps + 1) + (numFirTaps - 1) / 2;
+    }
+    else if (filterType == ZERO_PHASE_FILTER)
+    {
+        return 3 * zeroPhaseChunkSize;
+    }
+
+    return 0;
+
+}
+
+void FilterNode::prepareZeroPhase()
+{
+
+    finishZeroPhase();
+
+    // the backward pass runs over one chunk of look-ahead before it reaches
+    // the chunk it outputs, so the look-ahead has to outlast the transient of
+    // the lowest low cut: 20 of its time constants keep the output within
+    // about 1e-7 of the peak of zeroPhaseFilter() over the whole signal
+    double lowestCut = getSampleRate() / 2;
+
+    for (int n = 0; n < lowCuts.size(); n++)
+        lowestCut = jmin(lowestCut, lowCuts[n]);
+
+    const double seconds = jlimit(0.5, 10.0, 20.0 / (2.0 * double_Pi * lowestCut));
+
+    zeroPhaseChunkSize = jmax(1024, int(seconds * getSampleRate()));
+    zeroPhaseFill = 0;
+    zeroPhaseChunk = 0;
+    zeroPhaseBackwardChunk = 0;
+    zeroPhaseStarted = false;
+
+    for (int n = 0; n < filters.size(); n++)
+    {
+        filters[n]->forwardChunks.calloc(3 * zeroPhaseChunkSize);
+        filters[n]->zeroPhaseOutput.calloc(2 * zeroPhaseChunkSize);
+    }
+
+    const int numJobs = jlimit(1, jmax(1, filters.size()), SystemStats::getNumCpus());
+
+    if (zeroPhasePool == nullptr || zeroPhaseJobs.size() != numJobs)
+    {
+        zeroPhasePool = new ThreadPool(numJobs);
+        zeroPhaseJobs.clear();
+
+        for (int i = 0; i < numJobs; i++)
+            zeroPhaseJobs.add(new ZeroPhaseJob(this, i, numJobs));
+    }
+
+}
+
+void FilterNode::processZeroPhase(AudioSampleBuffer& buffer, int nSamples)
+{
+
+    const int chunkSize = zeroPhaseChunkSize;
+    const int numChannels = jmin(getNumOutputs(), filters.size());
+
+    if (!zeroPhaseStarted && nSamples > 0)
+    {
+        // start the forward passes as if the first sample had always been there
+        for (int n = 0; n < numChannels; n++)
+        {
+            ChannelFilter* filter = filters[n];
+
+            if (filter->design != nullptr)
+                filter->state.setSteadyState(*buffer.getSampleData(n), *filter->design);
+        }
+
+        zeroPhaseStarted = true;
+    }
+
+    int done = 0;
+
+    while (done < nSamples)
+    {
+        const int count = jmin(nSamples - done, chunkSize - zeroPhaseFill);
+
+        for (int n = 0; n < numChannels; n++)
+        {
+            ChannelFilter* filter = filters[n];
+
+            if (filter->design == nullptr || filter->forwardChunks == nullptr)
+                continue;
+
+            float* data = buffer.getSampleData(n, done);
+            float* forward = filter->forwardChunks + (zeroPhaseChunk % 3) * chunkSize + zeroPhaseFill;
+            const float* output = filter->zeroPhaseOutput + ((zeroPhaseChunk + 1) % 2) * chunkSize + zeroPhaseFill;
+
+            for (int i = 0; i < count; i++)
+            {
+                forward[i] = filter->state.process(data[i], *filter->design);
+                data[i] = output[i];
+            }
+        }
+
+        zeroPhaseFill += count;
+        done += count;
+
+        if (zeroPhaseFill == chunkSize)
+        {
+            // the previous backward passes have had a whole chunk of real time,
+            // so this only waits if the machine can't keep up at all
+            finishZeroPhase();
+
+            zeroPhaseBackwardChunk = zeroPhaseChunk;
+
+            for (int i = 0; i < zeroPhaseJobs.size(); i++)
+                zeroPhasePool->addJob(zeroPhaseJobs[i], false);
+
+            zeroPhaseChunk = (zeroPhaseChunk + 1) % 6;
+            zeroPhaseFill = 0;
+        }
+    }
+
+}
+
+void FilterNode::runBackwardPass(int chan)
+{
+
+    ChannelFilter* filter = filters[chan];
+
+    if (filter == nullptr || filter->design == nullptr || filter->forwardChunks == nullptr)
+        return;
+
+    const BandPassDesign& design = *filter->design;
+    const int chunkSize = zeroPhaseChunkSize;
+
+    // the chunk just filled is only look-ahead: by the time the backward
+    // pass reaches the one before it, its start-up transient has died away
+    const int chunk = zeroPhaseBackwardChunk;
+    const float* const lookAhead = filter->forwardChunks + (chunk % 3) * chunkSize;
+    const float* const forward = filter->forwardChunks + ((chunk + 2) % 3) * chunkSize;
+    float* const output = filter->zeroPhaseOutput + ((chunk + 1) % 2) * chunkSize;
+
+    filter->backwardState.setSteadyState(lookAhead[chunkSize - 1], design);
+
+    for (int i = chunkSize; --i >= 0;)
+        filter->backwardState.process(lookAhead[i], design);
+
+    for (int i = chunkSize; --i >= 0;)
+        output[i] = filter->backwardState.process(forward[i], design);
+
+}
+
+void FilterNode::finishZeroPhase()
+{
+
+    if (zeroPhasePool == nullptr)
+        return;
 
-    if (filters.size() > chan)
-        filters[chan]->setParams(params);
+    for (int i = 0; i < zeroPhaseJobs.size(); i++)
+        zeroPhasePool->waitForJobToFinish(zeroPhaseJobs[i], -1);
 
 }
 
 void FilterNode::setParameter(int parameterIndex, float newValue)
 {
 
+    // filter type and length apply to every channel, and may only be
+    // changed while acquisition is stopped
+    if (parameterIndex == 2)
+    {
+        setFilterType(FilterType(jlimit(0, 2, roundFloatToInt(newValue))), numFirTaps);
+        return;
+    }
+    else if (parameterIndex == 3)
+    {
+        setFilterType(filterType, int(newValue));
+        return;
+    }
+    else if (parameterIndex == 4)
+    {
+        useSinglePrecision = newValue > 0.5f;
+
+        // neither state was kept up to date while the other one ran
+        for (int n = 0; n < filters.size(); n++)
+        {
+            filters[n]->state.reset();
+            filters[n]->singleState.reset();
+        }
+
+        setFilterType(filterType, numFirTaps);
+        return;
+    }
+
     if (newValue <= 0.01 || newValue >= 10000.0f)
         return;
 
@@ -209,6 +525,11 @@ void FilterNode::setParameter(int parameterIndex, float newValue)
                         highCuts[currentChannel],
                         currentChannel);
 
+    // the zero-phase chunks follow the lowest low cut, but can't be
+    // reallocated while running; a change made then applies from the next start
+    if (filterType == ZERO_PHASE_FILTER && !acquisitionActive)
+        prepareZeroPhase();
+
 
     // Deprecated code:
     //if (parameterIndex)
@@ -240,11 +561,128 @@ void FilterNode::process(AudioSampleBuffer& buffer,
                          int& nSamples)
 {
 
-    for (int n = 0; n < getNumOutputs(); n++)
+    if (filterType == FIR_FILTER)
+    {
+        for (int n = 0; n < getNumOutputs(); n++)
+        {
+            ChannelFilter* filter = filters[n];
+
+            if (filter != nullptr && filter->firDesign != nullptr)
+                filter->firDesign->process(nSamples, buffer.getSampleData(n), filter->firState, *firFft);
+        }
+
+        offsetTimestamps(midiMessages, getGroupDelay());
+    }
+    else if (filterType == ZERO_PHASE_FILTER)
+    {
+        processZeroPhase(buffer, nSamples);
+
+        offsetTimestamps(midiMessages, getGroupDelay());
+    }
+    else if (useSinglePrecision)
     {
-        float* ptr = buffer.getSampleData(n);
-        filters[n]->process(nSamples, &ptr);
+        processSinglePrecision(buffer, nSamples);
     }
+    else
+    {
+        for (int n = 0; n < getNumOutputs(); n++)
+        {
+            ChannelFilter* filter = filters[n];
+
+            if (filter != nullptr && filter->design != nullptr)
+                filter->design->process(nSamples, buffer.getSampleData(n), filter->state);
+        }
+    }
+
+}
+
+void FilterNode::processSinglePrecision(AudioSampleBuffer& buffer, int nSamples)
+{
+
+    typedef Dsp::TransposedCascade<2> SingleCascade;
+
+    const int numChannels = jmin(getNumOutputs(), filters.size());
+
+    float* dest[4];
+    const SingleCascade* cascades[4];
+    SingleCascade::State* states[4];
+    int numGrouped = 0;
+
+    // channels are filtered four at a time, whatever their cutoffs
+    for (int n = 0; n < numChannels; n++)
+    {
+        ChannelFilter* filter = filters[n];
+
+        if (filter->singleDesign == nullptr)
+            continue;
+
+        dest[numGrouped] = buffer.getSampleData(n);
+        cascades[numGrouped] = filter->singleDesign;
+        states[numGrouped] = &filter->singleState;
+
+        if (++numGrouped == 4)
+        {
+            SingleCascade::processFour(nSamples, dest, cascades, states);
+            numGrouped = 0;
+        }
+    }
+
+    for (int i = 0; i < numGrouped; i++)
+        cascades[i]->process(nSamples, dest[i], *states[i]);
+
+}
+
+void FilterNode::offsetTimestamps(MidiBuffer& events, int64 offset)
+{
+
+    MidiBuffer::Iterator i(events);
+
+    const uint8* dataptr;
+    int numBytes;
+    int samplePosition;
+
+    while (i.getNextEvent(dataptr, numBytes, samplePosition))
+    {
+        if (*dataptr == TIMESTAMP && numBytes >= 12)
+        {
+            int64 timestamp;
+            memcpy(&timestamp, dataptr + 4, 8); // remember to skip first four bytes
+
+            timestamp -= offset;
+
+            // same size, so the event can be rewritten in place
+            memcpy(const_cast<uint8*>(dataptr) + 4, &timestamp, 8);
+        }
+    }
+
+}
+
+bool FilterNode::enable()
+{
+
+    if (filterType == ZERO_PHASE_FILTER)
+        prepareZeroPhase();
+
+    acquisitionActive = true;
+
+    return true;
+
+}
+
+bool FilterNode::disable()
+{
+
+    acquisitionActive = false;
+
+    finishZeroPhase();
+
+    // designs released while running may still have been in use by process()
+    // until now, so this is the first safe point to free them
+    designCache.purge();
+    singleDesignCache.purge();
+    firDesignCache.purge();
+
+    return true;
 
 }
 
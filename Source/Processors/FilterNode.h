@@ -32,7 +32,33 @@
 
   Filters data using a filter from the DSP library.
 
-  The user can select the low- and high-frequency cutoffs.
+  The user can select the low- and high-frequency cutoffs, and whether to
+  use a 2nd-order Butterworth band-pass, a linear-phase FIR band-pass, or
+  the Butterworth run forward and backward for zero phase.
+
+  Channels with the same cutoffs share one filter design (and its coefficients)
+  through a Dsp::DesignCache; each channel only owns its filter state.
+
+  The Butterworth filter can also run in single precision, in Transposed
+  Direct Form II, which filters four channels at a time with SSE. For low
+  cuts from about 30 Hz up, the difference from the double-precision filter
+  is more than 80 dB below the signal, well under the noise floor of any
+  headstage. Lower cuts lose accuracy quickly, so keep LFP bands in double.
+
+  The FIR and zero-phase filters keep spike waveforms undistorted at the
+  cost of a fixed delay (see getGroupDelay()). Timestamps passing through the
+  node are moved back by that delay, so downstream processors still see the
+  time at which each sample was acquired.
+
+  The zero-phase filter works on chunks of 20 time constants of the lowest
+  low cut (half a second for spike bands, 3.2 s for a 1 Hz cut, at most 10 s),
+  which keeps its output within about 1e-7 of the peak of zeroPhaseFilter()
+  run over the whole signal; below a 0.3 Hz cut the error grows, to about
+  0.3% at 0.1 Hz. The chunk length is set when acquisition starts. The
+  backward passes of all channels run in parallel on a thread pool, a chunk
+  behind the audio thread, which doesn't wait for them; the output is
+  delayed by three chunks, so it suits monitoring and reprocessing rather
+  than closed-loop work.
 
   @see GenericProcessor, FilterEditor
 
@@ -59,19 +85,116 @@ public:
     double getLowCutValueForChannel(int chan);
     double getHighCutValueForChannel(int chan);
 
+    enum FilterType
+    {
+        IIR_FILTER = 0,    /**< 2nd-order Butterworth band-pass. */
+        FIR_FILTER,        /**< Linear-phase FIR band-pass. */
+        ZERO_PHASE_FILTER  /**< The Butterworth, forward and backward. */
+    };
+
+    /** Returns the type of filter applied to every channel. */
+    FilterType getFilterType()
+    {
+        return filterType;
+    }
+
+    /** Returns true if the Butterworth filter runs in single precision. */
+    bool isUsingSinglePrecision()
+    {
+        return useSinglePrecision;
+    }
+
+    /** Returns the number of taps of the FIR filter. */
+    int getNumFirTaps()
+    {
+        return numFirTaps;
+    }
+
+    /** Returns the delay added by the FIR or zero-phase filter, in samples,
+        which is also subtracted from timestamps. The Butterworth filter's
+        frequency-dependent delay is neither compensated for nor reported. */
+    int getGroupDelay();
+
     void updateSettings();
 
+    bool enable();
+    bool disable();
+
     void saveCustomChannelParametersToXml(XmlElement* channelInfo, int channelNumber, bool isEventChannel);
 
     void loadCustomChannelParametersFromXml(XmlElement* channelInfo, bool isEventChannel);
 
 private:
 
+    typedef Dsp::Butterworth::Design::BandPass <2> BandPassDesign;
+    typedef BandPassDesign::State <Dsp::DirectFormII> BandPassState;
+
+    typedef Dsp::TransposedDesign <BandPassDesign, 2> SingleBandPassDesign;
+
+    /** The per-channel part of a filter: a pointer to a shared design, and
+        the channel's own history. Only the filter type in use has a design. */
+    struct ChannelFilter
+    {
+        ChannelFilter() : design(0), singleDesign(0), firDesign(0) {}
+
+        const BandPassDesign* design;
+        BandPassState state;
+
+        const SingleBandPassDesign* singleDesign;
+        SingleBandPassDesign::State singleState;
+
+        const Dsp::FirBandPass* firDesign;
+        Dsp::FirBandPass::State firState;
+
+        /** Zero-phase only: the last three chunks after the forward pass,
+            the backward pass state, and the chunk being output alongside the
+            one the backward pass is writing. */
+        HeapBlock<float> forwardChunks;
+        BandPassState backwardState;
+        HeapBlock<float> zeroPhaseOutput;
+    };
+
+    class ZeroPhaseJob;
+
     Array<double> lowCuts, highCuts;
-    OwnedArray<Dsp::Filter> filters;
+    OwnedArray<ChannelFilter> filters;
+
+    Dsp::DesignCache<BandPassDesign> designCache;
+    Dsp::DesignCache<SingleBandPassDesign> singleDesignCache;
+    Dsp::DesignCache<Dsp::FirBandPass> firDesignCache;
+
+    /** The sample rate the channels' filters were designed for. */
+    float designSampleRate;
+
+    /** Scratch space for the FIR convolutions, shared by all channels. */
+    ScopedPointer<Dsp::FFT> firFft;
+
+    FilterType filterType;
+    int numFirTaps;
+    bool useSinglePrecision;
+
+    int zeroPhaseChunkSize;
+    int zeroPhaseFill;
+    int zeroPhaseChunk;           // the chunk being filled, counted modulo 6
+    int zeroPhaseBackwardChunk;   // the look-ahead chunk of the running backward passes
+    bool zeroPhaseStarted;
+    bool acquisitionActive;
+    ScopedPointer<ThreadPool> zeroPhasePool;
+    OwnedArray<ZeroPhaseJob> zeroPhaseJobs;
 
     void setFilterParameters(double, double, int);
 
+    void setFilterType(FilterType type, int numTaps);
+
+    void prepareZeroPhase();
+    void processZeroPhase(AudioSampleBuffer& buffer, int nSamples);
+    void runBackwardPass(int chan);
+    void finishZeroPhase();
+
+    void processSinglePrecision(AudioSampleBuffer& buffer, int nSamples);
+
+    void offsetTimestamps(MidiBuffer& events, int64 offset);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilterNode);
 
 };
@@ -23,11 +23,14 @@
 
 #include "GenericProcessor.h"
 #include "../UI/UIComponent.h"
+#include "AllocationTracker.h"
 
 GenericProcessor::GenericProcessor(const String& name_) : AccessClass(),
     sourceNode(0), destNode(0), isEnabled(true), wasConnected(false),
     nextAvailableChannel(0), saveOrder(-1), loadOrder(-1), currentChannel(-1),
-    name(name_), parametersAsXml(nullptr), paramsWereLoaded(false)
+    name(name_), parametersAsXml(nullptr), paramsWereLoaded(false),
+    settingsDirty(true), settingsVersion(0), outputSettingsHash(0),
+    lastSource(0), lastSourceVersion(0)
 {
 }
 
@@ -160,19 +163,20 @@ int GenericProcessor::getNumSamples(MidiBuffer& events)
 
         //std::cout << getName() << " received " << m << " events." << std::endl;
 
+        // use the raw-data overload: filling in a MidiMessage allocates
+        // for every event longer than four bytes
         MidiBuffer::Iterator i(events);
-        MidiMessage message(0xf4);
 
+        const uint8* dataptr;
+        int numBytes;
         int samplePosition = -5;
 
-        while (i.getNextEvent(message, samplePosition))
+        while (i.getNextEvent(dataptr, numBytes, samplePosition))
         {
 
-            const uint8* dataptr = message.getRawData();
-
             if (*dataptr == BUFFER_SIZE)
             {
-                numRead = message.getTimeStamp();
+                numRead = samplePosition;
             }
         }
     }
@@ -315,6 +319,10 @@ void GenericProcessor::update()
 
     std::cout << getName() << " updating settings." << std::endl;
 
+    // hold on to the last update's Channels, to be reused below
+    OwnedArray<Channel> previousChannels;
+    previousChannels.swapWithArray(channels);
+
     clearSettings();
 
     if (sourceNode != 0)
@@ -324,12 +332,28 @@ void GenericProcessor::update()
         settings.numInputs = settings.numOutputs;
         settings.numOutputs = settings.numInputs;
 
+        channels.ensureStorageAllocated(sourceNode->channels.size());
+
         for (int i = 0; i < sourceNode->channels.size(); i++)
         {
             Channel* sourceChan = sourceNode->channels[i];
-            Channel* ch = new Channel(*sourceChan);
+            Channel* ch;
+
+            if (i < previousChannels.size())
+            {
+                // shares the upstream metadata, so nothing is allocated
+                // unless this processor changes it
+                ch = previousChannels.getUnchecked(i);
+                previousChannels.set(i, nullptr, false);
+                ch->inherit(*sourceChan);
+            }
+            else
+            {
+                ch = new Channel(*sourceChan);
+            }
+
             ch->setProcessor(this);
-            ch->bitVolts = ch->bitVolts*getDefaultBitVolts();
+            ch->setBitVolts(ch->getBitVolts()*getDefaultBitVolts());
             channels.add(ch);
         }
 
@@ -337,8 +361,8 @@ void GenericProcessor::update()
         {
             Channel* sourceChan = sourceNode->eventChannels[i];
             Channel* ch = new Channel(*sourceChan);
-            ch->sampleRate = getDefaultSampleRate();
-            ch->bitVolts = getDefaultBitVolts();
+            ch->setSampleRate(getDefaultSampleRate());
+            ch->setBitVolts(getDefaultBitVolts());
             eventChannels.add(ch);
         }
 
@@ -352,8 +376,8 @@ void GenericProcessor::update()
         for (int i = 0; i < getNumOutputs(); i++)
         {
             Channel* ch = new Channel(this, i);
-            ch->sampleRate = getDefaultSampleRate();
-            ch->bitVolts = getDefaultBitVolts();
+            ch->setSampleRate(getDefaultSampleRate());
+            ch->setBitVolts(getDefaultBitVolts());
 
             channels.add(ch);
         }
@@ -374,10 +398,88 @@ void GenericProcessor::update()
                          44100.0,         // sampleRate
                          128);            // blockSize
 
+    // only a change in what this processor passes on makes
+    // the processors downstream update again
+    static int64 lastSettingsVersion = 0;
+
+    const int64 hash = hashOutputSettings();
+
+    if (settingsVersion == 0 || hash != outputSettingsHash)
+    {
+        outputSettingsHash = hash;
+        settingsVersion = ++lastSettingsVersion;
+    }
+
+    lastSource = sourceNode;
+    lastSourceVersion = (sourceNode != 0) ? sourceNode->settingsVersion : 0;
+    settingsDirty = false;
+
     editor->update(); // update editor settings
 
 }
 
+bool GenericProcessor::settingsNeedUpdate()
+{
+
+    if (settingsDirty || sourceNode == 0 || isMerger())
+        return true;
+
+    return sourceNode != lastSource || sourceNode->settingsVersion != lastSourceVersion;
+
+}
+
+static void addToHash(uint64& hash, int64 value)
+{
+    // FNV-1a, a whole value at a time
+    hash = (hash ^ uint64(value)) * 1099511628211ULL;
+}
+
+static void addToHash(uint64& hash, float value)
+{
+    int32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    addToHash(hash, int64(bits));
+}
+
+int64 GenericProcessor::hashOutputSettings()
+{
+
+    uint64 hash = 14695981039346656037ULL;
+
+    addToHash(hash, int64(settings.numOutputs));
+    addToHash(hash, settings.sampleRate);
+    addToHash(hash, int64(pointer_sized_int(settings.originalSource)));
+
+    addToHash(hash, int64(channels.size()));
+
+    for (int i = 0; i < channels.size(); i++)
+    {
+        const Channel* ch = channels[i];
+
+        addToHash(hash, ch->getName().hashCode64());
+        addToHash(hash, ch->getSampleRate());
+        addToHash(hash, ch->getBitVolts());
+        addToHash(hash, int64(ch->num));
+        addToHash(hash, int64(ch->isEnabled));
+    }
+
+    addToHash(hash, int64(eventChannels.size()));
+
+    for (int i = 0; i < eventChannels.size(); i++)
+    {
+        const Channel* ch = eventChannels[i];
+
+        addToHash(hash, ch->getName().hashCode64());
+        addToHash(hash, int64(ch->getEventType()));
+        addToHash(hash, int64(ch->isEventChannel()));
+        addToHash(hash, int64(ch->num));
+    }
+
+    return int64(hash);
+
+}
+
 // bool GenericProcessor::recordStatus(int chan)
 // {
 
@@ -436,18 +538,19 @@ int GenericProcessor::checkForEvents(MidiBuffer& midiMessages)
         // int m = midiMessages.getNumEvents();
         //std::cout << m << " events received by node " << getNodeId() << std::endl;
 
+        // use the raw-data overload: filling in a MidiMessage allocates
+        // for every event longer than four bytes, such as spikes
         MidiBuffer::Iterator i(midiMessages);
-        MidiMessage message(0xf4);
+        const uint8* dataptr;
+        int numBytes;
 
         int samplePosition = 0;
         i.setNextSamplePosition(samplePosition);
 
-        while (i.getNextEvent(message, samplePosition))
+        while (i.getNextEvent(dataptr, numBytes, samplePosition))
         {
 
-            const uint8* dataptr = message.getRawData();
-
-            handleEvent(*dataptr, message, samplePosition);
+            handleEvent(*dataptr, dataptr, numBytes, samplePosition);
 
         }
 
@@ -465,13 +568,15 @@ void GenericProcessor::addEvent(MidiBuffer& eventBuffer,
                                 uint8 numBytes,
                                 uint8* eventData)
 {
-    uint8* data = new uint8[4+numBytes];
+    // MidiBuffer copies the event, so the data can live on the stack
+    uint8 data[4 + 255];
 
     data[0] = type;    // event type
     data[1] = nodeId;  // processor ID automatically added
     data[2] = eventId; // event ID
     data[3] = eventChannel; // event channel
-    memcpy(data + 4, eventData, numBytes);
+    if (numBytes > 0)
+        memcpy(data + 4, eventData, numBytes);
 
 
     //std::cout << 4 + numBytes << std::endl;
@@ -495,6 +600,10 @@ void GenericProcessor::addEvent(MidiBuffer& eventBuffer,
 void GenericProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& eventBuffer)
 {
 
+    AllocationTracker::ScopedProcessor allocationScope(this);
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+
     int nSamples = getNumSamples(eventBuffer); // removes first value from midimessages
 
     process(buffer, eventBuffer, nSamples);
@@ -502,6 +611,16 @@ void GenericProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& event
     setNumSamples(eventBuffer, nSamples); // adds it back,
     // even if it's unchanged
 
+    // the time between callbacks is the budget for the whole signal chain;
+    // AudioProcessor::getSampleRate() is the device rate set by the graph
+    const double deviceSampleRate = AudioProcessor::getSampleRate();
+    int64 budgetTicks = 0;
+
+    if (deviceSampleRate > 0)
+        budgetTicks = Time::secondsToHighResolutionTicks(buffer.getNumSamples() / deviceSampleRate);
+
+    statistics.addBlock(Time::getHighResolutionTicks() - startTicks, budgetTicks);
+
 }
 
 
@@ -648,6 +767,9 @@ void GenericProcessor::loadFromXml()
 
     paramsWereLoaded = true;
 
+    // the loaded parameters may change what this processor passes on
+    markSettingsDirty();
+
 }
 
 void GenericProcessor::loadChannelParametersFromXml(XmlElement* channelInfo, bool isEventChannel)
@@ -28,6 +28,7 @@
 #include "../../JuceLibraryCode/JuceHeader.h"
 #include "Editors/GenericEditor.h"
 #include "Parameter.h"
+#include "ProcessorStatistics.h"
 #include "../AccessClass.h"
 
 #include <time.h>
@@ -455,8 +456,9 @@ public:
 
     /** Makes it easier for processors to respond to incoming events, such as TTLs and spikes.
 
-    Called by checkForEvents(). */
-    virtual void handleEvent(int eventType, MidiMessage& event, int samplePosition = 0) {}
+    Called by checkForEvents() with the event's raw bytes, which are only valid
+    for the duration of the call. */
+    virtual void handleEvent(int eventType, const uint8* eventData, int numBytes, int samplePosition = 0) {}
 
     enum eventTypes
     {
@@ -466,7 +468,8 @@ public:
         TTL = 3,
         SPIKE = 4,
         EEG = 5,
-        CONTINUOUS = 6
+        CONTINUOUS = 6,
+        DATA_LOSS = 7
     };
 
     enum eventChannelTypes
@@ -528,6 +531,18 @@ public:
     /** Default method for updating settings, called by every processor.*/
     virtual void update();
 
+    /** Returns true if update() has to run again: if the processor is new or
+    has been marked dirty, or if its source, or the source's output settings,
+    have changed since its last update. Sources and mergers always return true.*/
+    bool settingsNeedUpdate();
+
+    /** Makes the next update pass include this processor, for settings that
+    are changed outside of update() (e.g. by setParameter()).*/
+    void markSettingsDirty()
+    {
+        settingsDirty = true;
+    }
+
     /** Custom method for updating settings, called automatically by update().*/
     virtual void updateSettings() {}
 
@@ -573,6 +588,12 @@ public:
     /** Holds loaded parameters */
     XmlElement* parametersAsXml;
 
+    /** Returns the timing statistics accumulated by processBlock(). */
+    ProcessorStatistics& getStatistics()
+    {
+        return statistics;
+    }
+
 private:
 
     /** Automatically extracts the number of samples in the buffer, then
@@ -595,6 +616,25 @@ private:
 
     bool paramsWereLoaded;
 
+    /** Time spent inside process(), updated on every callback. */
+    ProcessorStatistics statistics;
+
+    /** Returns a hash of everything a downstream processor inherits in update().*/
+    int64 hashOutputSettings();
+
+    bool settingsDirty;
+
+    /** Changes whenever an update() changes the output settings; unique
+    across processors, so that a recycled pointer can't be mistaken for
+    an old source.*/
+    int64 settingsVersion;
+
+    int64 outputSettingsHash;
+
+    /** The source and its settingsVersion at the last update().*/
+    GenericProcessor* lastSource;
+    int64 lastSourceVersion;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GenericProcessor);
 
 };
@@ -119,16 +119,16 @@ void LfpTriggeredAverageNode::setParameter(int parameterIndex, float newValue)
         ed->canvas->setParameter(parameterIndex, newValue);
 }
 
-void LfpTriggeredAverageNode::handleEvent(int eventType, MidiMessage& event, int sampleNum)
+void LfpTriggeredAverageNode::handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum)
 {
     if (eventType == TTL)
     {
-        const uint8* dataptr = event.getRawData();
+        const uint8* dataptr = eventData;
 
         // int eventNodeId = *(dataptr+1);
         int eventId = *(dataptr+2);
         int eventChannel = *(dataptr+3);
-        int eventTime = event.getTimeStamp();
+        int eventTime = sampleNum;
 
         int samplesLeft = totalSamples - eventTime;
 
@@ -190,14 +190,14 @@ void LfpTriggeredAverageNode::handleEvent(int eventType, MidiMessage& event, int
         // std::cout << "Received event from " << eventNodeId <<
         //              " on channel " << eventChannel <<
         //             " with value " << eventId <<
-        //             " at timestamp " << event.getTimeStamp() << std::endl;
+        //             " at timestamp " << sampleNum << std::endl;
 
 
     }
     else if (eventType == TIMESTAMP)
     {
 
-        const uint8* dataptr = event.getRawData();
+        const uint8* dataptr = eventData;
 
         // int eventNodeId = *(dataptr+1);
         // int eventId = *(dataptr+2);
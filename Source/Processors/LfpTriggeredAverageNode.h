@@ -63,7 +63,7 @@ public:
     bool enable();
     bool disable();
 
-    void handleEvent(int, MidiMessage&, int);
+    void handleEvent(int, const uint8*, int, int);
 
     AudioSampleBuffer* getDisplayBufferAddress()
     {
@@ -0,0 +1,293 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include "LineNoiseFilter.h"
+#include "Editors/LineNoiseFilterEditor.h"
+
+/** Measures the line frequency from the upward zero crossings of a
+    reference channel, after two passes of a narrow band-pass around the
+    nominal frequency, interpolating each crossing between samples. */
+class LineNoiseFilter::FrequencyTracker
+{
+public:
+    FrequencyTracker() : sampleRate(0), nominal(0)
+    {
+        reset();
+    }
+
+    void setup(double sampleRate_, double nominal_)
+    {
+        sampleRate = sampleRate_;
+        nominal = nominal_;
+
+        bandPass.setup(sampleRate, nominal, 5.0); // Q of 5
+
+        reset();
+    }
+
+    void reset()
+    {
+        firstState.reset();
+        secondState.reset();
+
+        previous = 0;
+        position = 0;
+        firstCrossing = -1;
+        lastCrossing = -1;
+        numCycles = 0;
+    }
+
+    /** Feeds a block of the reference channel. Returns true, and sets
+        frequency, each time about a second's worth of cycles has been
+        timed, if the result is within 2 Hz of the nominal frequency. */
+    bool process(const float* data, int numSamples, double& frequency)
+    {
+        if (sampleRate <= 0)
+            return false;
+
+        // leave the band-pass a fifth of a second to settle
+        const double settled = sampleRate / 5;
+
+        bool measured = false;
+
+        for (int i = 0; i < numSamples; i++)
+        {
+            const double x = secondState.process(firstState.process(double(data[i]), bandPass),
+                                                 bandPass);
+
+            if (previous < 0 && x >= 0 && position > settled)
+            {
+                const double crossing = position - 1 + previous / (previous - x);
+
+                if (firstCrossing < 0)
+                    firstCrossing = crossing;
+                else
+                    numCycles++;
+
+                lastCrossing = crossing;
+
+                if (numCycles >= int(nominal))
+                {
+                    const double estimate = numCycles * sampleRate / (lastCrossing - firstCrossing);
+
+                    if (fabs(estimate - nominal) < 2.0)
+                    {
+                        frequency = estimate;
+                        measured = true;
+                    }
+
+                    firstCrossing = lastCrossing;
+                    numCycles = 0;
+                }
+            }
+
+            previous = x;
+            position += 1;
+        }
+
+        return measured;
+    }
+
+    double getNominalFrequency()
+    {
+        return nominal;
+    }
+
+private:
+    double sampleRate;
+    double nominal;
+
+    Dsp::RBJ::BandPass2 bandPass;
+    Dsp::BiquadBase::State<Dsp::DirectFormII> firstState;
+    Dsp::BiquadBase::State<Dsp::DirectFormII> secondState;
+
+    double previous;
+    double position;
+    double firstCrossing;
+    double lastCrossing;
+    int numCycles;
+};
+
+LineNoiseFilter::LineNoiseFilter()
+    : GenericProcessor("Line Noise Filter"), lineFrequency(60.0), numHarmonics(3),
+      notchWidth(2.0), referenceChannel(-1), notchFrequency(60.0), needsRedesign(false)
+{
+
+    tracker = new FrequencyTracker();
+
+}
+
+LineNoiseFilter::~LineNoiseFilter()
+{
+
+}
+
+AudioProcessorEditor* LineNoiseFilter::createEditor()
+{
+    editor = new LineNoiseFilterEditor(this, true);
+
+    std::cout << "Creating editor." << std::endl;
+
+    return editor;
+}
+
+void LineNoiseFilter::updateSettings()
+{
+
+    while (states.size() < getNumInputs())
+        states.add(new NotchCascade::State());
+
+    states.removeLast(states.size() - getNumInputs());
+
+    // the sample rate may have changed
+    if (getSampleRate() > 0)
+        designNotches(notchFrequency);
+
+}
+
+bool LineNoiseFilter::enable()
+{
+
+    for (int n = 0; n < states.size(); n++)
+        states[n]->reset();
+
+    notchFrequency = lineFrequency;
+    tracker->setup(getSampleRate(), lineFrequency);
+
+    designNotches(notchFrequency);
+    needsRedesign = false;
+
+    return true;
+
+}
+
+void LineNoiseFilter::designNotches(double frequency)
+{
+
+    const double sampleRate = getSampleRate();
+
+    notchFrequency = frequency;
+    notches.clear();
+
+    for (int h = 1; h <= numHarmonics; h++)
+    {
+        const double centre = h * frequency;
+
+        // notches too close to Nyquist would be far wider than asked for
+        if (centre >= 0.45 * sampleRate)
+            break;
+
+        Dsp::RBJ::BandStop notch;
+        notch.setup(sampleRate, centre, centre / notchWidth); // width sets the Q
+
+        notches.setStage(h - 1, notch);
+    }
+
+}
+
+void LineNoiseFilter::setParameter(int parameterIndex, float newValue)
+{
+
+    if (parameterIndex == 0)
+    {
+        if (newValue < 1.0f || newValue > 1000.0f)
+            return;
+
+        lineFrequency = newValue;
+    }
+    else if (parameterIndex == 1)
+    {
+        numHarmonics = jlimit(1, int(MAX_HARMONICS), roundFloatToInt(newValue));
+    }
+    else if (parameterIndex == 2)
+    {
+        if (newValue <= 0.0f)
+            return;
+
+        notchWidth = newValue;
+    }
+    else if (parameterIndex == 3)
+    {
+        referenceChannel = roundFloatToInt(newValue);
+    }
+
+    std::cout << "Line noise filter: " << lineFrequency << " Hz and "
+              << numHarmonics - 1 << " harmonics, " << notchWidth << " Hz wide, "
+              << (referenceChannel < 0 ? String("not tracked") :
+                  "tracked on channel " + String(referenceChannel + 1)) << std::endl;
+
+    // applied at the start of the next block; enable() designs afresh anyway
+    needsRedesign = true;
+
+}
+
+void LineNoiseFilter::process(AudioSampleBuffer& buffer,
+                              MidiBuffer& midiMessages,
+                              int& nSamples)
+{
+
+    if (needsRedesign)
+    {
+        needsRedesign = false;
+
+        if (tracker->getNominalFrequency() != lineFrequency)
+            notchFrequency = lineFrequency;
+
+        tracker->setup(getSampleRate(), lineFrequency);
+        designNotches(notchFrequency);
+    }
+
+    const int numChannels = jmin(getNumOutputs(), states.size());
+
+    if (referenceChannel >= 0 && referenceChannel < numChannels)
+    {
+        double measured;
+
+        // measured on the raw reference, before it is notched
+        if (tracker->process(buffer.getSampleData(referenceChannel), nSamples, measured))
+        {
+            const double frequency = notchFrequency + 0.5 * (measured - notchFrequency);
+
+            if (fabs(frequency - notchFrequency) > 0.005)
+                designNotches(frequency);
+        }
+    }
+
+    const NotchCascade* cascades[2] = { &notches, &notches };
+
+    int chan = 0;
+
+    for (; chan + 2 <= numChannels; chan += 2)
+    {
+        float* dest[2] = { buffer.getSampleData(chan), buffer.getSampleData(chan + 1) };
+        NotchCascade::State* pair[2] = { states[chan], states[chan + 1] };
+
+        NotchCascade::processTwo(nSamples, dest, cascades, pair);
+    }
+
+    if (chan < numChannels)
+        notches.process(nSamples, buffer.getSampleData(chan), *states[chan]);
+
+}
@@ -0,0 +1,115 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __LINENOISEFILTER_H_4C1E9A27__
+#define __LINENOISEFILTER_H_4C1E9A27__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+#include "../Dsp/Dsp.h"
+#include "GenericProcessor.h"
+
+/**
+
+  Removes mains interference: a notch at the line frequency and at each of
+  its first few harmonics, all in one pass over each channel.
+
+  The notches are RBJ band-stop biquads, cascaded in a single
+  Dsp::TransposedCascade that every channel shares, and channels are
+  filtered two at a time in SSE2 registers. They run in double precision,
+  since a notch a few Hz wide at 50 Hz puts its poles too close to the unit
+  circle for single precision to hold the notch on frequency.
+
+  Mains frequency drifts by a few hundredths of a Hz. If a reference
+  channel is chosen, the line frequency is measured on it about once a
+  second (from the zero crossings of a narrow band-pass around the nominal
+  frequency) and the notches follow it, within 2 Hz of the nominal value.
+
+  Parameters: 0 = line frequency (Hz), 1 = number of harmonics, counting the
+  fundamental, 2 = notch width (Hz), 3 = reference channel (-1 for none).
+
+  @see GenericProcessor, LineNoiseFilterEditor
+
+*/
+
+class LineNoiseFilter : public GenericProcessor
+
+{
+public:
+
+    LineNoiseFilter();
+    ~LineNoiseFilter();
+
+    void process(AudioSampleBuffer& buffer, MidiBuffer& midiMessages, int& nSamples);
+    void setParameter(int parameterIndex, float newValue);
+
+    AudioProcessorEditor* createEditor();
+
+    bool hasEditor() const
+    {
+        return true;
+    }
+
+    void updateSettings();
+
+    bool enable();
+
+    /** Returns the frequency the notches are currently tuned to, which
+        differs from the nominal line frequency while it is being tracked. */
+    double getNotchFrequency()
+    {
+        return notchFrequency;
+    }
+
+    enum { MAX_HARMONICS = 8 };
+
+private:
+
+    typedef Dsp::TransposedCascade<MAX_HARMONICS, double> NotchCascade;
+
+    class FrequencyTracker;
+
+    /** Tunes the notches to a new fundamental. While acquisition runs,
+        this is only ever called on the audio thread. */
+    void designNotches(double frequency);
+
+    NotchCascade notches;
+    OwnedArray<NotchCascade::State> states;
+
+    ScopedPointer<FrequencyTracker> tracker;
+
+    double lineFrequency;
+    int numHarmonics;
+    double notchWidth;
+    int referenceChannel;
+
+    double notchFrequency;
+
+    /** Set when a parameter changes; the notches are redesigned at the
+        start of the next block, on the audio thread. */
+    bool needsRedesign;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LineNoiseFilter);
+
+};
+
+#endif  // __LINENOISEFILTER_H_4C1E9A27__
@@ -22,13 +22,233 @@
 */
 
 #include <stdio.h>
+#include <math.h>
 #include "PhaseDetector.h"
 #include "Editors/PhaseDetectorEditor.h"
 
+/** Forecasts the selected channel with an autoregressive model, to find
+    its next peak before it arrives. The channel is box-car averaged down
+    to about 25 samples per cycle of the fastest rhythm expected, a model
+    is fitted (Burg's method) to the last HISTORY_LENGTH of those, and the
+    recursion is run forward from the newest sample. */
+class PhaseDetector::PhasePredictor
+{
+public:
+    PhasePredictor() : factor(1)
+    {
+        history.calloc(HISTORY_LENGTH);
+        coefficients.calloc(MODEL_ORDER + 1);
+        forward.calloc(HISTORY_LENGTH);
+        backward.calloc(HISTORY_LENGTH);
+        forecast.calloc(MODEL_ORDER + MAX_FORECAST + 1);
+
+        reset();
+    }
+
+    void setup(double sampleRate, double maxFrequency)
+    {
+        factor = jmax(1, int(sampleRate / (25.0 * maxFrequency)));
+
+        reset();
+    }
+
+    void reset()
+    {
+        boxSum = 0;
+        boxCount = 0;
+        newest = 0;
+        numDecimated = 0;
+        newestTime = 0;
+    }
+
+    int getFactor() const
+    {
+        return factor;
+    }
+
+    /** Feeds a block; firstSample is the absolute index of data[0]. */
+    void addBlock(const float* data, int numSamples, int64 firstSample)
+    {
+        for (int i = 0; i < numSamples; i++)
+        {
+            boxSum += data[i];
+
+            if (++boxCount == factor)
+            {
+                newest = (newest + 1) % HISTORY_LENGTH;
+                history[newest] = boxSum / factor;
+                numDecimated++;
+
+                // a box stands for the sample at its centre
+                newestTime = double(firstSample + i) - (factor - 1) / 2.0;
+
+                boxSum = 0;
+                boxCount = 0;
+            }
+        }
+    }
+
+    /** Returns the absolute (fractional) sample of the first forecast
+        peak, or trough, between earliest and latest; -1 if there is none. */
+    double predict(double earliest, double latest, bool trough)
+    {
+        if (numDecimated < HISTORY_LENGTH || latest < newestTime)
+            return -1;
+
+        // oldest first, without its mean
+        double mean = 0;
+
+        for (int i = 0; i < HISTORY_LENGTH; i++)
+        {
+            forward[i] = history[(newest + 1 + i) % HISTORY_LENGTH];
+            mean += forward[i];
+        }
+
+        mean /= HISTORY_LENGTH;
+
+        for (int i = 0; i < HISTORY_LENGTH; i++)
+            forward[i] -= mean;
+
+        // the forecast runs on from the newest MODEL_ORDER boxes
+        for (int i = 0; i < MODEL_ORDER; i++)
+            forecast[i] = forward[HISTORY_LENGTH - MODEL_ORDER + i];
+
+        if (!fitModel())
+            return -1;
+
+        const int numSteps = jmin((int) MAX_FORECAST, int((latest - newestTime) / factor) + 2);
+        const double sign = trough ? -1.0 : 1.0;
+
+        for (int n = MODEL_ORDER; n < MODEL_ORDER + numSteps; n++)
+        {
+            double sum = 0;
+
+            for (int k = 1; k <= MODEL_ORDER; k++)
+                sum -= coefficients[k] * forecast[n - k];
+
+            forecast[n] = sum;
+        }
+
+        // forecast[MODEL_ORDER - 1] is the newest box
+        for (int n = MODEL_ORDER - 1; n < MODEL_ORDER + numSteps - 1; n++)
+        {
+            const double y0 = sign * forecast[n - 1];
+            const double y1 = sign * forecast[n];
+            const double y2 = sign * forecast[n + 1];
+
+            if (y1 > y0 && y1 >= y2 && y1 > 0)
+            {
+                // fit a parabola through the three to place the peak between boxes
+                const double curvature = y0 - 2 * y1 + y2;
+                const double offset = (curvature < 0) ? 0.5 * (y0 - y2) / curvature : 0;
+
+                const double time = newestTime + (n - (MODEL_ORDER - 1) + offset) * factor;
+
+                if (time > latest)
+                    return -1;
+
+                if (time >= earliest)
+                    return time;
+            }
+        }
+
+        return -1;
+    }
+
+private:
+
+    /** Burg's method, on forward[], which it overwrites along with backward[]. */
+    bool fitModel()
+    {
+        const int n = HISTORY_LENGTH;
+
+        double denominator = 0;
+
+        for (int i = 0; i < n; i++)
+        {
+            backward[i] = forward[i];
+            denominator += 2 * forward[i] * forward[i];
+        }
+
+        denominator -= forward[0] * forward[0] + forward[n - 1] * forward[n - 1];
+
+        if (denominator <= 1e-20)
+            return false;
+
+        coefficients[0] = 1;
+
+        for (int k = 1; k <= MODEL_ORDER; k++)
+            coefficients[k] = 0;
+
+        for (int k = 0; k < MODEL_ORDER; k++)
+        {
+            double mu = 0;
+
+            for (int i = 0; i < n - k - 1; i++)
+                mu += forward[i + k + 1] * backward[i];
+
+            mu *= -2 / denominator;
+
+            for (int i = 0; i <= (k + 1) / 2; i++)
+            {
+                const double a = coefficients[i] + mu * coefficients[k + 1 - i];
+                const double b = coefficients[k + 1 - i] + mu * coefficients[i];
+
+                coefficients[i] = a;
+                coefficients[k + 1 - i] = b;
+            }
+
+            for (int i = 0; i < n - k - 1; i++)
+            {
+                const double f = forward[i + k + 1] + mu * backward[i];
+                const double b = backward[i] + mu * forward[i + k + 1];
+
+                forward[i + k + 1] = f;
+                backward[i] = b;
+            }
+
+            denominator = (1 - mu * mu) * denominator
+                          - forward[k + 1] * forward[k + 1]
+                          - backward[n - k - 2] * backward[n - k - 2];
+
+            if (denominator <= 1e-20)
+                break;
+        }
+
+        return true;
+    }
+
+    enum
+    {
+        HISTORY_LENGTH = 256,
+        MODEL_ORDER = 20,
+        MAX_FORECAST = 256
+    };
+
+    int factor;
+
+    double boxSum;
+    int boxCount;
+
+    HeapBlock<double> history;
+    int newest;
+    int64 numDecimated;
+    double newestTime;
+
+    HeapBlock<double> coefficients;
+    HeapBlock<double> forward;
+    HeapBlock<double> backward;
+    HeapBlock<double> forecast;
+};
+
+/** Length of the TTL pulse, in samples. */
+#define PULSE_LENGTH 500
+
 PhaseDetector::PhaseDetector()
     : GenericProcessor("Phase Detector"),
       maxFrequency(20), isIncreasing(true), canBeTriggered(false), selectedChannel(-1),
-      triggerOnPeak(true)
+      triggerOnPeak(true), mode(DETECT), samplesProcessed(0), scheduledSample(-1),
+      pulseOffSample(-1), numPhaseErrors(0), phaseErrorCos(0), phaseErrorSin(0)
 
 {
 
@@ -36,13 +256,15 @@ PhaseDetector::PhaseDetector()
 
     randomNumberGenerator.setSeed(Time::currentTimeMillis());
 
+    predictor = new PhasePredictor();
+
     //parameters.add(Parameter("thresh", 0.0, 500.0, 200.0, 0));
 
 }
 
 PhaseDetector::~PhaseDetector()
 {
-
+    delete[] peakIntervals;
 }
 
 AudioProcessorEditor* PhaseDetector::createEditor()
@@ -64,6 +286,11 @@ void PhaseDetector::setParameter(int parameterIndex, float newValue)
     {
         selectedChannel = (int) newValue;
     }
+    else if (parameterIndex == 2)
+    {
+        mode = (newValue < 0.5f) ? DETECT : PREDICT;
+        scheduledSample = -1;
+    }
 
 }
 
@@ -72,6 +299,8 @@ void PhaseDetector::updateSettings()
 
     minSamplesToNextPeak = int(getSampleRate()/maxFrequency);
 
+    predictor->setup(getSampleRate(), maxFrequency);
+
 }
 
 bool PhaseDetector::enable()
@@ -80,11 +309,52 @@ bool PhaseDetector::enable()
     lastSample = 0.0f;
     isIncreasing = false;
     numPeakIntervals = 0;
+    estimatedFrequency = 0;
+
+    predictor->reset();
+
+    samplesProcessed = 0;
+    scheduledSample = -1;
+    pulseOffSample = -1;
+
+    lastEventSample = -1;
+    lastPeakSample = -1;
+    lastEventMatched = true;
+    lastPeakMatched = true;
+
+    numPhaseErrors = 0;
+    phaseErrorCos = 0;
+    phaseErrorSin = 0;
+
+    for (int i = 0; i < NUM_ERROR_BINS; i++)
+        phaseErrorHistogram[i] = 0;
 
     return true;
 }
 
-void PhaseDetector::handleEvent(int eventType, MidiMessage& event, int sampleNum)
+bool PhaseDetector::disable()
+{
+    if (numPhaseErrors > 0)
+    {
+        std::cout << "Phase detector: " << numPhaseErrors << " events, mean phase error "
+                  << getPhaseErrorMean() << " deg, spread " << getPhaseErrorSpread()
+                  << " deg." << std::endl;
+
+        const int degreesPerBin = 360 / NUM_ERROR_BINS;
+
+        for (int i = 0; i < NUM_ERROR_BINS; i++)
+        {
+            if (phaseErrorHistogram[i] > 0)
+                std::cout << "  " << (i * degreesPerBin - 180) << " to "
+                          << ((i + 1) * degreesPerBin - 180) << " deg: "
+                          << phaseErrorHistogram[i] << std::endl;
+        }
+    }
+
+    return true;
+}
+
+void PhaseDetector::handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum)
 {
     // MOVED GATING TO PULSE PAL OUTPUT!
     // now use to randomize phase for next trial
@@ -93,12 +363,12 @@ void PhaseDetector::handleEvent(int eventType, MidiMessage& event, int sampleNum
 
     if (eventType == TTL)
     {
-        const uint8* dataptr = event.getRawData();
+        const uint8* dataptr = eventData;
 
         // int eventNodeId = *(dataptr+1);
         int eventId = *(dataptr+2);
         int eventChannel = *(dataptr+3);
-        //int eventTime = event.getTimeStamp();
+        //int eventTime = sampleNum;
 
         //     //	std::cout << "Received event from " << eventNodeId << ", channel "
         //     //          << eventChannel << ", with ID " << eventId << std::endl;
@@ -124,9 +394,36 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
 
     checkForEvents(events);
 
+    const int64 blockStart = samplesProcessed;
+    const int64 blockEnd = samplesProcessed + nSamples;
+
+    samplesProcessed = blockEnd;
+
     if (selectedChannel >= 0 && selectedChannel < buffer.getNumChannels())
     {
 
+        if (mode == PREDICT)
+        {
+            // scheduled at the end of an earlier buffer, so never before this one
+            if (scheduledSample >= 0 && scheduledSample < blockEnd)
+            {
+                const int64 eventSample = jmax(blockStart, int64(scheduledSample + 0.5));
+
+                addEvent(events, TTL, int(eventSample - blockStart), 1, 3);
+
+                matchEvent(eventSample);
+
+                pulseOffSample = eventSample + PULSE_LENGTH;
+                scheduledSample = -1;
+            }
+
+            if (pulseOffSample >= blockStart && pulseOffSample < blockEnd)
+            {
+                addEvent(events, TTL, int(pulseOffSample - blockStart), 0, 3);
+                pulseOffSample = -1;
+            }
+        }
+
         for (int i = 0; i < nSamples; i++)
         {
 
@@ -149,15 +446,20 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
 
                 numPeakIntervals++;
 
+                // the previous sample was the peak (or trough)
+                matchPeak(blockStart + i - 1);
 
                 //std::cout << "GOT EVENT." << std::endl;
 
                 // entering falling phase (just reached peak or trough)
-                //if (true)
-                addEvent(events, TTL, i, 1, 3);
+                if (mode == DETECT)
+                {
+                    addEvent(events, TTL, i, 1, 3);
+                    matchEvent(blockStart + i);
+                }
 
 
-                peakIntervals[numPeakIntervals % NUM_INTERVALS] = nSamplesSinceLastPeak;
+                peakIntervals[(numPeakIntervals - 1) % NUM_INTERVALS] = nSamplesSinceLastPeak;
 
                 isIncreasing = false;
 
@@ -172,7 +474,7 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
                 // either rising or falling
                 nSamplesSinceLastPeak++;
 
-                if (nSamplesSinceLastPeak == 500)
+                if (nSamplesSinceLastPeak == PULSE_LENGTH && mode == DETECT)
                 {
                     addEvent(events, TTL, i, 0, 3);
                 }
@@ -182,6 +484,17 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
             lastSample = sample;
 
         }
+
+        if (mode == PREDICT)
+        {
+            predictor->addBlock(buffer.getSampleData(selectedChannel), nSamples, blockStart);
+
+            // look up to four cycles of the fastest rhythm ahead
+            const double earliest = double(jmax(blockEnd, lastEventSample + minSamplesToNextPeak));
+            const double latest = double(blockEnd + 4 * minSamplesToNextPeak);
+
+            scheduledSample = predictor->predict(earliest, latest, !triggerOnPeak);
+        }
     }
 
 
@@ -205,3 +518,62 @@ void PhaseDetector::estimateFrequency()
 
 }
 
+void PhaseDetector::matchEvent(int64 eventSample)
+{
+    lastEventSample = eventSample;
+    lastEventMatched = false;
+
+    if (!lastPeakMatched)
+        addPhaseError(eventSample - lastPeakSample);
+}
+
+void PhaseDetector::matchPeak(int64 peakSample)
+{
+    lastPeakSample = peakSample;
+    lastPeakMatched = false;
+
+    if (!lastEventMatched)
+        addPhaseError(lastEventSample - peakSample);
+}
+
+void PhaseDetector::addPhaseError(int64 samplesLate)
+{
+    if (estimatedFrequency <= 0)
+        return;
+
+    const double degrees = 360.0 * double(samplesLate) * estimatedFrequency / getSampleRate();
+
+    // further apart than half a cycle: not the same peak
+    if (fabs(degrees) >= 180.0)
+        return;
+
+    lastEventMatched = true;
+    lastPeakMatched = true;
+
+    numPhaseErrors++;
+    phaseErrorCos += cos(degrees * double_Pi / 180.0);
+    phaseErrorSin += sin(degrees * double_Pi / 180.0);
+
+    const int bin = int((degrees + 180.0) * NUM_ERROR_BINS / 360.0);
+    phaseErrorHistogram[jlimit(0, NUM_ERROR_BINS - 1, bin)]++;
+}
+
+float PhaseDetector::getPhaseErrorMean() const
+{
+    if (numPhaseErrors == 0)
+        return 0.0f;
+
+    return float(atan2(phaseErrorSin, phaseErrorCos) * 180.0 / double_Pi);
+}
+
+float PhaseDetector::getPhaseErrorSpread() const
+{
+    if (numPhaseErrors == 0)
+        return 0.0f;
+
+    // circular standard deviation, from the length of the mean vector
+    const double length = sqrt(phaseErrorCos * phaseErrorCos + phaseErrorSin * phaseErrorSin)
+                          / numPhaseErrors;
+
+    return float(sqrt(-2.0 * log(jmax(length, 1e-12))) * 180.0 / double_Pi);
+}
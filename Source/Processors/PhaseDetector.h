@@ -34,6 +34,23 @@
 
   Uses peaks to estimate the phase of a continuous signal.
 
+  In DETECT mode, a TTL event goes out on channel 3 as soon as the
+  selected channel turns over, i.e. one sample after each peak (or
+  trough, when triggerOnPeak is off).
+
+  In PREDICT mode, the channel is forecast with an autoregressive model at
+  the end of each buffer, and the event is scheduled for the sample where
+  the next peak is expected, in whichever later buffer that falls. This is
+  meant for a channel that has already been band-passed around the rhythm
+  of interest.
+
+  Either way, each event is compared with the peak actually detected
+  nearest to it, and the difference, in degrees of the estimated cycle, is
+  gathered into a histogram (see getPhaseErrorMean()). It is printed when
+  acquisition stops.
+
+  Parameters: 1 = channel (-1 for none), 2 = mode.
+
   @see GenericProcessor, PhaseDetectorEditor
 
 */
@@ -57,11 +74,37 @@ public:
     }
 
     bool enable();
+    bool disable();
 
     void updateSettings();
 
+    enum Mode
+    {
+        DETECT = 0,   /**< Trigger once a peak has passed. */
+        PREDICT       /**< Trigger at the forecast time of the next peak. */
+    };
+
+    /** Number of events matched with a detected peak since acquisition started. */
+    int getNumPhaseErrors() const
+    {
+        return numPhaseErrors;
+    }
+
+    /** Circular mean of the phase errors, in degrees; positive means late. */
+    float getPhaseErrorMean() const;
+
+    /** Circular standard deviation of the phase errors, in degrees. */
+    float getPhaseErrorSpread() const;
+
+    enum
+    {
+        NUM_ERROR_BINS = 36 /**< The histogram covers -180 to 180 degrees. */
+    };
+
 private:
 
+    class PhasePredictor;
+
     float lastPeak;
     float maxFrequency;
     float lastSample;
@@ -72,7 +115,7 @@ private:
 
     bool canBeTriggered;
 
-    void handleEvent(int eventType, MidiMessage& event, int sampleNum);
+    void handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum);
 
     float estimatedFrequency;
 
@@ -88,6 +131,30 @@ private:
 
     void estimateFrequency();
 
+    Mode mode;
+
+    ScopedPointer<PhasePredictor> predictor;
+
+    int64 samplesProcessed;
+    double scheduledSample;
+    int64 pulseOffSample;
+
+    /** Records a trigger, or a detected peak, and pairs it with the
+        latest of the other kind if they are within half a cycle. */
+    void matchEvent(int64 eventSample);
+    void matchPeak(int64 peakSample);
+    void addPhaseError(int64 samplesLate);
+
+    int64 lastEventSample;
+    int64 lastPeakSample;
+    bool lastEventMatched;
+    bool lastPeakMatched;
+
+    int numPhaseErrors;
+    double phaseErrorCos;
+    double phaseErrorSin;
+    int phaseErrorHistogram[NUM_ERROR_BINS];
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PhaseDetector);
 
 };
@@ -29,8 +29,11 @@
 #include "LfpDisplayNode.h"
 #include "LfpTriggeredAverageNode.h"
 #include "SpikeDisplayNode.h"
+#include "SpectrumNode.h"
 #include "EventNode.h"
 #include "FilterNode.h"
+#include "LineNoiseFilter.h"
+#include "BandPowerNode.h"
 #include "GenericProcessor.h"
 #include "RecordNode.h"
 #include "ResamplingNode.h"
@@ -53,7 +56,7 @@
 #include "../UI/UIComponent.h"
 #include "../UI/EditorViewport.h"
 
-ProcessorGraph::ProcessorGraph() : currentNodeId(100)
+ProcessorGraph::ProcessorGraph() : currentNodeId(100), statisticsVisible(false)
 {
 
     // The ProcessorGraph will always have 0 inputs (all content is generated within graph)
@@ -126,7 +129,21 @@ void* ProcessorGraph::createNewProcessor(String& description)//,
 // GenericProcessor* dest)
 {
 
-    GenericProcessor* processor = createProcessorFromDescription(description);
+    GenericProcessor* processor = 0;
+
+    const int preparedIndex = preparedDescriptions.indexOf(description);
+
+    if (preparedIndex >= 0)
+    {
+        std::cout << "Using the prepared " << description << "." << std::endl;
+
+        processor = preparedProcessors.removeAndReturn(preparedIndex);
+        preparedDescriptions.remove(preparedIndex);
+    }
+    else
+    {
+        processor = createProcessorFromDescription(description);
+    }
 
     int id = currentNodeId++;
 
@@ -140,7 +157,10 @@ void* ProcessorGraph::createNewProcessor(String& description)//,
 
         addNode(processor,id); // have to add it so it can be deleted by the graph
 
-        return processor->createEditor();
+        GenericEditor* editor = (GenericEditor*) processor->createEditor();
+        editor->setStatisticsVisible(statisticsVisible);
+
+        return editor;
 
     }
     else
@@ -153,6 +173,22 @@ void* ProcessorGraph::createNewProcessor(String& description)//,
 
 }
 
+void ProcessorGraph::addPreparedProcessor(const String& description, GenericProcessor* processor)
+{
+
+    preparedDescriptions.add(description);
+    preparedProcessors.add(processor);
+
+}
+
+void ProcessorGraph::clearPreparedProcessors()
+{
+
+    preparedDescriptions.clear();
+    preparedProcessors.clear();
+
+}
+
 void ProcessorGraph::clearSignalChain()
 {
 
@@ -479,6 +515,16 @@ GenericProcessor* ProcessorGraph::createProcessorFromDescription(String& descrip
             processor = new FilterNode();
 
         }
+        else if (subProcessorType.equalsIgnoreCase("Line Noise Filter"))
+        {
+            std::cout << "Creating a new line noise filter." << std::endl;
+            processor = new LineNoiseFilter();
+        }
+        else if (subProcessorType.equalsIgnoreCase("Band Power"))
+        {
+            std::cout << "Creating a new band power node." << std::endl;
+            processor = new BandPowerNode();
+        }
         else if (subProcessorType.equalsIgnoreCase("Resampler"))
         {
             std::cout << "Creating a new resampler." << std::endl;
@@ -562,6 +608,11 @@ GenericProcessor* ProcessorGraph::createProcessorFromDescription(String& descrip
         {
             std::cout << "Creating an LfpTrigAvgNode." << std::endl;
             processor = new LfpTriggeredAverageNode();
+        }
+        else if (subProcessorType.equalsIgnoreCase("Spectrum Viewer"))
+        {
+            std::cout << "Creating a SpectrumNode." << std::endl;
+            processor = new SpectrumNode();
         }                   
         
         else if (subProcessorType.equalsIgnoreCase("Spike Viewer"))
@@ -666,6 +717,7 @@ bool ProcessorGraph::enableProcessors()
         if (node->nodeId != OUTPUT_NODE_ID)
         {
             GenericProcessor* p = (GenericProcessor*) node->getProcessor();
+            p->getStatistics().reset();
             p->enableEditor();
             p->enable();
         }
@@ -743,6 +795,57 @@ void ProcessorGraph::setRecordState(bool isRecording)
 }
 
 
+void ProcessorGraph::setStatisticsVisible(bool t)
+{
+
+    statisticsVisible = t;
+
+    for (int i = 0; i < getNumNodes(); i++)
+    {
+        Node* node = getNode(i);
+
+        int nodeId = node->nodeId;
+
+        if (nodeId != OUTPUT_NODE_ID &&
+            nodeId != AUDIO_NODE_ID &&
+            nodeId != RECORD_NODE_ID &&
+            nodeId != RESAMPLING_NODE_ID)
+        {
+            GenericProcessor* p =(GenericProcessor*) node->getProcessor();
+            p->getEditor()->setStatisticsVisible(t);
+        }
+    }
+
+}
+
+String ProcessorGraph::saveStatistics(File file)
+{
+
+    String csv;
+
+    csv << "NodeId,Name," << ProcessorStatistics::getCsvHeader() << "\n";
+
+    for (int i = 0; i < getNumNodes(); i++)
+    {
+        Node* node = getNode(i);
+
+        if (node->nodeId != OUTPUT_NODE_ID)
+        {
+            GenericProcessor* p = (GenericProcessor*) node->getProcessor();
+
+            csv << String(node->nodeId) << ","
+                << p->getName().replaceCharacter(',', ' ') << ","
+                << ProcessorStatistics::toCsvRow(p->getStatistics().getSummary()) << "\n";
+        }
+    }
+
+    if (file.replaceWithText(csv))
+        return "Saved processor statistics to " + file.getFileName();
+    else
+        return "Could not write " + file.getFileName();
+
+}
+
 AudioNode* ProcessorGraph::getAudioNode()
 {
 
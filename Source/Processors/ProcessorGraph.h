@@ -60,6 +60,14 @@ public:
     void* createNewProcessor(String& description);
     GenericProcessor* createProcessorFromDescription(String& description);
 
+    /** Hands over a processor that was constructed ahead of time (e.g. by
+        the ConfigurationLoader, off the message thread); the next
+        createNewProcessor() call with the same description uses it. */
+    void addPreparedProcessor(const String& description, GenericProcessor* processor);
+
+    /** Deletes any prepared processors that were not used. */
+    void clearPreparedProcessors();
+
     void removeProcessor(GenericProcessor* processor);
 
     void clearSignalChain();
@@ -83,10 +91,27 @@ public:
     
     void setRecordState(bool);
 
+    /** Shows or hides the timing overlay on every processor's editor. */
+    void setStatisticsVisible(bool);
+
+    /** Returns true if the timing overlay is currently shown. */
+    bool areStatisticsVisible()
+    {
+        return statisticsVisible;
+    }
+
+    /** Writes the timing statistics of every processor to a CSV file. */
+    String saveStatistics(File file);
+
 private:
 
     int currentNodeId;
 
+    bool statisticsVisible;
+
+    OwnedArray<GenericProcessor> preparedProcessors;
+    StringArray preparedDescriptions;
+
     enum nodeIds
     {
         RECORD_NODE_ID = 900,
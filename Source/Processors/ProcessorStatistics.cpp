@@ -0,0 +1,187 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "ProcessorStatistics.h"
+
+ProcessorStatistics::ProcessorStatistics()
+{
+    clear();
+}
+
+void ProcessorStatistics::reset()
+{
+    resetRequested.set(1);
+}
+
+void ProcessorStatistics::clear()
+{
+    numBlocks.set(0);
+    numOverruns.set(0);
+    totalTicks.set(0);
+    totalBudgetTicks.set(0);
+    minTicks.set(0);
+    maxTicks.set(0);
+    numAllocations.set(0);
+
+    for (int i = 0; i < NUM_BINS; i++)
+        histogram[i].set(0);
+
+    resetRequested.set(0);
+}
+
+void ProcessorStatistics::addBlock(int64 elapsedTicks, int64 budgetTicks)
+{
+
+    if (resetRequested.get() != 0)
+        clear();
+
+    if (elapsedTicks < 0)
+        elapsedTicks = 0;
+
+    // only the audio thread writes, so plain get/set pairs are sufficient
+    const int64 n = numBlocks.get();
+
+    if (n == 0 || elapsedTicks < minTicks.get())
+        minTicks.set(elapsedTicks);
+
+    if (elapsedTicks > maxTicks.get())
+        maxTicks.set(elapsedTicks);
+
+    totalTicks.set(totalTicks.get() + elapsedTicks);
+    totalBudgetTicks.set(totalBudgetTicks.get() + budgetTicks);
+
+    if (budgetTicks > 0 && elapsedTicks > budgetTicks)
+        numOverruns.set(numOverruns.get() + 1);
+
+    Atomic<int>& bin = histogram[getBinForTicks(elapsedTicks)];
+    bin.set(bin.get() + 1);
+
+    numBlocks.set(n + 1);
+
+}
+
+int64 ProcessorStatistics::addAllocation()
+{
+
+    if (resetRequested.get() != 0 || numBlocks.get() < WARMUP_BLOCKS)
+        return 0;
+
+    const int64 n = numAllocations.get() + 1;
+    numAllocations.set(n);
+
+    return n;
+
+}
+
+ProcessorStatistics::Summary ProcessorStatistics::getSummary() const
+{
+    Summary s;
+
+    s.numBlocks = numBlocks.get();
+    s.numOverruns = numOverruns.get();
+    s.numAllocations = numAllocations.get();
+    s.minMs = s.meanMs = s.p99Ms = s.maxMs = s.budgetFraction = 0.0;
+
+    if (s.numBlocks == 0)
+        return s;
+
+    const double msPerTick = 1000.0 / double(Time::getHighResolutionTicksPerSecond());
+
+    const int64 total = totalTicks.get();
+    const int64 budget = totalBudgetTicks.get();
+    const int64 lo = minTicks.get();
+    const int64 hi = maxTicks.get();
+
+    s.minMs = lo * msPerTick;
+    s.maxMs = hi * msPerTick;
+    s.meanMs = (total * msPerTick) / double(s.numBlocks);
+
+    if (budget > 0)
+        s.budgetFraction = double(total) / double(budget);
+
+    // the histogram may be a few blocks ahead of numBlocks; that's fine for an estimate
+    const int64 target = (int64) ceil(0.99 * double(s.numBlocks));
+    int64 count = 0;
+
+    for (int i = 0; i < NUM_BINS; i++)
+    {
+        count += histogram[i].get();
+
+        if (count >= target)
+        {
+            const int64 ticks = jlimit(lo, hi, getTicksForBin(i));
+            s.p99Ms = ticks * msPerTick;
+            break;
+        }
+    }
+
+    return s;
+}
+
+int ProcessorStatistics::getBinForTicks(int64 ticks)
+{
+    if (ticks < BINS_PER_OCTAVE)
+        return (int) ticks;
+
+    int highestBit = 0;
+
+    for (int64 t = ticks; t > 1; t >>= 1)
+        highestBit++;
+
+    const int mantissa = (int)(ticks >> (highestBit - 3)) & (BINS_PER_OCTAVE - 1);
+
+    return jmin((highestBit - 2) * BINS_PER_OCTAVE + mantissa, (int) NUM_BINS - 1);
+}
+
+int64 ProcessorStatistics::getTicksForBin(int bin)
+{
+    if (bin < BINS_PER_OCTAVE)
+        return bin;
+
+    const int highestBit = bin / BINS_PER_OCTAVE + 2;
+    const int mantissa = bin % BINS_PER_OCTAVE;
+
+    // upper edge of the bin, so the percentile errs on the pessimistic side
+    return ((int64)(BINS_PER_OCTAVE + mantissa + 1) << (highestBit - 3)) - 1;
+}
+
+String ProcessorStatistics::getCsvHeader()
+{
+    return "Blocks,MinMs,MeanMs,P99Ms,MaxMs,BudgetPercent,Overruns,Allocations";
+}
+
+String ProcessorStatistics::toCsvRow(const Summary& s)
+{
+    String row;
+
+    row << String(s.numBlocks) << ","
+        << String(s.minMs, 4) << ","
+        << String(s.meanMs, 4) << ","
+        << String(s.p99Ms, 4) << ","
+        << String(s.maxMs, 4) << ","
+        << String(s.budgetFraction * 100.0, 2) << ","
+        << String(s.numOverruns) << ","
+        << String(s.numAllocations);
+
+    return row;
+}
@@ -0,0 +1,131 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __PROCESSORSTATISTICS_H_3C7A91E4__
+#define __PROCESSORSTATISTICS_H_3C7A91E4__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+/**
+
+  Accumulates timing statistics for a processor's process() method.
+
+  Every GenericProcessor owns one of these. The audio thread calls addBlock()
+  once per callback with the number of high-resolution ticks spent inside
+  process() and the number of ticks available for the whole callback. All
+  counters are written by that single thread and read through atomics, so the
+  message thread can call getSummary() at any time without taking a lock.
+
+  Percentiles are estimated from a logarithmic histogram with eight bins per
+  octave, so they are accurate to roughly 10%.
+
+  @see GenericProcessor, GenericEditor
+
+*/
+
+class ProcessorStatistics
+{
+public:
+
+    /** Constructor.*/
+    ProcessorStatistics();
+
+    /** Destructor.*/
+    ~ProcessorStatistics() {}
+
+    /** Blocks after a reset during which allocations are not counted, so that
+        buffers can be sized on the first callbacks.*/
+    enum { WARMUP_BLOCKS = 10 };
+
+    /** Records the time spent processing one block. Must only be called from the audio thread.*/
+    void addBlock(int64 elapsedTicks, int64 budgetTicks);
+
+    /** Counts a heap allocation made on the audio thread while this processor
+        was running (see AllocationTracker). Allocations during the first
+        WARMUP_BLOCKS blocks after a reset are expected and ignored. Returns the
+        number counted so far, or 0 if this one was ignored. Audio thread only.*/
+    int64 addAllocation();
+
+    /** Requests that all counters be cleared. The audio thread performs the
+        reset at the start of the next block, so this is safe to call at any time.*/
+    void reset();
+
+    /** A snapshot of the accumulated statistics, in milliseconds.*/
+    struct Summary
+    {
+        int64 numBlocks;
+        int64 numOverruns;
+
+        double minMs;
+        double meanMs;
+        double p99Ms;
+        double maxMs;
+
+        /** Mean fraction of the callback budget spent inside process(). */
+        double budgetFraction;
+
+        /** Heap allocations after warm-up; always zero unless built with
+            OPEN_EPHYS_TRACK_ALLOCATIONS. */
+        int64 numAllocations;
+    };
+
+    /** Returns the current statistics. Safe to call from any thread.*/
+    Summary getSummary() const;
+
+    /** Returns the column names written by toCsvRow(). */
+    static String getCsvHeader();
+
+    /** Formats a summary as a single comma-separated row (without a newline). */
+    static String toCsvRow(const Summary& s);
+
+private:
+
+    enum
+    {
+        BINS_PER_OCTAVE = 8,
+        NUM_BINS = 64 * BINS_PER_OCTAVE
+    };
+
+    static int getBinForTicks(int64 ticks);
+    static int64 getTicksForBin(int bin);
+
+    void clear();
+
+    Atomic<int64> numBlocks;
+    Atomic<int64> numOverruns;
+    Atomic<int64> totalTicks;
+    Atomic<int64> totalBudgetTicks;
+    Atomic<int64> minTicks;
+    Atomic<int64> maxTicks;
+    Atomic<int64> numAllocations;
+
+    Atomic<int> resetRequested;
+
+    Atomic<int> histogram[NUM_BINS];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProcessorStatistics);
+
+};
+
+
+#endif  // __PROCESSORSTATISTICS_H_3C7A91E4__
@@ -56,13 +56,13 @@ AudioProcessorEditor* PulsePalOutput::createEditor()
     return editor;
 }
 
-void PulsePalOutput::handleEvent(int eventType, MidiMessage& event, int sampleNum)
+void PulsePalOutput::handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum)
 {
     if (eventType == TTL)
     {
         //  std::cout << "Received an event!" << std::endl;
 
-        const uint8* dataptr = event.getRawData();
+        const uint8* dataptr = eventData;
 
         // int eventNodeId = *(dataptr+1);
         int eventId = *(dataptr+2);
@@ -43,7 +43,10 @@ RecordNode::RecordNode()
     settings.numOutputs = 0;
 
     eventChannel = new Channel(this, 0);
-    eventChannel->isEventChannel = true;
+    eventChannel->setEventChannel(true);
+
+    dataLossChannel = new Channel(this, 0);
+    dataLossChannel->setEventChannel(true);
 
     recordMarker = new char[10];
     for (int i = 0; i < 9; i++)
@@ -140,7 +143,7 @@ void RecordNode::filenameComponentChanged(FilenameComponent* fnc)
 void RecordNode::addInputChannel(GenericProcessor* sourceNode, int chan)
 {
 
-    if (chan != getProcessorGraph()->midiChannelIndex)
+    if (chan != AudioProcessorGraph::midiChannelIndex)
     {
 
         int channelIndex = getNextChannel(false);
@@ -189,13 +192,17 @@ void RecordNode::updateFileName(Channel* ch)
     String filename = rootFolder.getFullPathName();
     filename += rootFolder.separatorString;
 
-    if (!ch->isEventChannel)
+    if (!ch->isEventChannel())
     {
         filename += ch->nodeId;
         filename += "_";
-        filename += ch->name;
+        filename += ch->getName();
         filename += ".continuous";
     }
+    else if (ch == dataLossChannel)
+    {
+        filename += "all_channels.data_loss";
+    }
     else
     {
         filename += "all_channels.events";
@@ -215,6 +222,7 @@ void RecordNode::createNewDirectory()
     rootFolder = File(dataDirectory.getFullPathName() + File::separator + generateDirectoryName());
 
     updateFileName(eventChannel);
+    updateFileName(dataLossChannel);
 
     for (int i = 0; i < channelPointers.size(); i++)
     {
@@ -237,7 +245,13 @@ String RecordNode::generateDirectoryName()
     t.add(calendar.getMinutes());
     t.add(calendar.getSeconds());
 
-    String filename = getControlPanel()->getTextToPrepend();
+    // the ControlPanel adds the user's prefix and suffix, when there is one
+    ControlPanel* controlPanel = getControlPanel();
+
+    String filename;
+
+    if (controlPanel != 0)
+        filename = controlPanel->getTextToPrepend();
 
     String datestring = "";
 
@@ -254,10 +268,13 @@ String RecordNode::generateDirectoryName()
             datestring += "-";
     }
 
-    getControlPanel()->setDateText(datestring);
-
     filename += datestring;
-    filename += getControlPanel()->getTextToAppend();
+
+    if (controlPanel != 0)
+    {
+        controlPanel->setDateText(datestring);
+        filename += controlPanel->getTextToAppend();
+    }
 
     return filename;
 
@@ -307,10 +324,13 @@ void RecordNode::setParameter(int parameterIndex, float newValue)
         {
             rootFolder.createDirectory();
             String settingsFileName = rootFolder.getFullPathName() + File::separator + "settings.xml";
-            getEditorViewport()->saveState(File(settingsFileName));
+
+            if (getEditorViewport() != 0)
+                getEditorViewport()->saveState(File(settingsFileName));
         }
 
         openFile(eventChannel);
+        openFile(dataLossChannel);
 
         sampleCount = 0; // reset sample count
 
@@ -450,7 +470,11 @@ String RecordNode::generateHeader(Channel* ch)
     header += String(HEADER_SIZE);
     header += ";\n";
 
-    if (ch->isEventChannel)
+    if (ch == dataLossChannel)
+    {
+        header += "header.description = 'each record contains one 64-bit timestamp, one 16-bit sample position, one uint8 processor ID, one uint8 event ID (0 = buffer overflow, 1 = timestamp gap), and one int64 count of lost samples. Each record matches a record with event type 7 in all_channels.events'; \n";
+    }
+    else if (ch->isEventChannel())
     {
         header += "header.description = 'each record contains one 64-bit timestamp, one 16-bit sample position, one uint8 event type, one uint8 processor ID, one uint8 event ID, and one uint8 event channel'; \n";
 
@@ -466,10 +490,16 @@ String RecordNode::generateHeader(Channel* ch)
     header += "';\n";
 
     header += "header.channel = '";
-    header += ch->name;
+    header += ch->getName();
     header += "';\n";
 
-    if (ch->isEventChannel)
+    if (ch == dataLossChannel)
+    {
+
+        header += "header.channelType = 'DataLoss';\n";
+
+    }
+    else if (ch->isEventChannel())
     {
 
         header += "header.channelType = 'Event';\n";
@@ -482,7 +512,7 @@ String RecordNode::generateHeader(Channel* ch)
     }
 
     header += "header.sampleRate = ";
-    header += String(channelPointers[0]->sampleRate); // all channels need to have the
+    header += String(channelPointers[0]->getSampleRate()); // all channels need to have the
     // same sample rate under the current
     // scheme
     header += ";\n";
@@ -491,7 +521,7 @@ String RecordNode::generateHeader(Channel* ch)
     header += ";\n";
 
     header += "header.bitVolts = ";
-    header += String(ch->bitVolts);
+    header += String(ch->getBitVolts());
     header += ";\n";
 
     header = header.paddedRight(' ', HEADER_SIZE);
@@ -521,6 +551,7 @@ void RecordNode::closeAllFiles()
     }
 
     closeFile(eventChannel);
+    closeFile(dataLossChannel);
 }
 
 bool RecordNode::enable()
@@ -556,7 +587,7 @@ void RecordNode::writeContinuousBuffer(float* data, int nSamples, int channel)
         return;
 
     // scale the data back into the range of int16
-    float scaleFactor =  float(0x7fff) * channelPointers[channel]->bitVolts;
+    float scaleFactor =  float(0x7fff) * channelPointers[channel]->getBitVolts();
     for (int n = 0; n < nSamples; n++)
     {
         *(continuousDataFloatBuffer+n) = *(data+n) / scaleFactor;
@@ -621,12 +652,12 @@ void RecordNode::writeRecordMarker(FILE* file)
     diskWriteLock.exit();
 }
 
-void RecordNode::writeEventBuffer(MidiMessage& event, int samplePosition) //, int node, int channel)
+void RecordNode::writeEventBuffer(const uint8* eventData, int numBytes, int samplePosition) //, int node, int channel)
 {
     // find file and write samples to disk
     //std::cout << "Received event!" << std::endl;
 
-    const uint8* dataptr = event.getRawData();
+    const uint8* dataptr = eventData;
     uint64 samplePos = (uint64) samplePosition;
 
     uint64 eventTimestamp = timestamp + samplePos;
@@ -645,19 +676,35 @@ void RecordNode::writeEventBuffer(MidiMessage& event, int samplePosition) //, in
 
     // write 1st four bytes of event (type, nodeId, eventId, eventChannel)
     fwrite(dataptr, 1, 4, eventChannel->file);
+
+    // data loss events carry the number of samples lost, which goes in its own
+    // file so that every record in the events file stays the same size
+    if (*dataptr == DATA_LOSS)
+    {
+        int64 numLost = 0;
+
+        if (numBytes >= 12)
+            memcpy(&numLost, dataptr + 4, 8);
+
+        fwrite(&eventTimestamp, 8, 1, dataLossChannel->file);
+        fwrite(&samplePos, 2, 1, dataLossChannel->file);
+        fwrite(dataptr + 1, 1, 2, dataLossChannel->file); // nodeId, eventId
+        fwrite(&numLost, 8, 1, dataLossChannel->file);
+    }
+
     diskWriteLock.exit();
 
 }
 
-void RecordNode::handleEvent(int eventType, MidiMessage& event, int samplePosition)
+void RecordNode::handleEvent(int eventType, const uint8* eventData, int numBytes, int samplePosition)
 {
-    if (eventType == TTL)
+    if (eventType == TTL || eventType == DATA_LOSS)
     {
-        writeEventBuffer(event, samplePosition);
+        writeEventBuffer(eventData, numBytes, samplePosition);
     }
     else if (eventType == TIMESTAMP)
     {
-        const uint8* dataptr = event.getRawData();
+        const uint8* dataptr = eventData;
 
         // std::cout << (int) *(dataptr + 11) << " " <<
         //             (int) *(dataptr + 10) << " " <<
@@ -183,18 +183,22 @@ private:
     void updateFileName(Channel* ch);
 
     /** Cycle through the event buffer, looking for data to save */
-    void handleEvent(int eventType, MidiMessage& event, int samplePos);
+    void handleEvent(int eventType, const uint8* eventData, int numBytes, int samplePos);
 
     /** Object for holding information about the events file */
     Channel* eventChannel;
 
+    /** Object for holding information about the data loss file, which has
+        the number of samples lost for each data loss event */
+    Channel* dataLossChannel;
+
     /** Method for writing continuous buffers to disk.
     */
     void writeContinuousBuffer(float* data, int nSamples, int channel);
 
     /** Method for writing event buffers to disk.
     */
-    void writeEventBuffer(MidiMessage& event, int samplePos);
+    void writeEventBuffer(const uint8* eventData, int numBytes, int samplePos);
 
     void writeRecordMarker(FILE*);
     void writeTimestampAndSampleCount(FILE*);
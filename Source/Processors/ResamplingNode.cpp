@@ -71,11 +71,14 @@ void ResamplingNode::setParameter(int parameterIndex, float newValue)
 
         for (int i = 0; i < channels.size(); i++)
         {
-            channels[i]->sampleRate = targetSampleRate;
+            channels[i]->setSampleRate(targetSampleRate);
         }
 
         updateFilter();
 
+        // the new rate reaches the processors downstream at the next update
+        markSettingsDirty();
+
         //std::cout << "Got parameter update." << std::endl;
     }
 
@@ -108,7 +111,7 @@ void ResamplingNode::updateSettings()
 
     for (int i = 0; i < channels.size(); i++)
     {
-        channels[i]->sampleRate = targetSampleRate;
+        channels[i]->setSampleRate(targetSampleRate);
     }
 
     updateFilter();
@@ -227,9 +230,14 @@ void ResamplingNode::process(AudioSampleBuffer& buffer,
 
     }
 
-    // copy the tempBuffer back into the original buffer
-    buffer = AudioSampleBuffer(tempBuffer->getArrayOfChannels(), 2, tempBufferPos);//buffer.getNumSamples());
+    // copy the tempBuffer back into the original buffer; assigning a new
+    // buffer to it would reallocate, and the graph would never see the result
+    const int numResampled = jmin(tempBufferPos, buffer.getNumSamples());
+    const int numChannels = jmin(buffer.getNumChannels(), tempBuffer->getNumChannels());
+
+    for (int channel = 0; channel < numChannels; channel++)
+        buffer.copyFrom(channel, 0, *tempBuffer, channel, 0, numResampled);
 
-    nSamples = valuesNeeded;
+    nSamples = numResampled;
 
 }
@@ -31,6 +31,17 @@
 #define copysign(x,y) _copysign(x,y)
 #endif
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SIGNALGENERATOR_USE_SSE 1
+#include <xmmintrin.h>
+#else
+#define SIGNALGENERATOR_USE_SSE 0
+#endif
+
+#define NOISE_TABLE_SIZE 65536
+#define SPIKE_DURATION_MS 3.0
+#define NUM_SPIKE_TEMPLATES 5
+
 SignalGenerator::SignalGenerator()
     : GenericProcessor("Signal Generator"),
       nOut(5), defaultFrequency(10.0), defaultAmplitude(0.5f),
@@ -40,6 +51,24 @@ SignalGenerator::SignalGenerator()
     parameters.add(Parameter("Frequency", 0.01, 10000.0, 10, 1, true));
     parameters.add(Parameter("Phase", -double_Pi, double_Pi, 0, 2, true));
     parameters.add(Parameter("Waveform Type", waveformParameter, 0, 3, true));
+    parameters.add(Parameter("Noise", 0.0f, 500.0f, 5.0f, 4, true));
+
+    // the same noise every time, so that benchmarks are repeatable
+    Random random(12345);
+
+    noiseTable.malloc(NOISE_TABLE_SIZE);
+
+    for (int i = 0; i < NOISE_TABLE_SIZE; i += 2)
+    {
+        // Box-Muller
+        const double radius = std::sqrt(-2.0 * std::log(1.0 - random.nextDouble()));
+        const double angle = 2.0 * double_Pi * random.nextDouble();
+
+        noiseTable[i] = float(radius * std::cos(angle));
+        noiseTable[i + 1] = float(radius * std::sin(angle));
+    }
+
+    templateLength = 0;
 }
 
 
@@ -75,10 +104,17 @@ void SignalGenerator::updateSettings()
         phase.add(0);
         phasePerSample.add(double_Pi * 2.0 / (getSampleRate() / frequency.getLast()));
         currentPhase.add(0);
+        noiseLevel.add(5.0);
     }
 
+    while (probes.size() < getNumOutputs())
+        probes.add(new ProbeState());
+
     sampleRateRatio = getSampleRate() / 44100.0;
 
+    createSpikeTemplates();
+    resetProbes();
+
     std::cout << "Sample rate ratio: " << sampleRateRatio << std::endl;
 
 }
@@ -114,6 +150,11 @@ void SignalGenerator::setParameter(int parameterIndex, float newValue)
             waveformType.set(currentChannel, (int) newValue);
             parameterPointer->setValue(newValue, currentChannel);
         }
+        else if (parameterIndex == 4)
+        {
+            noiseLevel.set(currentChannel, newValue);
+            parameterPointer->setValue(newValue, currentChannel);
+        }
         //updateWaveform(currentChannel);
     }
 
@@ -125,6 +166,8 @@ bool SignalGenerator::enable()
 
     std::cout << "Signal generator received enable signal." << std::endl;
 
+    resetProbes();
+
     // for (int n = 0; n < waveformType.size(); n++)
     // {
     // 	updateWaveform(n);
@@ -190,114 +233,325 @@ void SignalGenerator::process(AudioSampleBuffer& buffer,
 
     nSamps = int((float) buffer.getNumSamples() * sampleRateRatio);
 
-    for (int i = 0; i < nSamps; ++i)
+    const int numChannels = jmin(buffer.getNumChannels(), waveformType.size());
+
+    // sines are generated four channels at a time
+    int sines[4];
+    int numSines = 0;
+
+    for (int j = 0; j < numChannels; j++)
     {
-        for (int j = buffer.getNumChannels(); --j >= 0;)
+        switch (waveformType[j])
         {
+            case SINE:
+                sines[numSines++] = j;
+
+                if (numSines == 4)
+                {
+                    generateSines(buffer, sines, 4, nSamps);
+                    numSines = 0;
+                }
+                break;
+            case SQUARE:
+            case TRIANGLE:
+            case SAW:
+                generateShape(buffer, j, nSamps);
+                break;
+            case NOISE:
+            case SPIKE:
+                generateSpikes(buffer, j, nSamps);
+                break;
+            case PROBE:
+                generateProbe(buffer, j, nSamps);
+                break;
+            default:
+                buffer.clear(j, 0, nSamps);
+        }
+    }
+
+    if (numSines > 0)
+        generateSines(buffer, sines, numSines, nSamps);
+
+}
+
+void SignalGenerator::generateSines(AudioSampleBuffer& buffer, const int* channels,
+                                    int numChannels, int nSamps)
+{
+
+    // each channel is a unit phasor (c, s) turned by (stepCos, stepSin) every sample
+    float c[4], s[4], stepCos[4], stepSin[4], amp[4];
+    float* dest[4];
+
+    for (int k = 0; k < 4; k++)
+    {
+        // pad a partial group with copies of its first channel, which are then not stored
+        const int j = channels[k < numChannels ? k : 0];
+
+        const double startPhase = currentPhase[j] + phase[j];
+
+        c[k] = float(std::cos(startPhase));
+        s[k] = float(std::sin(startPhase));
+        stepCos[k] = float(std::cos(phasePerSample[j]));
+        stepSin[k] = float(std::sin(phasePerSample[j]));
+        amp[k] = float(amplitude[j]);
+        dest[k] = buffer.getSampleData(j);
+    }
 
-            float sample;
+    int i = 0;
 
-            switch (waveformType[j])
+#if SIGNALGENERATOR_USE_SSE
+    if (numChannels == 4)
+    {
+        __m128 vc = _mm_loadu_ps(c);
+        __m128 vs = _mm_loadu_ps(s);
+        const __m128 vStepCos = _mm_loadu_ps(stepCos);
+        const __m128 vStepSin = _mm_loadu_ps(stepSin);
+        const __m128 vAmp = _mm_loadu_ps(amp);
+
+        for (; i + 4 <= nSamps; i += 4)
+        {
+            __m128 out[4];
+
+            for (int t = 0; t < 4; t++)
             {
-                case SINE:
-                    sample = amplitude[j] * (float) std::sin(currentPhase[j] + phase[j]);
-                    break;
-                case SQUARE:
-                    sample = amplitude[j] * copysign(1,std::sin(currentPhase[j] + phase[j]));
-                    break;
-                case TRIANGLE:
-                    sample = amplitude[j] * ((currentPhase[j] + phase[j]) / double_Pi - 1) *
-                             copysign(2,std::sin(currentPhase[j] + phase[j]));
-                    break;
-                case SAW:
-                    sample = amplitude[j] * ((currentPhase[j] + phase[j]) / double_Pi - 1);
-                    break;
-                case NOISE:
-                    // sample = amplitude[j] * (float(rand()) / float(RAND_MAX)-0.5f);
-                    // break;
-                case SPIKE:
-                    sample = generateSpikeSample(amplitude[j], currentPhase[j], phase[j]);
-                    break;
-                default:
-                    sample = 0;
+                out[t] = _mm_mul_ps(vAmp, vs);
+
+                const __m128 nc = _mm_sub_ps(_mm_mul_ps(vc, vStepCos), _mm_mul_ps(vs, vStepSin));
+                vs = _mm_add_ps(_mm_mul_ps(vs, vStepCos), _mm_mul_ps(vc, vStepSin));
+                vc = nc;
             }
 
-            currentPhase.set(j,currentPhase[j] + phasePerSample[j]);
+            // from one vector per sample to one per channel
+            _MM_TRANSPOSE4_PS(out[0], out[1], out[2], out[3]);
+
+            for (int k = 0; k < 4; k++)
+                _mm_storeu_ps(dest[k] + i, out[k]);
+        }
+
+        _mm_storeu_ps(c, vc);
+        _mm_storeu_ps(s, vs);
+    }
+#endif
+
+    for (int k = 0; k < numChannels; k++)
+    {
+        float ck = c[k];
+        float sk = s[k];
 
-            if (currentPhase[j] > double_Pi*2)
-                currentPhase.set(j,0);
+        for (int n = i; n < nSamps; n++)
+        {
+            dest[k][n] = amp[k] * sk;
 
-            // dereference pointer to one of the buffer's samples
-            *buffer.getSampleData(j, i) = sample;
+            const float nc = ck * stepCos[k] - sk * stepSin[k];
+            sk = sk * stepCos[k] + ck * stepSin[k];
+            ck = nc;
         }
     }
 
+    for (int k = 0; k < numChannels; k++)
+    {
+        const int j = channels[k];
 
-    // for (int chan = 0; chan < buffer.getNumChannels(); chan++)
-    // {
+        currentPhase.set(j, std::fmod(currentPhase[j] + nSamps * phasePerSample[j], double_Pi * 2));
+    }
 
-    // 	int dataSize = waveforms[chan].size();
-    // 	int destSample = -dataSize;
-    // 	int lastSample = dataSize;
+}
 
-    // 	while (lastSample < nSamps)
-    // 	{
+void SignalGenerator::generateShape(AudioSampleBuffer& buffer, int chan, int nSamps)
+{
 
-    // 		destSample += dataSize;
+    float* const dest = buffer.getSampleData(chan);
 
-    // 		//std::cout << lastSample << " " << destSample << " " << currentSample[chan] << " " << dataSize << std::endl;
+    const float amp = float(amplitude[chan]);
 
-    // 		// buffer.copyFrom(chan,
-    // 		//  				destSample,
-    // 		//  				waveforms[chan].getRawDataPointer() + currentSample[chan],
-    // 		//  				dataSize - currentSample[chan]);
+    // position within the cycle, from 0 to 1
+    const double startCycle = (currentPhase[chan] + phase[chan]) / (double_Pi * 2);
 
-    // 		lastSample += dataSize;
+    float p = float(startCycle - std::floor(startCycle));
+    const float step = float(phasePerSample[chan] / (double_Pi * 2));
 
-    // 		currentSample.set(chan,0);
+    switch (waveformType[chan])
+    {
+        case SQUARE:
+            for (int i = 0; i < nSamps; i++)
+            {
+                dest[i] = (p < 0.5f) ? amp : -amp;
 
-    // 		//std::cout << "DONE" << std::endl;
-    // 	}
+                p += step;
+                if (p >= 1.0f) p -= 1.0f;
+            }
+            break;
+        case TRIANGLE:
+            for (int i = 0; i < nSamps; i++)
+            {
+                dest[i] = amp * (1.0f - 4.0f * std::abs(p - 0.5f));
 
-    // 	//std::cout << lastSample << " " << destSample << " " << currentSample[chan] << " " << dataSize << std::endl;
+                p += step;
+                if (p >= 1.0f) p -= 1.0f;
+            }
+            break;
+        default: // SAW
+            for (int i = 0; i < nSamps; i++)
+            {
+                dest[i] = amp * (2.0f * p - 1.0f);
 
-    // 	if (destSample < 0)
-    // 		destSample = 0;
+                p += step;
+                if (p >= 1.0f) p -= 1.0f;
+            }
+    }
 
-    // 	int samplesLeft = nSamps - destSample;
+    currentPhase.set(chan, std::fmod(currentPhase[chan] + nSamps * phasePerSample[chan], double_Pi * 2));
 
-    // 	if (samplesLeft < dataSize - currentSample[chan])
-    // 	{
-    // 	 	// buffer.copyFrom(chan,
-    // 	 	// 			destSample,
-    // 	 	// 			waveforms[chan].getRawDataPointer() + currentSample[chan],
-    // 	 	// 			samplesLeft);
+}
 
-    // 	 	currentSample.set(chan, currentSample[chan] + samplesLeft);
+void SignalGenerator::generateSpikes(AudioSampleBuffer& buffer, int chan, int nSamps)
+{
 
-    // 	} else {
+    float* const dest = buffer.getSampleData(chan);
 
-    // 		int samps = dataSize - currentSample[chan];
+    double ph = currentPhase[chan];
 
-    // 		// buffer.copyFrom(chan,
-    // 	 // 				destSample,
-    // 	 // 				waveforms[chan].getRawDataPointer() + currentSample[chan],
-    // 	 // 				samps);
+    for (int i = 0; i < nSamps; i++)
+    {
+        dest[i] = generateSpikeSample(amplitude[chan], ph, phase[chan]);
 
-    // 		destSample += samps;
-    // 		samplesLeft -= samps;
+        ph += phasePerSample[chan];
 
-    // 		// buffer.copyFrom(chan,
-    // 	 // 				destSample,
-    // 	 // 				waveforms[chan].getRawDataPointer(),
-    // 	 // 				samplesLeft);
+        if (ph > double_Pi*2)
+            ph = 0;
+    }
 
-    // 		currentSample.set(chan, samplesLeft);
-    // 	}
+    currentPhase.set(chan, ph);
 
-    // }
+}
+
+void SignalGenerator::generateProbe(AudioSampleBuffer& buffer, int chan, int nSamps)
+{
+
+    ProbeState* probe = probes[chan];
+
+    float* const dest = buffer.getSampleData(chan);
+
+    // noise, in runs straight from the table
+    const float noise = float(noiseLevel[chan]);
+
+    for (int i = 0; i < nSamps;)
+    {
+        const int count = jmin(nSamps - i, NOISE_TABLE_SIZE - probe->noiseIndex);
+        const float* const table = noiseTable + probe->noiseIndex;
+
+        for (int n = 0; n < count; n++)
+            dest[i + n] = noise * table[n];
+
+        i += count;
+        probe->noiseIndex += count;
+
+        // jump somewhere else in the table, so that the noise doesn't repeat
+        if (probe->noiseIndex == NOISE_TABLE_SIZE)
+            probe->noiseIndex = probe->random.nextInt(NOISE_TABLE_SIZE);
+    }
+
+    // spikes, added on top
+    for (int i = 0; i < nSamps;)
+    {
+        if (probe->spikePosition < 0)
+        {
+            if (probe->samplesToNextSpike >= nSamps - i)
+            {
+                probe->samplesToNextSpike -= nSamps - i;
+                break;
+            }
+
+            i += probe->samplesToNextSpike;
+
+            probe->spikePosition = 0;
+            probe->spikeTemplate = probe->random.nextInt(NUM_SPIKE_TEMPLATES);
+            probe->spikeGain = float(amplitude[chan]) * (0.8f + 0.4f * probe->random.nextFloat());
+        }
+
+        const float* const shape = spikeTemplates + probe->spikeTemplate * templateLength
+                                   + probe->spikePosition;
+
+        const int count = jmin(nSamps - i, templateLength - probe->spikePosition);
+
+        for (int n = 0; n < count; n++)
+            dest[i + n] += probe->spikeGain * shape[n];
+
+        i += count;
+        probe->spikePosition += count;
+
+        if (probe->spikePosition == templateLength)
+        {
+            probe->spikePosition = -1;
+            probe->samplesToNextSpike = drawSpikeInterval(probe, frequency[chan]);
+        }
+    }
 
 }
+
+int SignalGenerator::drawSpikeInterval(ProbeState* probe, double rate)
+{
+
+    if (rate <= 0)
+        return INT_MAX;
+
+    // exponential intervals, for Poisson firing; each spike's own
+    // length acts as a refractory period on top
+    const double interval = -std::log(1.0 - probe->random.nextDouble()) * getSampleRate() / rate;
+
+    return int(jmin(interval, double(INT_MAX / 2)));
+
+}
+
+void SignalGenerator::createSpikeTemplates()
+{
+
+    templateLength = jmax(2, int(SPIKE_DURATION_MS * getSampleRate() / 1000.0));
+
+    spikeTemplates.malloc(NUM_SPIKE_TEMPLATES * templateLength);
+
+    for (int w = 0; w < NUM_SPIKE_TEMPLATES; w++)
+    {
+        const double* waveform = SPIKE_WAVEFORMS[w];
+
+        // the waveforms rest at 1 and peak upwards; flip them, and scale to a unit trough
+        double peak = 0;
+
+        for (int k = 0; k < N_WAVEFORM_SAMPLES; k++)
+            peak = jmax(peak, waveform[k] - 1.0);
+
+        for (int k = 0; k < templateLength; k++)
+        {
+            const double position = double(k) * (N_WAVEFORM_SAMPLES - 1) / (templateLength - 1);
+            const int index = jmin(int(position), N_WAVEFORM_SAMPLES - 2);
+            const double fraction = position - index;
+
+            const double value = waveform[index] + fraction * (waveform[index + 1] - waveform[index]);
+
+            spikeTemplates[w * templateLength + k] = float((1.0 - value) / peak);
+        }
+    }
+
+}
+
+void SignalGenerator::resetProbes()
+{
+
+    for (int j = 0; j < probes.size(); j++)
+    {
+        ProbeState* probe = probes[j];
+
+        probe->random.setSeed(j + 1);
+
+        probe->noiseIndex = probe->random.nextInt(NOISE_TABLE_SIZE);
+        probe->spikePosition = -1;
+        probe->spikeTemplate = 0;
+        probe->spikeGain = 0;
+        probe->samplesToNextSpike = drawSpikeInterval(probe, j < frequency.size() ? frequency[j] : 0);
+    }
+
+}
+
 float SignalGenerator::generateSpikeSample(double amp, double phase, double noise)
 {
 
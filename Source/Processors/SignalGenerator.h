@@ -33,6 +33,20 @@
 
   Outputs synthesized data of one of 5 different waveform types.
 
+  It is cheap enough to stand in for a large probe when benchmarking the
+  rest of the signal chain:
+
+  - Sines come from a recursive (rotating phasor) oscillator, run on four
+    channels at a time with SSE, and re-anchored to a double-precision
+    phase at the start of every buffer so that they can't drift.
+  - Square, saw and triangle waves are read off a phase accumulator.
+  - The PROBE waveform is a synthetic extracellular recording: Gaussian
+    noise (from a precomputed table) with spikes (SPIKE_WAVEFORMS, 3 ms
+    long, amplitude varying by +/-20%) at Poisson-distributed times.
+    Its frequency sets the mean firing rate and its amplitude the spike
+    size; parameter 4 sets the noise level. Each channel has its own
+    seeded random number generator, so every run is the same.
+
   @see GenericProcessor, SignalGeneratorEditor
 
 */
@@ -90,6 +104,16 @@ private:
 
     float generateSpikeSample(double amp, double phase, double noise);
 
+    /** Each of these fills one channel (or, for sines, up to four) for one
+        buffer and advances its phase. */
+    void generateSines(AudioSampleBuffer& buffer, const int* channels, int numChannels, int nSamps);
+    void generateShape(AudioSampleBuffer& buffer, int chan, int nSamps);
+    void generateSpikes(AudioSampleBuffer& buffer, int chan, int nSamps);
+    void generateProbe(AudioSampleBuffer& buffer, int chan, int nSamps);
+
+    void createSpikeTemplates();
+    void resetProbes();
+
     float sampleRateRatio;
 
     //void updateWaveform(int chan);
@@ -98,9 +122,23 @@ private:
 
     enum wvfrm
     {
-        TRIANGLE, SINE, SQUARE, SAW, NOISE, SPIKE
+        TRIANGLE, SINE, SQUARE, SAW, NOISE, SPIKE, PROBE
+    };
+
+    struct ProbeState
+    {
+        Random random;
+
+        int noiseIndex;
+        int samplesToNextSpike;
+
+        int spikePosition; /**< -1 between spikes. */
+        int spikeTemplate;
+        float spikeGain;
     };
 
+    int drawSpikeInterval(ProbeState* probe, double rate);
+
     Array<var> waveformParameter;
     Array<int> waveformType;
     Array<double> frequency;
@@ -108,6 +146,17 @@ private:
     Array<double> phase;
     Array<double> phasePerSample;
     Array<double> currentPhase;
+    Array<double> noiseLevel;
+
+    OwnedArray<ProbeState> probes;
+
+    /** Unit-variance Gaussian noise, shared by every PROBE channel. */
+    HeapBlock<float> noiseTable;
+
+    /** One row of templateLength samples per spike waveform, scaled so
+        that the trough is at -1. */
+    HeapBlock<float> spikeTemplates;
+    int templateLength;
 
     double previousPhase;
     int spikeIdx;
@@ -36,7 +36,10 @@
 SourceNode::SourceNode(const String& name_)
     : GenericProcessor(name_),
       sourceCheckInterval(2000), wasDisabled(true), dataThread(0),
-      inputBuffer(0), ttlState(0)
+      inputBuffer(0), expectedTimestamp(0), hasExpectedTimestamp(false),
+      lastNumSamplesLost(0), samplesLostAtStart(0),
+      reportedSamplesLost(0), reportedMissingSamples(0),
+      ttlState(0)
 {
 
     std::cout << "creating source node." << std::endl;
@@ -84,6 +87,7 @@ SourceNode::SourceNode(const String& name_)
     startTimer(sourceCheckInterval);
 
     timestamp = 0;
+    timestampBuffer = new uint64[10000];
     eventCodeBuffer = new int16[10000]; //10000 samples per buffer max?
 
 
@@ -101,6 +105,9 @@ SourceNode::~SourceNode()
 
     if (eventChannelState)
         delete[] eventChannelState;
+
+    delete[] timestampBuffer;
+    delete[] eventCodeBuffer;
 }
 
 DataThread* SourceNode::getThread()
@@ -121,8 +128,8 @@ void SourceNode::updateSettings()
     for (int i = 0; i < dataThread->getNumEventChannels(); i++)
     {
         Channel* ch = new Channel(this, i);
-        ch->eventType = TTL;
-        ch->isEventChannel = true;
+        ch->setEventType(TTL);
+        ch->setEventChannel(true);
         eventChannels.add(ch);
     }
 
@@ -250,6 +257,9 @@ bool SourceNode::tryEnablingEditor()
 
 void SourceNode::timerCallback()
 {
+    if (getEditor() == 0)
+        return; // constructed ahead of time, and not in the signal chain yet
+
     if (!tryEnablingEditor() && isEnabled)
     {
         std::cout << "Input source lost." << std::endl;
@@ -257,6 +267,42 @@ void SourceNode::timerCallback()
         GenericEditor* ed = getEditor();
         getEditorViewport()->makeEditorVisible(ed);
     }
+
+    // report any new data loss since the last check
+    const int64 samplesLost = getNumSamplesLost();
+    const int64 missingSamples = getNumMissingSamples();
+
+    if (samplesLost != reportedSamplesLost || missingSamples != reportedMissingSamples)
+    {
+        String msg = getName() + ": ";
+        msg << String(samplesLost) << " samples dropped (buffer full), "
+            << String(getNumTimestampGaps()) << " timestamp gaps ("
+            << String(missingSamples) << " samples missing).";
+
+        std::cout << msg << std::endl;
+        sendActionMessage(msg);
+
+        reportedSamplesLost = samplesLost;
+        reportedMissingSamples = missingSamples;
+    }
+}
+
+int64 SourceNode::getNumSamplesLost()
+{
+    if (inputBuffer != 0)
+        return inputBuffer->getNumSamplesLost() - samplesLostAtStart;
+    else
+        return 0;
+}
+
+int64 SourceNode::getNumTimestampGaps()
+{
+    return numTimestampGaps.get();
+}
+
+int64 SourceNode::getNumMissingSamples()
+{
+    return numMissingSamples.get();
 }
 
 bool SourceNode::isReady()
@@ -271,6 +317,16 @@ bool SourceNode::enable()
 
     wasDisabled = false;
 
+    // data loss is counted per acquisition
+    hasExpectedTimestamp = false;
+    numTimestampGaps = 0;
+    numMissingSamples = 0;
+    reportedSamplesLost = 0;
+    reportedMissingSamples = 0;
+
+    if (inputBuffer != 0)
+        lastNumSamplesLost = samplesLostAtStart = inputBuffer->getNumSamplesLost();
+
     if (dataThread != 0)
     {
         dataThread->startAcquisition();
@@ -329,7 +385,10 @@ void SourceNode::process(AudioSampleBuffer& buffer,
     events.clear();
     buffer.clear();
 
-    nSamples = inputBuffer->readAllFromBuffer(buffer, &timestamp, eventCodeBuffer, buffer.getNumSamples());
+    nSamples = inputBuffer->readAllFromBuffer(buffer, timestampBuffer, eventCodeBuffer, buffer.getNumSamples());
+
+    if (nSamples > 0)
+        timestamp = timestampBuffer[0];
 
     //std::cout << *buffer.getSampleData(0) << std::endl;
 
@@ -350,6 +409,8 @@ void SourceNode::process(AudioSampleBuffer& buffer,
              data   // data
             );
 
+    checkForDataLoss(events, nSamples);
+
     // std::cout << (int) *(data + 7) << " " <<
     //                 (int) *(data + 6) << " " <<
     //                 (int) *(data + 5) << " " <<
@@ -408,6 +469,69 @@ void SourceNode::process(AudioSampleBuffer& buffer,
 
 
 
+void SourceNode::checkForDataLoss(MidiBuffer& events, int nSamples)
+{
+    uint8 data[8];
+
+    // samples the DataThread couldn't fit into the buffer
+    const int64 samplesLost = inputBuffer->getNumSamplesLost();
+
+    if (samplesLost != lastNumSamplesLost)
+    {
+        // the gap sits after the samples that made it into the buffer; wait until
+        // a block reaches it, so the event lands on the first sample after the gap
+        const int64 blockStart = inputBuffer->getNumSamplesRead() - nSamples;
+        const int64 position = jmax((int64) 0, inputBuffer->getLastLossPosition() - blockStart);
+
+        if (position < nSamples)
+        {
+            int64 numLost = samplesLost - lastNumSamplesLost;
+            memcpy(data, &numLost, 8);
+
+            addEvent(events,          // MidiBuffer
+                     DATA_LOSS,       // eventType
+                     (int) position,  // sampleNum
+                     BUFFER_OVERFLOW, // eventID
+                     0,               // eventChannel
+                     8,               // numBytes
+                     data             // data
+                    );
+
+            lastNumSamplesLost = samplesLost;
+        }
+    }
+
+    if (!dataThread->hasContinuousTimestamps())
+        return;
+
+    // every sample should be stamped one higher than the last
+    for (int i = 0; i < nSamples; i++)
+    {
+        const uint64 ts = timestampBuffer[i];
+
+        if (hasExpectedTimestamp && ts != expectedTimestamp)
+        {
+            int64 numMissing = (int64)(ts - expectedTimestamp);
+            memcpy(data, &numMissing, 8);
+
+            addEvent(events,        // MidiBuffer
+                     DATA_LOSS,     // eventType
+                     i,             // sampleNum
+                     TIMESTAMP_GAP, // eventID
+                     0,             // eventChannel
+                     8,             // numBytes
+                     data           // data
+                    );
+
+            ++numTimestampGaps;
+            numMissingSamples += numMissing;
+        }
+
+        expectedTimestamp = ts + 1;
+        hasExpectedTimestamp = true;
+    }
+}
+
 void SourceNode::saveCustomParametersToXml(XmlElement* parentElement)
 {
 
@@ -90,6 +90,22 @@ public:
 
     bool tryEnablingEditor();
 
+    /** Returns the number of samples the DataThread dropped because the buffer was full. */
+    int64 getNumSamplesLost();
+
+    /** Returns the number of discontinuities found in the timestamp sequence. */
+    int64 getNumTimestampGaps();
+
+    /** Returns the total number of samples missing according to the timestamps. */
+    int64 getNumMissingSamples();
+
+    /** Event IDs used for DATA_LOSS events. */
+    enum dataLossTypes
+    {
+        BUFFER_OVERFLOW = 0,
+        TIMESTAMP_GAP = 1
+    };
+
 private:
 
     int numEventChannels;
@@ -104,9 +120,24 @@ private:
     DataBuffer* inputBuffer;
 
     uint64 timestamp;
+    uint64* timestampBuffer;
     int16* eventCodeBuffer;
     int* eventChannelState;
 
+    /** Adds DATA_LOSS events for buffer overflows and timestamp gaps in the current block. */
+    void checkForDataLoss(MidiBuffer& events, int nSamples);
+
+    uint64 expectedTimestamp;
+    bool hasExpectedTimestamp;
+    int64 lastNumSamplesLost;
+    int64 samplesLostAtStart;
+
+    Atomic<int64> numTimestampGaps;
+    Atomic<int64> numMissingSamples;
+
+    /** Loss counts already reported to the MessageCenter. */
+    int64 reportedSamplesLost, reportedMissingSamples;
+
 
     int ttlState;
 
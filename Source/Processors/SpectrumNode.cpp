@@ -0,0 +1,314 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SpectrumNode.h"
+#include "Editors/SpectrumEditor.h"
+
+SpectrumNode::SpectrumNode()
+    : GenericProcessor("Spectrum Viewer"),
+      ringBuffer(1, RING_SIZE), ringFifo(RING_SIZE),
+      numAverages(DEFAULT_NUM_AVERAGES), windowPower(1.0f),
+      history(1, DEFAULT_FFT_SIZE), historyFill(0),
+      accumulated(1, DEFAULT_FFT_SIZE / 2 + 1), numAccumulated(0),
+      spectra(1, DEFAULT_FFT_SIZE / 2 + 1), spectraBinWidth(1.0f), hasSpectra(false),
+      analysisSampleRate(44100.0f)
+{
+    requestedFftSize.set(DEFAULT_FFT_SIZE);
+    requestedNumAverages.set(DEFAULT_NUM_AVERAGES);
+
+    analysisThread = new AnalysisThread(this);
+}
+
+SpectrumNode::~SpectrumNode()
+{
+    analysisThread->stopThread(1000);
+}
+
+AudioProcessorEditor* SpectrumNode::createEditor()
+{
+
+    editor = new SpectrumEditor(this, true);
+    return editor;
+
+}
+
+void SpectrumNode::updateSettings()
+{
+    std::cout << "Setting num inputs on SpectrumNode to " << getNumInputs() << std::endl;
+}
+
+void SpectrumNode::setParameter(int parameterIndex, float newValue)
+{
+    if (parameterIndex == 0)
+    {
+        int size = MIN_FFT_SIZE;
+
+        while (size < newValue && size < MAX_FFT_SIZE)
+            size *= 2;
+
+        requestedFftSize.set(size);
+    }
+    else if (parameterIndex == 1)
+    {
+        requestedNumAverages.set(jmax(1, int(newValue)));
+    }
+}
+
+bool SpectrumNode::enable()
+{
+
+    analysedChannels.clear();
+
+    Array<int> active = getEditor()->getActiveChannels();
+
+    for (int i = 0; i < active.size(); i++)
+    {
+        if (active[i] < getNumInputs())
+            analysedChannels.add(active[i]);
+    }
+
+    if (analysedChannels.size() == 0)
+    {
+        std::cout << "SpectrumNode: no channels selected." << std::endl;
+    }
+
+    analysisSampleRate = getSampleRate();
+
+    ringBuffer.setSize(jmax(1, analysedChannels.size()), RING_SIZE);
+    ringFifo.reset();
+    numDroppedBlocks.set(0);
+
+    {
+        const ScopedLock sl(spectrumLock);
+        hasSpectra = false;
+    }
+
+    // forces the analysis thread to size its buffers for the new channels
+    fft = nullptr;
+
+    analysisThread->startThread();
+
+    SpectrumEditor* ed = (SpectrumEditor*) getEditor();
+    ed->enable();
+
+    return true;
+
+}
+
+bool SpectrumNode::disable()
+{
+    analysisThread->stopThread(1000);
+
+    if (numDroppedBlocks.get() > 0)
+    {
+        std::cout << "SpectrumNode: analysis fell behind, skipped "
+                  << numDroppedBlocks.get() << " blocks." << std::endl;
+    }
+
+    SpectrumEditor* ed = (SpectrumEditor*) getEditor();
+    ed->disable();
+
+    return true;
+}
+
+bool SpectrumNode::getSpectra(AudioSampleBuffer& dest, Array<int>& channels, float& binWidth)
+{
+    const ScopedLock sl(spectrumLock);
+
+    if (!hasSpectra)
+        return false;
+
+    dest.setSize(spectra.getNumChannels(), spectra.getNumSamples(), false, false, true);
+
+    for (int i = 0; i < spectra.getNumChannels(); i++)
+        dest.copyFrom(i, 0, spectra, i, 0, spectra.getNumSamples());
+
+    channels = analysedChannels;
+    binWidth = spectraBinWidth;
+
+    return true;
+}
+
+void SpectrumNode::process(AudioSampleBuffer& buffer, MidiBuffer& events, int& nSamples)
+{
+
+    const int numChannels = analysedChannels.size();
+
+    if (numChannels == 0 || nSamples <= 0)
+        return;
+
+    int start1, size1, start2, size2;
+
+    ringFifo.prepareToWrite(nSamples, start1, size1, start2, size2);
+
+    if (size1 + size2 < nSamples)
+    {
+        // the analysis thread is behind; skip the block rather than wait
+        numDroppedBlocks.set(numDroppedBlocks.get() + 1);
+        return;
+    }
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        const int chan = analysedChannels.getUnchecked(i);
+
+        ringBuffer.copyFrom(i, start1, buffer, chan, 0, size1);
+
+        if (size2 > 0)
+            ringBuffer.copyFrom(i, start2, buffer, chan, size1, size2);
+    }
+
+    ringFifo.finishedWrite(nSamples);
+
+}
+
+void SpectrumNode::runAnalysis()
+{
+
+    while (!analysisThread->threadShouldExit())
+    {
+        const int fftSize = requestedFftSize.get();
+
+        if (fft == nullptr || fft->getSize() != fftSize || numAverages != requestedNumAverages.get())
+            configureAnalysis(fftSize, requestedNumAverages.get());
+
+        // segments overlap by half, so each hop completes a new segment
+        const int hop = fftSize / 2;
+
+        while (ringFifo.getNumReady() >= hop && !analysisThread->threadShouldExit())
+        {
+            int start1, size1, start2, size2;
+
+            ringFifo.prepareToRead(hop, start1, size1, start2, size2);
+
+            for (int i = 0; i < history.getNumChannels(); i++)
+            {
+                float* h = history.getSampleData(i);
+
+                memmove(h, h + hop, sizeof(float) * (fftSize - hop));
+
+                memcpy(h + fftSize - hop, ringBuffer.getSampleData(i, start1), sizeof(float) * size1);
+
+                if (size2 > 0)
+                    memcpy(h + fftSize - hop + size1, ringBuffer.getSampleData(i, start2), sizeof(float) * size2);
+            }
+
+            ringFifo.finishedRead(hop);
+
+            historyFill = jmin(historyFill + hop, fftSize);
+
+            if (historyFill == fftSize)
+                analyseSegment();
+        }
+
+        analysisThread->wait(20);
+    }
+
+}
+
+void SpectrumNode::configureAnalysis(int fftSize, int numAverages_)
+{
+
+    fft = new Dsp::FFT(fftSize);
+    numAverages = numAverages_;
+
+    const int numBins = fft->getNumBins();
+    const int numChannels = jmax(1, analysedChannels.size());
+
+    window.malloc(fftSize);
+    windowed.malloc(fftSize);
+    power.malloc(numBins);
+
+    // periodic Hann window
+    windowPower = 0.0f;
+
+    for (int i = 0; i < fftSize; i++)
+    {
+        window[i] = 0.5f - 0.5f * cosf(2.0f * float_Pi * i / fftSize);
+        windowPower += window[i] * window[i];
+    }
+
+    history.setSize(numChannels, fftSize);
+    history.clear();
+    historyFill = 0;
+
+    accumulated.setSize(numChannels, numBins);
+    accumulated.clear();
+    numAccumulated = 0;
+
+}
+
+void SpectrumNode::analyseSegment()
+{
+
+    const int fftSize = fft->getSize();
+    const int numBins = fft->getNumBins();
+
+    for (int i = 0; i < history.getNumChannels(); i++)
+    {
+        const float* h = history.getSampleData(i);
+
+        for (int n = 0; n < fftSize; n++)
+            windowed[n] = h[n] * window[n];
+
+        fft->performPower(windowed, power);
+
+        accumulated.addFrom(i, 0, power, numBins);
+    }
+
+    if (++numAccumulated >= numAverages)
+    {
+        publishSpectra();
+
+        accumulated.clear();
+        numAccumulated = 0;
+    }
+
+}
+
+void SpectrumNode::publishSpectra()
+{
+
+    const int numBins = fft->getNumBins();
+
+    // one-sided density: every bin but DC and Nyquist carries the power of
+    // its negative-frequency image as well
+    const float scale = 1.0f / (float(numAccumulated) * analysisSampleRate * windowPower);
+
+    const ScopedLock sl(spectrumLock);
+
+    spectra.setSize(accumulated.getNumChannels(), numBins, false, false, true);
+
+    for (int i = 0; i < accumulated.getNumChannels(); i++)
+    {
+        spectra.copyFrom(i, 0, accumulated.getSampleData(i), numBins, 2.0f * scale);
+        spectra.applyGain(i, 0, 1, 0.5f);
+        spectra.applyGain(i, numBins - 1, 1, 0.5f);
+    }
+
+    spectraBinWidth = analysisSampleRate / float(fft->getSize());
+    hasSpectra = true;
+
+    spectrumCount.set(spectrumCount.get() + 1);
+
+}
@@ -0,0 +1,150 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SPECTRUMNODE_H_6B2E04D1__
+#define __SPECTRUMNODE_H_6B2E04D1__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+#include "../Dsp/Dsp.h"
+#include "GenericProcessor.h"
+
+/**
+
+  Estimates the power spectral density of the selected channels.
+
+  The audio thread only copies the channels selected in the editor's
+  channel selector into a FIFO. A background thread reads them back,
+  applies a Hann window to segments overlapping by half, and averages the
+  power spectra of a fixed number of segments (Welch's method). Each
+  finished average is published for the SpectrumCanvas, in uV^2/Hz.
+
+  Parameters 0 (FFT size) and 1 (number of averaged segments) can be
+  changed while acquisition is running; the analysis thread picks them up
+  at the start of its next pass.
+
+  @see GenericProcessor, SpectrumEditor, SpectrumCanvas
+
+*/
+
+class SpectrumNode : public GenericProcessor
+
+{
+public:
+
+    SpectrumNode();
+    ~SpectrumNode();
+
+    AudioProcessorEditor* createEditor();
+
+    bool isSink()
+    {
+        return true;
+    }
+
+    void process(AudioSampleBuffer& buffer, MidiBuffer& midiMessages, int& nSamples);
+
+    void setParameter(int, float);
+
+    void updateSettings();
+
+    bool enable();
+    bool disable();
+
+    /** Copies the most recent spectra into dest, one channel per analysed
+        input channel and one sample per frequency bin. Returns false if no
+        average has been completed since acquisition started. */
+    bool getSpectra(AudioSampleBuffer& dest, Array<int>& channels, float& binWidth);
+
+    /** Increments each time a new set of spectra is published. */
+    int getSpectrumCount()
+    {
+        return spectrumCount.get();
+    }
+
+    enum
+    {
+        MIN_FFT_SIZE = 256,
+        MAX_FFT_SIZE = 8192,
+        DEFAULT_FFT_SIZE = 2048,
+        DEFAULT_NUM_AVERAGES = 8
+    };
+
+private:
+
+    class AnalysisThread : public Thread
+    {
+    public:
+        AnalysisThread(SpectrumNode* n) : Thread("Spectrum Analysis"), node(n) {}
+        void run()
+        {
+            node->runAnalysis();
+        }
+    private:
+        SpectrumNode* node;
+    };
+
+    void runAnalysis();
+    void configureAnalysis(int fftSize, int numAverages);
+    void analyseSegment();
+    void publishSpectra();
+
+    // shared with the audio thread
+    Array<int> analysedChannels;
+    AudioSampleBuffer ringBuffer;
+    AbstractFifo ringFifo;
+    Atomic<int> numDroppedBlocks;
+
+    Atomic<int> requestedFftSize;
+    Atomic<int> requestedNumAverages;
+
+    ScopedPointer<AnalysisThread> analysisThread;
+
+    // owned by the analysis thread
+    ScopedPointer<Dsp::FFT> fft;
+    int numAverages;
+    HeapBlock<float> window;
+    float windowPower;
+    AudioSampleBuffer history;
+    int historyFill;
+    HeapBlock<float> windowed;
+    HeapBlock<float> power;
+    AudioSampleBuffer accumulated;
+    int numAccumulated;
+
+    // published results
+    CriticalSection spectrumLock;
+    AudioSampleBuffer spectra;
+    float spectraBinWidth;
+    Atomic<int> spectrumCount;
+    bool hasSpectra;
+
+    float analysisSampleRate;
+
+    enum { RING_SIZE = 2 * MAX_FFT_SIZE };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumNode);
+
+};
+
+
+#endif  // __SPECTRUMNODE_H_6B2E04D1__
@@ -28,7 +28,7 @@
 
 SpikeDetector::SpikeDetector()
     : GenericProcessor("Spike Detector"),
-      overflowBuffer(2,100), dataBuffer(overflowBuffer),
+      overflowBuffer(2,100), dataBuffer(0),
       overflowBufferSize(100), currentElectrode(-1)
 {
     //// the standard form:
@@ -69,7 +69,7 @@ SpikeDetector::SpikeDetector()
 
 SpikeDetector::~SpikeDetector()
 {
-
+    delete[] spikeBuffer;
 }
 
 
@@ -85,19 +85,29 @@ void SpikeDetector::updateSettings()
     if (getNumInputs() > 0)
         overflowBuffer.setSize(getNumInputs(), overflowBufferSize);
 
+    overflowBuffer.clear();
+
     for (int i = 0; i < electrodes.size(); i++)
     {
 
         Channel* ch = new Channel(this, i);
-        ch->isEventChannel = true;
-        ch->eventType = SPIKE_BASE_CODE + electrodes[i]->numChannels;
-        ch->name = electrodes[i]->name;
+        ch->setEventChannel(true);
+        ch->setEventType(SPIKE_BASE_CODE + electrodes[i]->numChannels);
+        ch->setName(electrodes[i]->name);
 
         eventChannels.add(ch);
     }
 
 }
 
+void SpikeDetector::prepareToPlay(double sampleRate_, int estimatedSamplesPerBlock)
+{
+
+    if (getNumInputs() > 0 && overflowBuffer.getNumChannels() != getNumInputs())
+        overflowBuffer.setSize(getNumInputs(), overflowBufferSize);
+
+}
+
 bool SpikeDetector::addElectrode(int nChans)
 {
 
@@ -277,6 +287,8 @@ void SpikeDetector::setParameter(int parameterIndex, float newValue)
 bool SpikeDetector::enable()
 {
 
+    overflowBuffer.clear();
+
     useOverflowBuffer = false;
     return true;
 }
@@ -359,8 +371,8 @@ void SpikeDetector::addWaveformToSpikeObject(SpikeObject* s,
 
     int chan = *(electrodes[electrodeNumber]->channels+currentChannel);
 
-    s->gain[currentChannel] = (int)(1.0f / channels[chan]->bitVolts)*1000;
-    s->threshold[currentChannel] = (int) *(electrodes[electrodeNumber]->thresholds+currentChannel) / channels[chan]->bitVolts * 1000;
+    s->gain[currentChannel] = (int)(1.0f / channels[chan]->getBitVolts())*1000;
+    s->threshold[currentChannel] = (int) *(electrodes[electrodeNumber]->thresholds+currentChannel) / channels[chan]->getBitVolts() * 1000;
 
     // cycle through buffer
 
@@ -374,7 +386,7 @@ void SpikeDetector::addWaveformToSpikeObject(SpikeObject* s,
 
 
 
-            s->data[currentIndex] = uint16(getNextSample(*(electrodes[electrodeNumber]->channels+currentChannel)) / channels[chan]->bitVolts + 32768);
+            s->data[currentIndex] = uint16(getNextSample(*(electrodes[electrodeNumber]->channels+currentChannel)) / channels[chan]->getBitVolts() + 32768);
 
             currentIndex++;
             sampleIndex++;
@@ -404,16 +416,22 @@ void SpikeDetector::addWaveformToSpikeObject(SpikeObject* s,
 
 }
 
-void SpikeDetector::handleEvent(int eventType, MidiMessage& event, int sampleNum)
+void SpikeDetector::checkForTimestamp(MidiBuffer& events)
 {
 
-    if (eventType == TIMESTAMP)
-    {
-        const uint8* dataptr = event.getRawData();
+    MidiBuffer::Iterator i(events);
 
-        memcpy(&timestamp, dataptr + 4, 8); // remember to skip first four bytes
-    }
+    const uint8* dataptr;
+    int numBytes;
+    int samplePosition;
 
+    while (i.getNextEvent(dataptr, numBytes, samplePosition))
+    {
+        if (*dataptr == TIMESTAMP && numBytes >= 12)
+        {
+            memcpy(&timestamp, dataptr + 4, 8); // remember to skip first four bytes
+        }
+    }
 
 }
 
@@ -424,9 +442,9 @@ void SpikeDetector::process(AudioSampleBuffer& buffer,
 
     // cycle through electrodes
     Electrode* electrode;
-    dataBuffer = buffer;
+    dataBuffer = &buffer;
 
-    checkForEvents(events);
+    checkForTimestamp(events);
 
     //std::cout << dataBuffer.getMagnitude(0,nSamples) << std::endl;
 
@@ -476,10 +494,9 @@ void SpikeDetector::process(AudioSampleBuffer& buffer,
                         peakIndex = sampleIndex;
                         sampleIndex -= (electrode->prePeakSamples+1);
 
-                        SpikeObject newSpike;
-                        newSpike.timestamp = peakIndex;
-                        newSpike.source = i;
-                        newSpike.nChannels = electrode->numChannels;
+                        currentSpike.timestamp = peakIndex;
+                        currentSpike.source = i;
+                        currentSpike.nChannels = electrode->numChannels;
 
                         currentIndex = 0;
 
@@ -487,7 +504,7 @@ void SpikeDetector::process(AudioSampleBuffer& buffer,
                         for (int channel = 0; channel < electrode->numChannels; channel++)
                         {
 
-                            addWaveformToSpikeObject(&newSpike,
+                            addWaveformToSpikeObject(&currentSpike,
                                                      peakIndex,
                                                      i,
                                                      channel);
@@ -505,7 +522,7 @@ void SpikeDetector::process(AudioSampleBuffer& buffer,
 
                         }
 
-                        addSpikeEvent(&newSpike, events, peakIndex);
+                        addSpikeEvent(&currentSpike, events, peakIndex);
 
                         // advance the sample index
                         sampleIndex = peakIndex + electrode->postPeakSamples;
@@ -582,8 +599,8 @@ float SpikeDetector::getNextSample(int& chan)
         //  useOverflowBuffer = false;
         // std::cout << "  sample index " << sampleIndex << "from regular buffer" << std::endl;
 
-        if (sampleIndex < dataBuffer.getNumSamples())
-            return *dataBuffer.getSampleData(chan, sampleIndex);
+        if (sampleIndex < dataBuffer->getNumSamples())
+            return *dataBuffer->getSampleData(chan, sampleIndex);
         else
             return 0;
     }
@@ -613,7 +630,7 @@ float SpikeDetector::getCurrentSample(int& chan)
     {
         //  useOverflowBuffer = false;
         // std::cout << "  sample index " << sampleIndex << "from regular buffer" << std::endl;
-        return *dataBuffer.getSampleData(chan, sampleIndex - 1);
+        return *dataBuffer->getSampleData(chan, sampleIndex - 1);
     }
     //} else {
 
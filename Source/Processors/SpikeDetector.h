@@ -67,6 +67,9 @@ public:
     /** Called whenever the signal chain is altered. */
     void updateSettings();
 
+    /** Sizes the overflow buffer before the first callback. */
+    void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock);
+
     /** Called prior to start of acquisition. */
     bool enable();
 
@@ -79,8 +82,9 @@ public:
 
     // INTERNAL BUFFERS //
 
-    /** Extra samples are placed in this buffer to allow seamless
-        transitions between callbacks. */
+    /** The last overflowBufferSize samples of each callback are kept in this
+        fixed-size buffer, so spikes can straddle the boundary between callbacks.
+        It is sized in updateSettings() and prepareToPlay(), never in process(). */
     AudioSampleBuffer overflowBuffer;
 
 
@@ -130,8 +134,9 @@ public:
     void loadCustomParametersFromXml();
 
 private:
-    /** Reference to a continuous buffer. */
-    AudioSampleBuffer& dataBuffer;
+    /** The buffer passed to the current process() call. Spikes are read from it
+        in place rather than from a copy. */
+    AudioSampleBuffer* dataBuffer;
 
     float getDefaultThreshold();
 
@@ -169,6 +174,9 @@ private:
     uint8_t* spikeBuffer;///[256];
     uint64_t timestamp;
 
+    /** Reused for every spike, so that building one never touches the heap. */
+    SpikeObject currentSpike;
+
     Array<Electrode*> electrodes;
 
     // void createSpikeEvent(int& peakIndex,
@@ -176,7 +184,9 @@ private:
     // 					  int& currentChannel,
     // 					  MidiBuffer& eventBuffer);
 
-    void handleEvent(int eventType, MidiMessage& event, int sampleNum);
+    /** Reads the TIMESTAMP event without constructing MidiMessage objects, which
+        would allocate for every event longer than four bytes. */
+    void checkForTimestamp(MidiBuffer& events);
 
     void addSpikeEvent(SpikeObject* s, MidiBuffer& eventBuffer, int peakIndex);
     void addWaveformToSpikeObject(SpikeObject* s,
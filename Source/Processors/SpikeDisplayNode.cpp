@@ -28,11 +28,13 @@
 
 SpikeDisplayNode::SpikeDisplayNode()
     : GenericProcessor("Spike Viewer"),
+      spikeFifo(SPIKE_FIFO_SIZE),
+      spikeData(SPIKE_FIFO_SIZE * MAX_SPIKE_BUFFER_LEN),
+      spikeSizes(SPIKE_FIFO_SIZE),
       bufferSize(0)
 
 {
     //	displayBuffer = new AudioSampleBuffer(8, 100);
-    eventBuffer = new MidiBuffer();
 }
 
 SpikeDisplayNode::~SpikeDisplayNode()
@@ -64,6 +66,8 @@ AudioProcessorEditor* SpikeDisplayNode::createEditor()
 bool SpikeDisplayNode::enable()
 {
     std::cout << "SpikeDisplayNode::enable()" << std::endl;
+    spikeFifo.reset();
+    numDroppedSpikes.set(0);
     SpikeDisplayEditor* editor = (SpikeDisplayEditor*) getEditor();
     editor->enable();
     return true;
@@ -73,6 +77,13 @@ bool SpikeDisplayNode::enable()
 bool SpikeDisplayNode::disable()
 {
     std::cout << "SpikeDisplayNode disabled!" << std::endl;
+
+    if (numDroppedSpikes.get() > 0)
+    {
+        std::cout << "SpikeDisplayNode: display fell behind, dropped "
+                  << numDroppedSpikes.get() << " spikes." << std::endl;
+    }
+
     SpikeDisplayEditor* editor = (SpikeDisplayEditor*) getEditor();
     editor->disable();
     return true;
@@ -86,14 +97,14 @@ int SpikeDisplayNode::getNumberOfChannelsForElectrode(int elec)
 
     for (int i = 0; i < eventChannels.size(); i++)
     {
-		if ((eventChannels[i]->eventType < 999) && (eventChannels[i]->eventType > SPIKE_BASE_CODE))
+		if ((eventChannels[i]->getEventType() < 999) && (eventChannels[i]->getEventType() > SPIKE_BASE_CODE))
         {
             electrodeIndex++;
 
             if (electrodeIndex == elec)
             {
-                std::cout << "Electrode " << elec << " has " << eventChannels[i]->eventType << " channels" << std::endl;
-                return (eventChannels[i]->eventType - SPIKE_BASE_CODE);
+                std::cout << "Electrode " << elec << " has " << eventChannels[i]->getEventType() << " channels" << std::endl;
+                return (eventChannels[i]->getEventType() - SPIKE_BASE_CODE);
             }
         }
     }
@@ -108,14 +119,14 @@ String SpikeDisplayNode::getNameForElectrode(int elec)
 
     for (int i = 0; i < eventChannels.size(); i++)
     {
-        if ((eventChannels[i]->eventType < 999) && (eventChannels[i]->eventType > SPIKE_BASE_CODE))
+        if ((eventChannels[i]->getEventType() < 999) && (eventChannels[i]->getEventType() > SPIKE_BASE_CODE))
         {
             electrodeIndex++;
 
             if (electrodeIndex == elec)
             {
-                std::cout << "Electrode " << elec << " has " << eventChannels[i]->eventType << " channels" << std::endl;
-                return eventChannels[i]->name;
+                std::cout << "Electrode " << elec << " has " << eventChannels[i]->getEventType() << " channels" << std::endl;
+                return eventChannels[i]->getName();
             }
         }
     }
@@ -129,7 +140,7 @@ int SpikeDisplayNode::getNumElectrodes()
 
     for (int i = 0; i < eventChannels.size(); i++)
     {
-        if ((eventChannels[i]->eventType < 999) && (eventChannels[i]->eventType > SPIKE_BASE_CODE))
+        if ((eventChannels[i]->getEventType() < 999) && (eventChannels[i]->getEventType() > SPIKE_BASE_CODE))
         {
             nElectrodes++;
         }
@@ -167,16 +178,50 @@ void SpikeDisplayNode::process(AudioSampleBuffer& buffer, MidiBuffer& events, in
 
 }
 
-void SpikeDisplayNode::handleEvent(int eventType, MidiMessage& event, int samplePosition)
+void SpikeDisplayNode::handleEvent(int eventType, const uint8* eventData, int numBytes, int samplePosition)
 {
 
     //std::cout << "Received event of type " << eventType << std::endl;
 
-    if (eventType == SPIKE)
+    if (eventType == SPIKE && numBytes <= MAX_SPIKE_BUFFER_LEN)
+    {
+        int start1, size1, start2, size2;
+
+        spikeFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+        {
+            // the canvas is behind; drop the spike rather than wait
+            numDroppedSpikes.set(numDroppedSpikes.get() + 1);
+            return;
+        }
+
+        memcpy(spikeData + start1 * MAX_SPIKE_BUFFER_LEN, eventData, numBytes);
+        spikeSizes[start1] = numBytes;
+
+        spikeFifo.finishedWrite(1);
+    }
+
+}
+
+bool SpikeDisplayNode::getNextSpike(SpikeObject& spike)
+{
+
+    int start1, size1, start2, size2;
+
+    // skips over any spikes that fail to unpack
+    while (spikeFifo.getNumReady() > 0)
     {
-       // const MessageManagerLock mmLock; // get the lock to prevent the midi buffer from being read
-        
-      eventBuffer->addEvent(event, 0);
+        spikeFifo.prepareToRead(1, start1, size1, start2, size2);
+
+        bool isValid = unpackSpike(&spike, spikeData + start1 * MAX_SPIKE_BUFFER_LEN, spikeSizes[start1]);
+
+        spikeFifo.finishedRead(1);
+
+        if (isValid)
+            return true;
     }
 
+    return false;
+
 }
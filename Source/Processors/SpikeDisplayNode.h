@@ -37,6 +37,9 @@ class DataViewport;
  Takes in MidiEvents and extracts SpikeObjects from the MidiEvent buffers.
  Those Events are then held in a queue until they are pulled by the SpikeDisplayCanvas.
 
+ The queue is a lock-free FIFO of fixed-size slots, so the audio thread never
+ allocates or waits for the canvas; spikes that arrive while it is full are dropped.
+
   @see GenericProcessor, SpikeDisplayEditor, SpikeDisplayCanvas
 
 */
@@ -59,7 +62,7 @@ public:
 
     void setParameter(int, float);
 
-    void handleEvent(int, MidiMessage&, int);
+    void handleEvent(int, const uint8*, int, int);
 
     //void updateSettings();
 
@@ -69,10 +72,8 @@ public:
     void startRecording();
     void stopRecording();
 
-    MidiBuffer* getSpikeBufferAddress()
-    {
-        return eventBuffer;
-    }
+    /** Takes the oldest valid queued spike, if there is one. Called from the message thread. */
+    bool getNextSpike(SpikeObject& spike);
 
     String getNameForElectrode(int i);
     int getNumberOfChannelsForElectrode(int i);
@@ -82,7 +83,13 @@ private:
 
     int numberOfSources;
 
-    ScopedPointer<MidiBuffer> eventBuffer;
+    enum { SPIKE_FIFO_SIZE = 2048 };
+
+    // shared with the audio thread
+    AbstractFifo spikeFifo;
+    HeapBlock<uint8> spikeData;
+    HeapBlock<int> spikeSizes;
+    Atomic<int> numDroppedSpikes;
 
     int bufferSize;
 
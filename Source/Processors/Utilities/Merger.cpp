@@ -178,8 +178,8 @@ void Merger::updateSettings()
         for (int i = 0; i < getNumOutputs(); i++)
         {
             Channel* ch = new Channel(this, i);
-            ch->sampleRate = getDefaultSampleRate();
-            ch->bitVolts = getDefaultBitVolts();
+            ch->setSampleRate(getDefaultSampleRate());
+            ch->setBitVolts(getDefaultBitVolts());
 
             channels.add(ch);
         }
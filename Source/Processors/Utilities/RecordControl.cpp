@@ -56,9 +56,9 @@ void RecordControl::process(AudioSampleBuffer& buffer,
 }
 
 
-void RecordControl::handleEvent(int eventType, MidiMessage& event, int)
+void RecordControl::handleEvent(int eventType, const uint8* eventData, int, int)
 {
-    const uint8* dataptr = event.getRawData();
+    const uint8* dataptr = eventData;
 
     int eventId = *(dataptr+2);
     int eventChannel = *(dataptr+3);
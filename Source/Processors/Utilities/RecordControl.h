@@ -44,7 +44,7 @@ public:
 
     void process(AudioSampleBuffer& buffer, MidiBuffer& midiMessages, int& nSamples);
     void updateTriggerChannel(int newChannel);
-    void handleEvent(int eventType, MidiMessage& event, int);
+    void handleEvent(int eventType, const uint8* eventData, int, int);
 
     AudioProcessorEditor* createEditor();
 
@@ -0,0 +1,187 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "DisplayScheduler.h"
+#include "Visualizer.h"
+
+#include <iostream>
+
+DisplayScheduler* DisplayScheduler::instance = nullptr;
+
+DisplayScheduler::DisplayScheduler()
+    : ticksPerRefresh(1), ticksSinceRefresh(0), numCheapRefreshes(0),
+      lastRefreshTime(0.0), smoothedCost(0.0), isRefreshing(false)
+{
+
+}
+
+DisplayScheduler::~DisplayScheduler()
+{
+
+    stopTimer();
+
+}
+
+void DisplayScheduler::add(Visualizer* visualizer)
+{
+
+    if (instance == nullptr)
+        instance = new DisplayScheduler();
+
+    for (int i = 0; i < instance->clients.size(); i++)
+    {
+        if (instance->clients.getReference(i).visualizer == visualizer)
+            return;
+    }
+
+    Client client;
+    client.visualizer = visualizer;
+    client.wasShowing = visualizer->isShowing();
+
+    instance->clients.add(client);
+
+    if (! instance->isTimerRunning())
+    {
+        instance->ticksSinceRefresh = 0;
+        instance->lastRefreshTime = Time::getMillisecondCounterHiRes();
+        instance->startTimer(1000 / TICK_RATE);
+    }
+
+}
+
+void DisplayScheduler::remove(Visualizer* visualizer)
+{
+
+    if (instance == nullptr)
+        return;
+
+    for (int i = instance->clients.size(); --i >= 0;)
+    {
+        if (instance->clients.getReference(i).visualizer == visualizer)
+            instance->clients.remove(i);
+    }
+
+    // while refreshing, timerCallback() deletes it once it's done
+    if (instance->clients.size() == 0 && ! instance->isRefreshing)
+    {
+        delete instance;
+        instance = nullptr;
+    }
+
+}
+
+double DisplayScheduler::getRefreshRate()
+{
+
+    return double(TICK_RATE) / (instance != nullptr ? instance->ticksPerRefresh : 1);
+
+}
+
+void DisplayScheduler::timerCallback()
+{
+
+    if (++ticksSinceRefresh < ticksPerRefresh)
+        return;
+
+    ticksSinceRefresh = 0;
+
+    const double frameStart = Time::getMillisecondCounterHiRes();
+
+    // how late this refresh is shows how long the message thread spent on
+    // everything else since the last one, painting included
+    const double period = 1000.0 * ticksPerRefresh / TICK_RATE;
+    const double lateness = jmax(0.0, frameStart - lastRefreshTime - period);
+
+    isRefreshing = true;
+
+    // a refresh may add or remove visualizers, so the list is checked each time
+    for (int i = 0; i < clients.size(); i++)
+    {
+        Client& client = clients.getReference(i);
+        Visualizer* const visualizer = client.visualizer;
+
+        if (visualizer->isShowing())
+        {
+            if (! client.wasShowing)
+            {
+                client.wasShowing = true;
+                visualizer->refreshState();
+            }
+
+            visualizer->refresh();
+        }
+        else
+        {
+            client.wasShowing = false;
+            visualizer->skipRefresh();
+        }
+    }
+
+    isRefreshing = false;
+
+    if (clients.size() == 0)
+    {
+        instance = nullptr;
+        delete this;
+        return;
+    }
+
+    lastRefreshTime = Time::getMillisecondCounterHiRes();
+
+    adaptRate((lastRefreshTime - frameStart) + lateness);
+
+}
+
+void DisplayScheduler::adaptRate(double cost)
+{
+
+    smoothedCost += 0.2 * (cost - smoothedCost);
+
+    const double period = 1000.0 * ticksPerRefresh / TICK_RATE;
+
+    if (smoothedCost > 0.5 * period && ticksPerRefresh < TICK_RATE / MIN_REFRESH_RATE)
+    {
+        ticksPerRefresh++;
+        numCheapRefreshes = 0;
+
+        std::cout << "Display refreshes are taking " << smoothedCost << " ms; refreshing at "
+                  << getRefreshRate() << " Hz." << std::endl;
+    }
+    else if (smoothedCost < 0.25 * period && ticksPerRefresh > 1)
+    {
+        // wait for a second's worth of cheap refreshes before speeding up again
+        if (++numCheapRefreshes >= TICK_RATE / ticksPerRefresh)
+        {
+            ticksPerRefresh--;
+            numCheapRefreshes = 0;
+
+            std::cout << "Refreshing displays at " << getRefreshRate() << " Hz." << std::endl;
+        }
+    }
+    else
+    {
+        numCheapRefreshes = 0;
+    }
+
+}
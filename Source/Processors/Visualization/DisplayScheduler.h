@@ -0,0 +1,104 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef __DISPLAYSCHEDULER_H_2D7E5B19__
+#define __DISPLAYSCHEDULER_H_2D7E5B19__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+
+class Visualizer;
+
+/**
+
+  Drives the refreshes of every animating Visualizer from a single timer.
+
+  Each tick, the scheduler calls refresh() on the visualizers that are
+  showing, one after the other, so that the repaints they ask for (only of
+  the parts that changed) are painted together in the next paint pass.
+  Visualizers in tabs that aren't selected, or in windows that are hidden or
+  minimized, aren't refreshed at all; they get skipRefresh() instead, and
+  refreshState() when they come back into view.
+
+  The timer ticks at about the rate of a typical monitor. If refreshing and
+  painting take more than half of each frame, the visualizers are refreshed
+  on every second tick, then every third, and so on down to 10 Hz; the rate
+  goes back up once they take less than a quarter.
+
+  @see Visualizer
+
+*/
+
+class DisplayScheduler : private Timer
+{
+public:
+
+    /** Starts refreshing the visualizer. */
+    static void add(Visualizer* visualizer);
+
+    /** Stops refreshing the visualizer; must be called before it's deleted. */
+    static void remove(Visualizer* visualizer);
+
+    /** Returns how often the visualizers are currently refreshed, in Hz. */
+    static double getRefreshRate();
+
+private:
+
+    DisplayScheduler();
+    ~DisplayScheduler();
+
+    void timerCallback();
+
+    /** Adjusts the number of ticks per refresh to the cost of the last one. */
+    void adaptRate(double cost);
+
+    enum
+    {
+        TICK_RATE = 60,
+        MIN_REFRESH_RATE = 10
+    };
+
+    struct Client
+    {
+        Visualizer* visualizer;
+        bool wasShowing;
+    };
+
+    Array<Client> clients;
+
+    int ticksPerRefresh;
+    int ticksSinceRefresh;
+    int numCheapRefreshes;
+
+    double lastRefreshTime;
+    double smoothedCost;
+
+    bool isRefreshing;
+
+    static DisplayScheduler* instance;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DisplayScheduler);
+
+};
+
+#endif  // __DISPLAYSCHEDULER_H_2D7E5B19__
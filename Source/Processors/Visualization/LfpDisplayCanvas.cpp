@@ -120,12 +120,18 @@ LfpDisplayCanvas::LfpDisplayCanvas(LfpDisplayNode* processor_) :
 
     }
 
+    // the traces are drawn underneath the viewport's components
+    glRenderer = new LfpOpenGLRenderer(MAX_N_SAMP);
+    glRenderer->setBackground(Colour(0,18,43));
+    glRenderer->attachTo(*viewport);
 
 }
 
 LfpDisplayCanvas::~LfpDisplayCanvas()
 {
 
+    glRenderer = nullptr; // detaches it before the viewport goes
+
     deleteAndZero(screenBuffer);
 }
 
@@ -151,6 +157,9 @@ void LfpDisplayCanvas::resized()
     // std::cout << "Canvas thinks LfpDisplay should be this high: "
     //  << lfpDisplay->getTotalHeight() << std::endl;
 
+    if (glRenderer != nullptr)
+        updateRendererGrid();
+
 }
 
 void LfpDisplayCanvas::beginAnimation()
@@ -180,6 +189,9 @@ void LfpDisplayCanvas::update()
 
     refreshScreenBuffer();
 
+    if (glRenderer != nullptr)
+        glRenderer->setColumns(*screenBuffer, nChans, 0, MAX_N_SAMP);
+
     lfpDisplay->setNumChannels(nChans);
 
     // update channel names
@@ -435,12 +447,109 @@ void LfpDisplayCanvas::refresh()
 {
     updateScreenBuffer();
 
+    if (glRenderer != nullptr)
+        updateRenderer();
+
     lfpDisplay->refresh(); // redraws only the new part of the screen buffer
 
     //getPeer()->performAnyPendingRepaintsNow();
 
 }
 
+bool LfpDisplayCanvas::isRenderingWithOpenGL()
+{
+    return glRenderer != nullptr;
+}
+
+void LfpDisplayCanvas::updateRenderer()
+{
+
+    if (glRenderer->hasFailed())
+    {
+        // paint the traces in software from now on
+        glRenderer = nullptr;
+        fullredraw = true;
+        repaint();
+        return;
+    }
+
+    if (screenBufferIndex > lastScreenBufferIndex)
+        glRenderer->setColumns(*screenBuffer, nChans, lastScreenBufferIndex, screenBufferIndex);
+
+    // the layout follows scrolling, resizing and the range and spread
+    // settings, so it's cheaper to send it every time than to track them
+    const int viewY = viewport->getViewPositionY();
+    const int numChannels = lfpDisplay->channels.size();
+
+    rendererLayout.clearQuick();
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        LfpChannelDisplay* channel = lfpDisplay->channels[i];
+
+        LfpOpenGLRenderer::ChannelLayout layout;
+        layout.top = channel->getY() - viewY;
+        layout.bottom = layout.top + channel->getHeight();
+        layout.centre = float(layout.top + channel->getHeight()/2);
+        layout.pixelsPerUnit = channel->getChannelHeight() / float(channel->getRange());
+        layout.colour = lfpDisplay->channelColours[i % lfpDisplay->channelColours.size()];
+
+        rendererLayout.add(layout);
+    }
+
+    // events are marked across every channel's band, as in LfpChannelDisplay::paint()
+    Rectangle<int> columns(leftmargin, 0, lfpDisplay->getWidth() - leftmargin, 0);
+
+    if (numChannels > 0)
+    {
+        const int channelHeight = lfpDisplay->getChannelHeight();
+        const int top = int(rendererLayout.getFirst().centre) - channelHeight/2;
+        const int bottom = int(rendererLayout.getLast().centre) + channelHeight/2;
+
+        columns.setY(top);
+        columns.setHeight(bottom - top);
+    }
+
+    Colour eventColours[8];
+
+    for (int i = 0; i < 8; i++)
+    {
+        if (lfpDisplay->getEventDisplayState(i))
+            eventColours[i] = lfpDisplay->channelColours[i*2].withAlpha(0.35f);
+        else
+            eventColours[i] = Colours::transparentBlack;
+    }
+
+    glRenderer->setLayout(viewport->getWidth(), viewport->getHeight(), columns,
+                          rendererLayout, eventColours);
+
+}
+
+void LfpDisplayCanvas::updateRendererGrid()
+{
+
+    // the same lines as paint() draws behind the viewport
+    Array<Rectangle<int> > lines;
+
+    const int w = getWidth()-scrollBarThickness-leftmargin;
+    const int h = viewport->getHeight();
+
+    for (int i = 0; i < 10; i++)
+    {
+        const int x = w/10*i+leftmargin;
+
+        if (i == 5 || i == 0)
+            lines.add(Rectangle<int>(x-1, 0, 3, h));
+        else
+            lines.add(Rectangle<int>(x, 0, 1, h));
+    }
+
+    lines.add(Rectangle<int>(0, h-2, getWidth(), 2));
+
+    glRenderer->setGrid(lines, Colour(25,25,60));
+
+}
+
 void LfpDisplayCanvas::saveVisualizerParameters(XmlElement* xml)
 {
 
@@ -916,6 +1025,13 @@ void LfpChannelDisplay::paint(Graphics& g)
     }
 
 
+    if (canvas->isRenderingWithOpenGL())
+    {
+        // the centre line, the events and the trace are drawn underneath
+        fullredraw = false;
+        return;
+    }
+
     g.setColour(Colour(40,40,40));
     g.drawLine(0, getHeight()/2, getWidth(), getHeight()/2);
 
@@ -26,6 +26,7 @@
 #include "../../../JuceLibraryCode/JuceHeader.h"
 #include "../LfpDisplayNode.h"
 #include "Visualizer.h"
+#include "LfpOpenGLRenderer.h"
 
 class LfpDisplayNode;
 
@@ -39,7 +40,10 @@ class EventDisplayInterface;
 
   Displays multiple channels of continuous data.
 
-  @see LfpDisplayNode, LfpDisplayEditor
+  The traces are drawn with OpenGL when a context can be created, and by
+  the LfpChannelDisplays otherwise.
+
+  @see LfpDisplayNode, LfpDisplayEditor, LfpOpenGLRenderer
 
 */
 
@@ -83,6 +87,10 @@ public:
 
     void loadVisualizerParameters(XmlElement* xml);
 
+    /** Returns true if the traces are drawn by an LfpOpenGLRenderer, rather
+        than by the channels' paint() methods. */
+    bool isRenderingWithOpenGL();
+
     //void scrollBarMoved(ScrollBar *scrollBarThatHasMoved, double newRangeStart);
 
     bool fullredraw; // used to indicate that a full redraw is required. is set false after each full redraw, there is a similar switch for ach ch display;
@@ -122,6 +130,12 @@ private:
     void refreshScreenBuffer();
     void updateScreenBuffer();
 
+    void updateRenderer();
+    void updateRendererGrid();
+
+    ScopedPointer<LfpOpenGLRenderer> glRenderer;
+    Array<LfpOpenGLRenderer::ChannelLayout> rendererLayout;
+
     int displayBufferIndex;
     int displayBufferSize;
 
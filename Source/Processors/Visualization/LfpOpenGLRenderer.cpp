@@ -0,0 +1,804 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "LfpOpenGLRenderer.h"
+
+#include <iostream>
+
+// not all platforms' gl.h go past OpenGL 1.1
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER         0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STREAM_DRAW          0x88E0
+#define GL_STATIC_DRAW          0x88E4
+#define GL_DYNAMIC_DRAW         0x88E8
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_FRAGMENT_SHADER  0x8B30
+#define GL_VERTEX_SHADER    0x8B31
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE    0x812F
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0         0x84C0
+#endif
+
+/** How long the context has, once the viewport is showing, to get going. */
+static const double startupTimeout = 3000.0;
+
+/** The most channels drawn by one call; it sizes the trace shader's arrays,
+    which stay well inside OpenGL ES's 128 vertex uniform vectors. */
+static const int maxTracesPerDraw = 32;
+
+// OpenGL ES 2 only promises 16-bit indices, which limits how many channels'
+// columns one call can reach
+#if JUCE_OPENGL_ES
+typedef GLushort TraceIndex;
+static const GLenum traceIndexType = GL_UNSIGNED_SHORT;
+static const int maxTraceVertices = 0x10000;
+#else
+typedef GLuint TraceIndex;
+static const GLenum traceIndexType = GL_UNSIGNED_INT;
+static const int maxTraceVertices = 0x7fffffff;
+#endif
+
+static const char* const precision =
+    "#ifdef GL_ES\n"
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    "precision highp float;\n"
+    "#else\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "#endif\n";
+
+// each vertex is one column of one of the call's channels; a channel's layout
+// is (centre, pixelsPerUnit, top, bottom), and its band is passed on in
+// window coordinates, for the fragment shader to clip to as the scissor did
+static const char* const traceVertexShader =
+    "attribute float column;\n"
+    "attribute float channel;\n"
+    "attribute float value;\n"
+    "uniform vec2 screenSize;\n"
+    "uniform float left;\n"
+    "uniform float scale;\n"
+    "uniform vec4 layouts[32];\n"
+    "uniform vec3 colours[32];\n"
+    "varying vec3 traceColour;\n"
+    "varying vec2 band;\n"
+    "void main()\n"
+    "{\n"
+    "    int c = int(channel + 0.5);\n"
+    "    vec4 place = layouts[c];\n"
+    "    traceColour = colours[c];\n"
+    "    band = (screenSize.y - place.wz) * scale;\n"
+    "    vec2 position = vec2(left + column + 0.5, place.x + value * place.y);\n"
+    "    gl_Position = vec4(2.0 * position.x / screenSize.x - 1.0,\n"
+    "                       1.0 - 2.0 * position.y / screenSize.y, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* const traceFragmentShader =
+    "varying vec3 traceColour;\n"
+    "varying vec2 band;\n"
+    "void main()\n"
+    "{\n"
+    "    if (gl_FragCoord.y < band.x || gl_FragCoord.y > band.y)\n"
+    "        discard;\n"
+    "    gl_FragColor = vec4(traceColour, 1.0);\n"
+    "}\n";
+
+static const char* const lineVertexShader =
+    "attribute vec2 position;\n"
+    "uniform vec2 screenSize;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = vec4(2.0 * position.x / screenSize.x - 1.0,\n"
+    "                       1.0 - 2.0 * position.y / screenSize.y, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* const lineFragmentShader =
+    "uniform vec4 colour;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = colour;\n"
+    "}\n";
+
+static const char* const eventVertexShader =
+    "attribute vec2 corner;\n"
+    "uniform vec2 screenSize;\n"
+    "uniform vec4 area;\n"
+    "varying float column;\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 position = area.xy + corner * area.zw;\n"
+    "    column = corner.x * area.z;\n"
+    "    gl_Position = vec4(2.0 * position.x / screenSize.x - 1.0,\n"
+    "                       1.0 - 2.0 * position.y / screenSize.y, 0.0, 1.0);\n"
+    "}\n";
+
+// each event channel that's on in a column lays its translucent colour over
+// the others, as the software renderer's lines did; the result is
+// premultiplied, and transparent where there are no events
+static const char* const eventFragmentShader =
+    "uniform sampler2D events;\n"
+    "uniform float stride;\n"
+    "uniform vec4 eventColours[8];\n"
+    "varying float column;\n"
+    "void main()\n"
+    "{\n"
+    "    float state = floor(texture2D(events, vec2((floor(column) + 0.5) / stride, 0.5)).a * 255.0 + 0.5);\n"
+    "    vec4 colour = vec4(0.0);\n"
+    "    for (int k = 0; k < 8; k++)\n"
+    "    {\n"
+    "        float alpha = mod(floor(state / exp2(float(k))), 2.0) * eventColours[k].a;\n"
+    "        colour = colour * (1.0 - alpha) + vec4(eventColours[k].rgb * alpha, alpha);\n"
+    "    }\n"
+    "    gl_FragColor = colour;\n"
+    "}\n";
+
+static OpenGLShaderProgram* createProgram(OpenGLContext& context,
+                                          const char* vertexShader,
+                                          const char* fragmentShader)
+{
+    ScopedPointer<OpenGLShaderProgram> program(new OpenGLShaderProgram(context));
+
+    if (program->addShader(vertexShader, GL_VERTEX_SHADER)
+        && program->addShader((String(precision) + fragmentShader).toUTF8(), GL_FRAGMENT_SHADER)
+        && program->link())
+    {
+        return program.release();
+    }
+
+    std::cout << "LFP display shader error: " << program->getLastError() << std::endl;
+
+    return nullptr;
+}
+
+struct LfpOpenGLRenderer::TraceShader
+{
+    TraceShader(OpenGLContext& c, OpenGLShaderProgram* p)
+        : context(c), program(p),
+          column(getAttribute("column")), channel(getAttribute("channel")),
+          value(getAttribute("value")),
+          screenSize(getUniform("screenSize")), left(getUniform("left")),
+          scale(getUniform("scale"))
+    {
+        for (int i = 0; i < maxTracesPerDraw; i++)
+        {
+            layouts[i] = getUniform(("layouts[" + String(i) + "]").toUTF8());
+            colours[i] = getUniform(("colours[" + String(i) + "]").toUTF8());
+        }
+    }
+
+    GLint getAttribute(const char* name)
+    {
+        return context.extensions.glGetAttribLocation(program->programID, name);
+    }
+
+    GLint getUniform(const char* name)
+    {
+        return context.extensions.glGetUniformLocation(program->programID, name);
+    }
+
+    OpenGLContext& context;
+    ScopedPointer<OpenGLShaderProgram> program;
+    GLint column, channel, value;
+    GLint screenSize, left, scale;
+    GLint layouts[maxTracesPerDraw], colours[maxTracesPerDraw];
+};
+
+struct LfpOpenGLRenderer::LineShader
+{
+    LineShader(OpenGLContext& c, OpenGLShaderProgram* p)
+        : context(c), program(p),
+          position(context.extensions.glGetAttribLocation(p->programID, "position")),
+          screenSize(getUniform("screenSize")), colour(getUniform("colour"))
+    {
+    }
+
+    GLint getUniform(const char* name)
+    {
+        return context.extensions.glGetUniformLocation(program->programID, name);
+    }
+
+    OpenGLContext& context;
+    ScopedPointer<OpenGLShaderProgram> program;
+    GLint position;
+    GLint screenSize, colour;
+};
+
+struct LfpOpenGLRenderer::EventShader
+{
+    EventShader(OpenGLContext& c, OpenGLShaderProgram* p)
+        : context(c), program(p),
+          corner(context.extensions.glGetAttribLocation(p->programID, "corner")),
+          screenSize(getUniform("screenSize")), area(getUniform("area")),
+          events(getUniform("events")), stride(getUniform("stride"))
+    {
+        for (int i = 0; i < 8; i++)
+            eventColours[i] = getUniform(("eventColours[" + String(i) + "]").toUTF8());
+    }
+
+    GLint getUniform(const char* name)
+    {
+        return context.extensions.glGetUniformLocation(program->programID, name);
+    }
+
+    OpenGLContext& context;
+    ScopedPointer<OpenGLShaderProgram> program;
+    GLint corner;
+    GLint screenSize, area, events, stride;
+    GLint eventColours[8];
+};
+
+LfpOpenGLRenderer::LfpOpenGLRenderer(int maxColumns)
+    : state(STARTING), showTime(0.0), stride(maxColumns), numChannels(0),
+      dirtyFrom(0), dirtyTo(0), buffersNeedResize(true),
+      width(0), height(0), background(Colours::black),
+      tracesPerDraw(jlimit(1, maxTracesPerDraw, maxTraceVertices / jmax(1, maxColumns))),
+      columnBuffer(0), channelBuffer(0), valueBuffer(0), indexBuffer(0),
+      centreBuffer(0), cornerBuffer(0), eventTexture(0), bufferChannels(0), indexedColumns(0)
+{
+
+    events.calloc(stride);
+
+    context.setRenderer(this);
+    context.setComponentPaintingEnabled(true);
+
+}
+
+LfpOpenGLRenderer::~LfpOpenGLRenderer()
+{
+
+    detach();
+
+}
+
+void LfpOpenGLRenderer::attachTo(Component& component)
+{
+
+    context.attachTo(component);
+
+}
+
+void LfpOpenGLRenderer::detach()
+{
+
+    context.detach();
+
+}
+
+bool LfpOpenGLRenderer::isReady() const
+{
+
+    return state.get() == READY;
+
+}
+
+bool LfpOpenGLRenderer::hasFailed()
+{
+
+    const int s = state.get();
+
+    if (s == FAILED)
+        return true;
+
+    if (s == READY)
+    {
+        showTime = 0.0;
+        return false;
+    }
+
+    const double now = Time::getMillisecondCounterHiRes();
+
+    if (showTime == 0.0)
+    {
+        showTime = now;
+    }
+    else if (now - showTime > startupTimeout)
+    {
+        std::cout << "No OpenGL context for the LFP display; drawing it in software." << std::endl;
+        state.set(FAILED);
+        return true;
+    }
+
+    return false;
+
+}
+
+void LfpOpenGLRenderer::setLayout(int width_, int height_, const Rectangle<int>& columnArea_,
+                                  const Array<ChannelLayout>& channels_,
+                                  const Colour* eventColours_)
+{
+
+    const ScopedLock sl(lock);
+
+    width = width_;
+    height = height_;
+    columnArea = columnArea_.withWidth(jlimit(0, stride, columnArea_.getWidth()));
+    channels = channels_;
+
+    for (int i = 0; i < 8; i++)
+        eventColours[i] = eventColours_[i];
+
+}
+
+void LfpOpenGLRenderer::setGrid(const Array<Rectangle<int> >& lines, Colour colour)
+{
+
+    const ScopedLock sl(lock);
+
+    gridLines = lines;
+    gridColour = colour;
+
+}
+
+void LfpOpenGLRenderer::setColumns(const AudioSampleBuffer& screenBuffer, int numChannels_,
+                                   int from, int to)
+{
+
+    const ScopedLock sl(lock);
+
+    if (numChannels_ != numChannels)
+    {
+        numChannels = numChannels_;
+        values.calloc(jmax(1, numChannels) * stride);
+        buffersNeedResize = true;
+
+        from = 0;
+        to = stride;
+    }
+
+    from = jmax(0, from);
+    to = jmin(jmin(to, stride), screenBuffer.getNumSamples());
+
+    if (from >= to)
+        return;
+
+    for (int c = 0; c < numChannels; c++)
+        memcpy(values + c * stride + from, screenBuffer.getSampleData(c, from), (to - from) * sizeof(float));
+
+    const float* const eventStates = screenBuffer.getSampleData(numChannels, from);
+
+    for (int i = 0; i < to - from; i++)
+        events[from + i] = (uint8) (int(eventStates[i]) & 0xff);
+
+    if (dirtyFrom < dirtyTo)
+    {
+        dirtyFrom = jmin(dirtyFrom, from);
+        dirtyTo = jmax(dirtyTo, to);
+    }
+    else
+    {
+        dirtyFrom = from;
+        dirtyTo = to;
+    }
+
+}
+
+void LfpOpenGLRenderer::setBackground(Colour colour)
+{
+
+    const ScopedLock sl(lock);
+
+    background = colour;
+
+}
+
+void LfpOpenGLRenderer::newOpenGLContextCreated()
+{
+
+    if (state.get() == FAILED)
+        return;
+
+    if (! context.areShadersAvailable() || ! buildShaders())
+    {
+        std::cout << "OpenGL shaders aren't available for the LFP display; drawing it in software." << std::endl;
+        state.set(FAILED);
+        return;
+    }
+
+    // the column and channel of each vertex of a draw call's channels, which
+    // lie one after another in the value buffer, as in the screen buffer
+    const int numVertices = tracesPerDraw * stride;
+    HeapBlock<float> vertices(numVertices);
+
+    for (int i = 0; i < numVertices; i++)
+        vertices[i] = (float) (i % stride);
+
+    context.extensions.glGenBuffers(1, &columnBuffer);
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, columnBuffer);
+    context.extensions.glBufferData(GL_ARRAY_BUFFER, numVertices * sizeof(float), vertices, GL_STATIC_DRAW);
+
+    for (int i = 0; i < numVertices; i++)
+        vertices[i] = (float) (i / stride);
+
+    context.extensions.glGenBuffers(1, &channelBuffer);
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, channelBuffer);
+    context.extensions.glBufferData(GL_ARRAY_BUFFER, numVertices * sizeof(float), vertices, GL_STATIC_DRAW);
+
+    const GLfloat corners[] = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+
+    context.extensions.glGenBuffers(1, &cornerBuffer);
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    context.extensions.glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+
+    context.extensions.glGenBuffers(1, &valueBuffer);
+    context.extensions.glGenBuffers(1, &indexBuffer);
+    context.extensions.glGenBuffers(1, &centreBuffer);
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    indexedColumns = 0;
+
+    glGenTextures(1, &eventTexture);
+    glBindTexture(GL_TEXTURE_2D, eventTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    {
+        const ScopedLock sl(lock);
+        buffersNeedResize = true;
+    }
+
+    state.set(READY);
+
+}
+
+bool LfpOpenGLRenderer::buildShaders()
+{
+
+    OpenGLShaderProgram* trace = createProgram(context, traceVertexShader, traceFragmentShader);
+
+    if (trace == nullptr)
+        return false;
+
+    traceShader = new TraceShader(context, trace);
+
+    OpenGLShaderProgram* event = createProgram(context, eventVertexShader, eventFragmentShader);
+
+    if (event == nullptr)
+        return false;
+
+    eventShader = new EventShader(context, event);
+
+    OpenGLShaderProgram* line = createProgram(context, lineVertexShader, lineFragmentShader);
+
+    if (line == nullptr)
+        return false;
+
+    lineShader = new LineShader(context, line);
+
+    return true;
+
+}
+
+void LfpOpenGLRenderer::openGLContextClosing()
+{
+
+    traceShader = nullptr;
+    eventShader = nullptr;
+    lineShader = nullptr;
+
+    if (columnBuffer != 0)
+    {
+        const GLuint buffers[] = { columnBuffer, channelBuffer, valueBuffer,
+                                   indexBuffer, centreBuffer, cornerBuffer };
+        context.extensions.glDeleteBuffers(6, buffers);
+        glDeleteTextures(1, &eventTexture);
+    }
+
+    columnBuffer = channelBuffer = valueBuffer = indexBuffer = centreBuffer = cornerBuffer = 0;
+    eventTexture = 0;
+    bufferChannels = 0;
+    indexedColumns = 0;
+
+    // it's created again when the viewport is shown again
+    if (state.get() == READY)
+        state.set(STARTING);
+
+}
+
+void LfpOpenGLRenderer::uploadColumns()
+{
+
+    // called with the lock held
+    if (buffersNeedResize || bufferChannels != numChannels)
+    {
+        context.extensions.glBindBuffer(GL_ARRAY_BUFFER, valueBuffer);
+        context.extensions.glBufferData(GL_ARRAY_BUFFER, jmax(1, numChannels) * stride * sizeof(float),
+                                        values, GL_DYNAMIC_DRAW);
+
+        glBindTexture(GL_TEXTURE_2D, eventTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, stride, 1, 0, GL_ALPHA, GL_UNSIGNED_BYTE, events);
+
+        bufferChannels = numChannels;
+        buffersNeedResize = false;
+    }
+    else if (dirtyFrom < dirtyTo)
+    {
+        const int n = dirtyTo - dirtyFrom;
+
+        context.extensions.glBindBuffer(GL_ARRAY_BUFFER, valueBuffer);
+
+        for (int c = 0; c < numChannels; c++)
+        {
+            const int offset = c * stride + dirtyFrom;
+            context.extensions.glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(float),
+                                               n * sizeof(float), values + offset);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, eventTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyFrom, 0, n, 1, GL_ALPHA, GL_UNSIGNED_BYTE, events + dirtyFrom);
+    }
+
+    dirtyFrom = dirtyTo = 0;
+
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+}
+
+void LfpOpenGLRenderer::renderOpenGL()
+{
+
+    if (state.get() != READY)
+    {
+        OpenGLHelpers::clear(Colours::black);
+        return;
+    }
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    const ScopedLock sl(lock);
+
+    uploadColumns();
+
+    OpenGLHelpers::clear(background);
+
+    if (width <= 0 || height <= 0)
+        return;
+
+    // the viewport is in physical pixels, the layout in logical ones
+    const float scale = viewport[2] / float(width);
+
+    glDisable(GL_DEPTH_TEST);
+
+    drawGrid(scale);
+    drawEvents();
+    drawTraces(scale);
+
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+    context.extensions.glUseProgram(0);
+
+}
+
+void LfpOpenGLRenderer::drawGrid(float scale)
+{
+
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(gridColour.getFloatRed(), gridColour.getFloatGreen(), gridColour.getFloatBlue(), 1.0f);
+
+    for (int i = 0; i < gridLines.size(); i++)
+    {
+        const Rectangle<int>& line = gridLines.getReference(i);
+
+        glScissor(roundToInt(line.getX() * scale), roundToInt((height - line.getBottom()) * scale),
+                  roundToInt(line.getWidth() * scale), roundToInt(line.getHeight() * scale));
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+
+}
+
+void LfpOpenGLRenderer::drawEvents()
+{
+
+    if (columnArea.isEmpty())
+        return;
+
+    EventShader& shader = *eventShader;
+
+    shader.program->use();
+
+    context.extensions.glUniform2f(shader.screenSize, (GLfloat) width, (GLfloat) height);
+    context.extensions.glUniform4f(shader.area, (GLfloat) columnArea.getX(), (GLfloat) columnArea.getY(),
+                                   (GLfloat) columnArea.getWidth(), (GLfloat) columnArea.getHeight());
+    context.extensions.glUniform1f(shader.stride, (GLfloat) stride);
+
+    for (int i = 0; i < 8; i++)
+    {
+        context.extensions.glUniform4f(shader.eventColours[i], eventColours[i].getFloatRed(),
+                                       eventColours[i].getFloatGreen(), eventColours[i].getFloatBlue(),
+                                       eventColours[i].getFloatAlpha());
+    }
+
+    context.extensions.glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, eventTexture);
+    context.extensions.glUniform1i(shader.events, 0);
+
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    context.extensions.glVertexAttribPointer(shader.corner, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    context.extensions.glEnableVertexAttribArray(shader.corner);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glDisable(GL_BLEND);
+    context.extensions.glDisableVertexAttribArray(shader.corner);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+}
+
+void LfpOpenGLRenderer::updateIndices(int numColumns)
+{
+
+    // each channel's columns are joined as separate segments, so that one
+    // call can draw several channels without joining them up
+    const int numIndices = tracesPerDraw * (numColumns - 1) * 2;
+    HeapBlock<TraceIndex> indices(jmax(1, numIndices));
+    TraceIndex* index = indices;
+
+    for (int c = 0; c < tracesPerDraw; c++)
+    {
+        for (int i = 0; i < numColumns - 1; i++)
+        {
+            *index++ = (TraceIndex) (c * stride + i);
+            *index++ = (TraceIndex) (c * stride + i + 1);
+        }
+    }
+
+    context.extensions.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    context.extensions.glBufferData(GL_ELEMENT_ARRAY_BUFFER, jmax(1, numIndices) * sizeof(TraceIndex),
+                                    indices, GL_STATIC_DRAW);
+
+    indexedColumns = numColumns;
+
+}
+
+void LfpOpenGLRenderer::drawTraces(float scale)
+{
+
+    const int numColumns = columnArea.getWidth();
+    const int numDrawn = jmin(channels.size(), bufferChannels);
+
+    if (numColumns < 2 || numDrawn == 0)
+        return;
+
+    // the centre lines of the channels in view, and the range of them
+    centreLines.realloc(numDrawn * 4);
+
+    const float left = columnArea.getX() + 0.5f;
+    const float right = left + numColumns - 1;
+    int numLines = 0, first = numDrawn, last = -1;
+
+    for (int c = 0; c < numDrawn; c++)
+    {
+        const ChannelLayout& channel = channels.getReference(c);
+
+        if (jmax(0, channel.top) >= jmin(height, channel.bottom))
+            continue; // scrolled out of view
+
+        first = jmin(first, c);
+        last = c;
+
+        float* const line = centreLines + numLines++ * 4;
+        line[0] = left;
+        line[1] = channel.centre;
+        line[2] = right;
+        line[3] = channel.centre;
+    }
+
+    if (numLines == 0)
+        return;
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+#if ! JUCE_OPENGL_ES
+    glEnable(GL_LINE_SMOOTH);
+#endif
+
+    // the centre lines, in one call
+    {
+        LineShader& shader = *lineShader;
+
+        shader.program->use();
+
+        context.extensions.glUniform2f(shader.screenSize, (GLfloat) width, (GLfloat) height);
+        context.extensions.glUniform4f(shader.colour, 40 / 255.0f, 40 / 255.0f, 40 / 255.0f, 1.0f);
+
+        context.extensions.glBindBuffer(GL_ARRAY_BUFFER, centreBuffer);
+        context.extensions.glBufferData(GL_ARRAY_BUFFER, numLines * 4 * sizeof(float), centreLines, GL_STREAM_DRAW);
+        context.extensions.glVertexAttribPointer(shader.position, 2, GL_FLOAT, GL_FALSE, 0, 0);
+        context.extensions.glEnableVertexAttribArray(shader.position);
+
+        glDrawArrays(GL_LINES, 0, numLines * 2);
+
+        context.extensions.glDisableVertexAttribArray(shader.position);
+    }
+
+    // the traces, in one call per tracesPerDraw channels
+    TraceShader& shader = *traceShader;
+
+    shader.program->use();
+
+    context.extensions.glUniform2f(shader.screenSize, (GLfloat) width, (GLfloat) height);
+    context.extensions.glUniform1f(shader.left, (GLfloat) columnArea.getX());
+    context.extensions.glUniform1f(shader.scale, scale);
+
+    if (indexedColumns != numColumns)
+        updateIndices(numColumns);
+
+    context.extensions.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, columnBuffer);
+    context.extensions.glVertexAttribPointer(shader.column, 1, GL_FLOAT, GL_FALSE, 0, 0);
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, channelBuffer);
+    context.extensions.glVertexAttribPointer(shader.channel, 1, GL_FLOAT, GL_FALSE, 0, 0);
+    context.extensions.glEnableVertexAttribArray(shader.column);
+    context.extensions.glEnableVertexAttribArray(shader.channel);
+    context.extensions.glEnableVertexAttribArray(shader.value);
+
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, valueBuffer);
+
+    for (int from = first; from <= last; from += tracesPerDraw)
+    {
+        const int n = jmin(tracesPerDraw, last + 1 - from);
+
+        for (int i = 0; i < n; i++)
+        {
+            const ChannelLayout& channel = channels.getReference(from + i);
+
+            // channels out of view between ones in view are clipped away entirely
+            context.extensions.glUniform4f(shader.layouts[i], channel.centre, channel.pixelsPerUnit,
+                                           (GLfloat) jmax(0, channel.top), (GLfloat) jmin(height, channel.bottom));
+            context.extensions.glUniform3f(shader.colours[i], channel.colour.getFloatRed(),
+                                           channel.colour.getFloatGreen(), channel.colour.getFloatBlue());
+        }
+
+        context.extensions.glVertexAttribPointer(shader.value, 1, GL_FLOAT, GL_FALSE, 0,
+                                                 (const GLvoid*) (pointer_sized_int) (from * stride * sizeof(float)));
+
+        glDrawElements(GL_LINES, n * (numColumns - 1) * 2, traceIndexType, 0);
+    }
+
+#if ! JUCE_OPENGL_ES
+    glDisable(GL_LINE_SMOOTH);
+#endif
+    glDisable(GL_BLEND);
+
+    context.extensions.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    context.extensions.glDisableVertexAttribArray(shader.column);
+    context.extensions.glDisableVertexAttribArray(shader.channel);
+    context.extensions.glDisableVertexAttribArray(shader.value);
+
+}
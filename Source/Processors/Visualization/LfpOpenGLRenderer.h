@@ -0,0 +1,167 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef __LFPOPENGLRENDERER_H_4C1E8A73__
+#define __LFPOPENGLRENDERER_H_4C1E8A73__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+
+/**
+
+  Draws the traces of an LfpDisplayCanvas with OpenGL.
+
+  The renderer is attached to the canvas's viewport, and draws underneath
+  the components in it, which stay transparent and only paint the sweep
+  line, the selected channel and the channel labels. It keeps every
+  channel's column of the screen buffer in one vertex buffer (one float per
+  column, so each refresh only uploads the columns that changed) and the
+  event channel in a one-row texture, and draws:
+
+  - the background and the timing grid, by clearing;
+  - the event markers as one quad, whose fragment shader picks out the
+    enabled event bits of each column;
+  - the centre lines of the channels in view, in one call;
+  - their traces, as line segments between columns, in one call for up to
+    32 channels, whose positions, scales and colours are in uniform arrays
+    that each vertex indexes by its channel. The fragment shader clips each
+    trace to its channel's band.
+
+  The canvas copies new columns and the layout in on the message thread;
+  renderOpenGL() picks them up on the context's thread.
+
+  If the context can't build its shaders, or isn't created within a few
+  seconds of the viewport being shown, hasFailed() returns true, and the
+  canvas goes back to painting the traces itself.
+
+  @see LfpDisplayCanvas
+
+*/
+
+class LfpOpenGLRenderer : public OpenGLRenderer
+{
+public:
+
+    LfpOpenGLRenderer(int maxColumns);
+    ~LfpOpenGLRenderer();
+
+    /** Starts rendering underneath the component. */
+    void attachTo(Component& component);
+
+    /** Stops rendering. */
+    void detach();
+
+    /** Returns true once the context is up and the shaders are built. */
+    bool isReady() const;
+
+    /** Returns true if OpenGL isn't going to work. Call this regularly
+        while the component is showing, as it also times the startup. */
+    bool hasFailed();
+
+    /** Where, and how, a channel is drawn, in the attached component. */
+    struct ChannelLayout
+    {
+        int top, bottom;        // the trace is clipped to these
+        float centre;           // the y position of zero
+        float pixelsPerUnit;    // positive values are drawn downwards
+        Colour colour;
+    };
+
+    /** Sets the size of the attached component, the area the columns are
+        drawn in (one pixel each, from its left edge; events are marked over
+        its full height), each channel's layout, and the colours of the eight
+        event channels (transparent if they aren't shown). */
+    void setLayout(int width, int height, const Rectangle<int>& columnArea,
+                   const Array<ChannelLayout>& channels,
+                   const Colour* eventColours);
+
+    /** Sets the lines of the timing grid, which are drawn behind everything. */
+    void setGrid(const Array<Rectangle<int> >& lines, Colour colour);
+
+    /** Copies columns [from, to) of the screen buffer: the channels, and the
+        event states that follow them. */
+    void setColumns(const AudioSampleBuffer& screenBuffer, int numChannels, int from, int to);
+
+    /** Sets the colour behind the traces. */
+    void setBackground(Colour colour);
+
+    void newOpenGLContextCreated();
+    void renderOpenGL();
+    void openGLContextClosing();
+
+private:
+
+    enum State
+    {
+        STARTING,
+        READY,
+        FAILED
+    };
+
+    bool buildShaders();
+    void uploadColumns();
+    void drawGrid(float scale);
+    void drawEvents();
+    void drawTraces(float scale);
+    void updateIndices(int numColumns);
+
+    OpenGLContext context;
+    Atomic<int> state;
+    double showTime;
+
+    /** Everything below the lock is shared with the context's thread. */
+    CriticalSection lock;
+
+    const int stride;
+    int numChannels;
+    HeapBlock<float> values;
+    HeapBlock<uint8> events;
+    int dirtyFrom, dirtyTo;
+    bool buffersNeedResize;
+
+    int width, height;
+    Rectangle<int> columnArea;
+    Array<ChannelLayout> channels;
+    Colour eventColours[8];
+    Colour background;
+    Array<Rectangle<int> > gridLines;
+    Colour gridColour;
+
+    // used only on the context's thread
+    struct TraceShader;
+    struct EventShader;
+    struct LineShader;
+    ScopedPointer<TraceShader> traceShader;
+    ScopedPointer<EventShader> eventShader;
+    ScopedPointer<LineShader> lineShader;
+    const int tracesPerDraw;
+    GLuint columnBuffer, channelBuffer, valueBuffer, indexBuffer, centreBuffer, cornerBuffer;
+    GLuint eventTexture;
+    int bufferChannels, indexedColumns;
+    HeapBlock<float> centreLines;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LfpOpenGLRenderer);
+
+};
+
+#endif  // __LFPOPENGLRENDERER_H_4C1E8A73__
@@ -0,0 +1,376 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SpectrumCanvas.h"
+
+#include <math.h>
+
+SpectrumCanvas::SpectrumCanvas(SpectrumNode* processor_) :
+    processor(processor_), spectra(1, 1), binWidth(1.0f), lastSpectrumCount(0),
+    selectedChannel(0), maxDecibels(0.0f), dynamicRange(60.0f), maxFrequency(300.0f)
+{
+
+    fftSizes.add("256");
+    fftSizes.add("512");
+    fftSizes.add("1024");
+    fftSizes.add("2048");
+    fftSizes.add("4096");
+    fftSizes.add("8192");
+
+    averages.add("1");
+    averages.add("2");
+    averages.add("4");
+    averages.add("8");
+    averages.add("16");
+    averages.add("32");
+
+    frequencies.add("100");
+    frequencies.add("300");
+    frequencies.add("1000");
+    frequencies.add("3000");
+    frequencies.add("10000");
+
+    ranges.add("20");
+    ranges.add("40");
+    ranges.add("60");
+    ranges.add("80");
+    ranges.add("100");
+
+    fftSizeSelection = new ComboBox("FFT size");
+    fftSizeSelection->addItemList(fftSizes, 1);
+    fftSizeSelection->setSelectedId(4, false);
+    fftSizeSelection->addListener(this);
+    addAndMakeVisible(fftSizeSelection);
+
+    averagesSelection = new ComboBox("Averages");
+    averagesSelection->addItemList(averages, 1);
+    averagesSelection->setSelectedId(4, false);
+    averagesSelection->addListener(this);
+    addAndMakeVisible(averagesSelection);
+
+    frequencySelection = new ComboBox("Max frequency");
+    frequencySelection->addItemList(frequencies, 1);
+    frequencySelection->setSelectedId(2, false);
+    frequencySelection->addListener(this);
+    addAndMakeVisible(frequencySelection);
+
+    rangeSelection = new ComboBox("Range");
+    rangeSelection->addItemList(ranges, 1);
+    rangeSelection->setSelectedId(3, false);
+    rangeSelection->addListener(this);
+    addAndMakeVisible(rangeSelection);
+
+}
+
+SpectrumCanvas::~SpectrumCanvas()
+{
+
+}
+
+void SpectrumCanvas::beginAnimation()
+{
+    std::cout << "Beginning animation." << std::endl;
+
+    lastSpectrumCount = processor->getSpectrumCount();
+
+    startCallbacks();
+}
+
+void SpectrumCanvas::endAnimation()
+{
+    std::cout << "Ending animation." << std::endl;
+
+    stopCallbacks();
+}
+
+void SpectrumCanvas::update()
+{
+    selectedChannel = 0;
+    channels.clear();
+    spectrogram = Image::null;
+
+    repaint();
+}
+
+void SpectrumCanvas::refreshState()
+{
+    updateImage();
+    repaint();
+}
+
+void SpectrumCanvas::refresh()
+{
+    const int count = processor->getSpectrumCount();
+
+    if (count == lastSpectrumCount)
+        return;
+
+    lastSpectrumCount = count;
+
+    if (processor->getSpectra(spectra, channels, binWidth))
+    {
+        selectedChannel = jlimit(0, jmax(0, channels.size() - 1), selectedChannel);
+
+        updateImage();
+        repaint();
+    }
+}
+
+void SpectrumCanvas::resized()
+{
+
+    const int controlHeight = 30;
+    const int leftMargin = 50;
+    const int axisHeight = 20;
+
+    const int h = getHeight() - controlHeight - 2 * axisHeight;
+
+    mapArea = Rectangle<int>(leftMargin, 10, getWidth() - leftMargin - 10, h * 3 / 5 - 10);
+    plotArea = Rectangle<int>(leftMargin, mapArea.getBottom() + axisHeight + 10,
+                              getWidth() - leftMargin - 10, h * 2 / 5 - 10);
+
+    fftSizeSelection->setBounds(5, getHeight() - 30, 100, 25);
+    averagesSelection->setBounds(110, getHeight() - 30, 100, 25);
+    frequencySelection->setBounds(215, getHeight() - 30, 100, 25);
+    rangeSelection->setBounds(320, getHeight() - 30, 100, 25);
+
+}
+
+void SpectrumCanvas::comboBoxChanged(ComboBox* cb)
+{
+
+    if (cb == fftSizeSelection)
+    {
+        processor->setParameter(0, fftSizes[cb->getSelectedId()-1].getFloatValue());
+    }
+    else if (cb == averagesSelection)
+    {
+        processor->setParameter(1, averages[cb->getSelectedId()-1].getFloatValue());
+    }
+    else if (cb == frequencySelection)
+    {
+        maxFrequency = frequencies[cb->getSelectedId()-1].getFloatValue();
+    }
+    else if (cb == rangeSelection)
+    {
+        dynamicRange = ranges[cb->getSelectedId()-1].getFloatValue();
+    }
+
+    updateImage();
+    repaint();
+
+}
+
+void SpectrumCanvas::mouseDown(const MouseEvent& event)
+{
+
+    if (mapArea.contains(event.x, event.y) && channels.size() > 0)
+    {
+        selectedChannel = (event.y - mapArea.getY()) * channels.size() / mapArea.getHeight();
+        selectedChannel = jlimit(0, channels.size() - 1, selectedChannel);
+
+        repaint();
+    }
+
+}
+
+int SpectrumCanvas::getNumDisplayedBins()
+{
+    const int numBins = int(maxFrequency / binWidth) + 1;
+
+    return jlimit(1, spectra.getNumSamples(), numBins);
+}
+
+float SpectrumCanvas::getDecibels(int chan, int bin)
+{
+    return 10.0f * log10f(*spectra.getSampleData(chan, bin) + 1e-20f);
+}
+
+void SpectrumCanvas::updateImage()
+{
+
+    if (channels.size() == 0 || spectra.getNumChannels() < channels.size())
+    {
+        spectrogram = Image::null;
+        return;
+    }
+
+    const int numChannels = channels.size();
+    const int numBins = getNumDisplayedBins();
+
+    // the colour scale follows the loudest bin on screen, skipping DC
+    maxDecibels = -200.0f;
+
+    for (int chan = 0; chan < numChannels; chan++)
+    {
+        for (int bin = 1; bin < numBins; bin++)
+            maxDecibels = jmax(maxDecibels, getDecibels(chan, bin));
+    }
+
+    if (spectrogram.getWidth() != numBins || spectrogram.getHeight() != numChannels)
+        spectrogram = Image(Image::RGB, numBins, numChannels, false);
+
+    const Image::BitmapData data(spectrogram, Image::BitmapData::writeOnly);
+
+    for (int chan = 0; chan < numChannels; chan++)
+    {
+        for (int bin = 0; bin < numBins; bin++)
+        {
+            const float level = jlimit(0.0f, 1.0f,
+                                       1.0f + (getDecibels(chan, bin) - maxDecibels) / dynamicRange);
+
+            data.setPixelColour(bin, chan, Colour(0.7f * (1.0f - level), 0.9f, level, 1.0f));
+        }
+    }
+
+}
+
+void SpectrumCanvas::paint(Graphics& g)
+{
+
+    g.setColour(Colour(0,18,43)); //background color
+    g.fillRect(0, 0, getWidth(), getHeight());
+
+    g.setGradientFill(ColourGradient(Colour(50,50,50),0,getHeight()-35,
+                                     Colour(25,25,25),0,getHeight(),
+                                     false));
+
+    g.fillRect(0, getHeight()-35, getWidth(), 35);
+
+    g.setFont(Font("Default", 12, Font::plain));
+
+    if (spectrogram.isNull())
+    {
+        g.setColour(Colour(100,100,100));
+        g.drawText("No spectra yet: select channels in the editor and start acquisition.",
+                   mapArea, Justification::centred, true);
+        return;
+    }
+
+    const int numChannels = channels.size();
+    const int numBins = getNumDisplayedBins();
+
+    // channel map
+    g.setImageResamplingQuality(Graphics::lowResamplingQuality);
+    g.drawImage(spectrogram, mapArea.getX(), mapArea.getY(), mapArea.getWidth(), mapArea.getHeight(),
+                0, 0, spectrogram.getWidth(), spectrogram.getHeight());
+
+    const float rowHeight = float(mapArea.getHeight()) / float(numChannels);
+
+    g.setColour(Colours::white);
+    g.drawRect(mapArea.getX(), int(mapArea.getY() + selectedChannel * rowHeight),
+               mapArea.getWidth(), jmax(1, int(rowHeight)), 1);
+
+    g.setColour(Colour(100,100,100));
+
+    const int labelStep = jmax(1, int(12.0f / rowHeight) + 1);
+
+    for (int chan = 0; chan < numChannels; chan += labelStep)
+    {
+        g.drawText(String(channels[chan] + 1), 0, int(mapArea.getY() + chan * rowHeight),
+                   mapArea.getX() - 5, jmax(12, int(rowHeight)), Justification::right, false);
+    }
+
+    drawFrequencyAxis(g, mapArea);
+
+    // spectrum of the selected channel
+    g.setColour(Colour(25,25,60));
+    g.fillRect(plotArea);
+
+    Path spectrum;
+
+    for (int bin = 0; bin < numBins; bin++)
+    {
+        const float x = plotArea.getX() + plotArea.getWidth() * float(bin) / float(jmax(1, numBins - 1));
+        const float level = jlimit(0.0f, 1.0f,
+                                   1.0f + (getDecibels(selectedChannel, bin) - maxDecibels) / dynamicRange);
+        const float y = plotArea.getBottom() - level * plotArea.getHeight();
+
+        if (bin == 0)
+            spectrum.startNewSubPath(x, y);
+        else
+            spectrum.lineTo(x, y);
+    }
+
+    g.setColour(Colours::yellow);
+    g.strokePath(spectrum, PathStrokeType(1.0f));
+
+    g.setColour(Colour(100,100,100));
+    g.drawText(String(maxDecibels, 0) + " dB", 0, plotArea.getY(), plotArea.getX() - 5, 12,
+               Justification::right, false);
+    g.drawText(String(maxDecibels - dynamicRange, 0) + " dB", 0, plotArea.getBottom() - 12,
+               plotArea.getX() - 5, 12, Justification::right, false);
+    g.drawText("Ch " + String(channels[selectedChannel] + 1), plotArea.getX() + 5, plotArea.getY() + 2,
+               100, 12, Justification::left, false);
+
+    drawFrequencyAxis(g, plotArea);
+
+}
+
+void SpectrumCanvas::drawFrequencyAxis(Graphics& g, Rectangle<int> area)
+{
+
+    const float displayedFrequency = (getNumDisplayedBins() - 1) * binWidth;
+
+    if (displayedFrequency <= 0.0f)
+        return;
+
+    g.setColour(Colour(100,100,100));
+
+    for (int i = 0; i <= 5; i++)
+    {
+        const int x = area.getX() + area.getWidth() * i / 5;
+
+        g.drawLine(x, area.getBottom(), x, area.getBottom() + 4);
+        g.drawText(String(displayedFrequency * i / 5, 0) + " Hz", x - 40, area.getBottom() + 4, 80, 14,
+                   Justification::centred, false);
+    }
+
+}
+
+void SpectrumCanvas::saveVisualizerParameters(XmlElement* xml)
+{
+
+    XmlElement* xmlNode = xml->createNewChildElement("SPECTRUM");
+
+    xmlNode->setAttribute("FftSize",fftSizeSelection->getSelectedId());
+    xmlNode->setAttribute("Averages",averagesSelection->getSelectedId());
+    xmlNode->setAttribute("MaxFrequency",frequencySelection->getSelectedId());
+    xmlNode->setAttribute("Range",rangeSelection->getSelectedId());
+
+}
+
+void SpectrumCanvas::loadVisualizerParameters(XmlElement* xml)
+{
+    forEachXmlChildElement(*xml, xmlNode)
+    {
+        if (xmlNode->hasTagName("SPECTRUM"))
+        {
+            fftSizeSelection->setSelectedId(xmlNode->getIntAttribute("FftSize", 4));
+            averagesSelection->setSelectedId(xmlNode->getIntAttribute("Averages", 4));
+            frequencySelection->setSelectedId(xmlNode->getIntAttribute("MaxFrequency", 2));
+            rangeSelection->setSelectedId(xmlNode->getIntAttribute("Range", 3));
+        }
+    }
+
+}
@@ -0,0 +1,118 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SPECTRUMCANVAS_H_A37D5C12__
+#define __SPECTRUMCANVAS_H_A37D5C12__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "../SpectrumNode.h"
+#include "Visualizer.h"
+
+class SpectrumNode;
+
+/**
+
+  Displays the power spectral densities computed by a SpectrumNode.
+
+  The upper panel is a map of every analysed channel (one row each)
+  against frequency, coloured by power in dB. The lower panel plots the
+  spectrum of the channel last clicked in the map.
+
+  @see SpectrumNode, SpectrumEditor
+
+*/
+
+class SpectrumCanvas : public Visualizer,
+    public ComboBox::Listener
+
+{
+public:
+    SpectrumCanvas(SpectrumNode* n);
+    ~SpectrumCanvas();
+
+    void beginAnimation();
+    void endAnimation();
+
+    void refreshState();
+
+    void update();
+
+    void setParameter(int, float) {}
+    void setParameter(int, int, int, float) {}
+
+    void paint(Graphics& g);
+
+    void refresh();
+
+    void resized();
+
+    void mouseDown(const MouseEvent& event);
+
+    void comboBoxChanged(ComboBox* cb);
+
+    void saveVisualizerParameters(XmlElement* xml);
+
+    void loadVisualizerParameters(XmlElement* xml);
+
+private:
+
+    void updateImage();
+
+    int getNumDisplayedBins();
+    float getDecibels(int chan, int bin);
+
+    void drawFrequencyAxis(Graphics& g, Rectangle<int> area);
+
+    SpectrumNode* processor;
+
+    AudioSampleBuffer spectra;
+    Array<int> channels;
+    float binWidth;
+    int lastSpectrumCount;
+
+    Image spectrogram;
+
+    int selectedChannel;
+    float maxDecibels;
+    float dynamicRange;
+    float maxFrequency;
+
+    Rectangle<int> mapArea;
+    Rectangle<int> plotArea;
+
+    ScopedPointer<ComboBox> fftSizeSelection;
+    ScopedPointer<ComboBox> averagesSelection;
+    ScopedPointer<ComboBox> frequencySelection;
+    ScopedPointer<ComboBox> rangeSelection;
+
+    StringArray fftSizes;
+    StringArray averages;
+    StringArray frequencies;
+    StringArray ranges;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumCanvas);
+
+};
+
+
+#endif  // __SPECTRUMCANVAS_H_A37D5C12__
@@ -28,8 +28,6 @@ SpikeDisplayCanvas::SpikeDisplayCanvas(SpikeDisplayNode* n) :
     processor(n), newSpike(false)
 {
 
-    spikeBuffer = processor->getSpikeBufferAddress();
-
     viewport = new Viewport();
     spikeDisplay = new SpikeDisplay(this, viewport);
 
@@ -116,7 +114,12 @@ void SpikeDisplayCanvas::refresh()
 {
     processSpikeEvents();
 
-    repaint();
+    spikeDisplay->repaintUpdatedPlots();
+}
+
+void SpikeDisplayCanvas::skipRefresh()
+{
+    processSpikeEvents();
 }
 
 void SpikeDisplayCanvas::startRecording()
@@ -151,39 +154,13 @@ RecordNode* SpikeDisplayCanvas::getRecordNode()
 
 void SpikeDisplayCanvas::processSpikeEvents()
 {
+    SpikeObject newSpike;
 
- 
-    if (spikeBuffer->getNumEvents() > 0)
+    while (processor->getNextSpike(newSpike))
     {
-
-        MidiBuffer::Iterator i(*spikeBuffer);
-        MidiMessage message(0xf4);
-
-        int samplePosition = 0;
-
-        i.setNextSamplePosition(samplePosition);
-
-        while (i.getNextEvent(message, samplePosition))
-        {
-
-            const uint8_t* dataptr = message.getRawData();
-            int bufferSize = message.getRawDataSize();
-
-            SpikeObject newSpike;
-
-            bool isValid = unpackSpike(&newSpike, dataptr, bufferSize);
-
-            int electrodeNum = newSpike.source;
-
-            if (isValid)
-                spikeDisplay->plotSpike(newSpike, electrodeNum);
-
-        }
-
+        spikeDisplay->plotSpike(newSpike, newSpike.source);
     }
 
-    spikeBuffer->clear();
-
 }
 
 bool SpikeDisplayCanvas::keyPressed(const KeyPress& key)
@@ -404,6 +381,19 @@ void SpikeDisplay::mouseDown(const MouseEvent& event)
 void SpikeDisplay::plotSpike(const SpikeObject& spike, int electrodeNum)
 {
     spikePlots[electrodeNum]->processSpikeObject(spike);
+
+    updatedPlots.setBit(electrodeNum);
+}
+
+void SpikeDisplay::repaintUpdatedPlots()
+{
+    for (int i = updatedPlots.findNextSetBit(0); i >= 0 && i < spikePlots.size();
+         i = updatedPlots.findNextSetBit(i + 1))
+    {
+        spikePlots[i]->repaint();
+    }
+
+    updatedPlots.clear();
 }
 
 
@@ -512,6 +502,9 @@ void SpikePlot::processSpikeObject(const SpikeObject& s)
         for (int i = 0; i < nWaveAx; i++)
             wAxes[i]->updateSpikeData(s);
 
+        if (peakRing != nullptr)
+            peakRing->add(s);
+
         for (int i = 0; i < nProjAx; i++)
             pAxes[i]->updateSpikeData(s);
     }
@@ -694,9 +687,12 @@ void SpikePlot::initAxes()
         ranges.add(250.0f); // default range is 250 microvolts
     }
 
+    if (nProjAx > 0)
+        peakRing = new SpikePeakRing(nChannels, MAX_PROJECTION_POINTS);
+
     for (int i = 0; i < nProjAx; i++)
     {
-        ProjectionAxes* pAx = new ProjectionAxes(PROJ1x2 + i);
+        ProjectionAxes* pAx = new ProjectionAxes(PROJ1x2 + i, peakRing);
         pAxes.add(pAx);
         addAndMakeVisible(pAx);
     }
@@ -836,6 +832,9 @@ void SpikePlot::clear()
 {
     std::cout << "SpikePlot::clear()" << std::endl;
 
+    if (peakRing != nullptr)
+        peakRing->clear();
+
     for (int i = 0; i < nWaveAx; i++)
         wAxes[i]->clear();
     for (int i = 0; i < nProjAx; i++)
@@ -850,7 +849,7 @@ void SpikePlot::clear()
 WaveAxes::WaveAxes(int channel) : GenericAxes(channel), drawGrid(true),
     bufferSize(5), spikeIndex(0), thresholdLevel(0.0f), range(250.0f),
     isOverThresholdSlider(false), isDraggingThresholdSlider(false),
-    spikesReceivedSinceLastRedraw(0)
+    spikesReceivedSinceLastRedraw(0), lastDecayTime(0.0)
 {
 
     addMouseListener(this, true);
@@ -875,9 +874,24 @@ void WaveAxes::setRange(float r)
 
     range = r;
 
+    rebuildDensity();
+
     repaint();
 }
 
+void WaveAxes::resized()
+{
+
+    const int w = jmax(1, getWidth());
+    const int h = jmax(1, getHeight());
+
+    density.calloc(w*h);
+    densityImage = Image(Image::ARGB, w, h, true);
+
+    rebuildDensity();
+
+}
+
 void WaveAxes::paint(Graphics& g)
 {
     g.setColour(Colours::black);
@@ -900,16 +914,9 @@ void WaveAxes::paint(Graphics& g)
     }
 
 
-     for (int spikeNum = 0; spikeNum < bufferSize; spikeNum++)
-     {
-
-         if (spikeNum != spikeIndex)
-         {
-             g.setColour(Colours::grey);
-             plotSpike(spikeBuffer[spikeNum], g);
-         }
+    updateDensityImage();
 
-     }
+    g.drawImageAt(densityImage, 0, 0);
 
     g.setColour(Colours::white);
     plotSpike(spikeBuffer[spikeIndex], g);
@@ -994,21 +1001,129 @@ bool WaveAxes::updateSpikeData(const SpikeObject& s)
         gotFirstSpike = true;
     }
 
-    if (spikesReceivedSinceLastRedraw < bufferSize)
+    accumulateSpike(s);
+
+    // the most recent spikes, for redrawing the density at a new range
+    spikeIndex++;
+    spikeIndex %= bufferSize;
+
+    spikeBuffer.set(spikeIndex, s);
+
+    spikesReceivedSinceLastRedraw++;
+
+    return true;
+
+}
+
+void WaveAxes::accumulateSpike(const SpikeObject& s)
+{
+
+    if (densityImage.isNull())
+        return;
+
+    const int w = densityImage.getWidth();
+    const int h = densityImage.getHeight();
+
+    if (*s.gain == 0 || s.nSamples < 2)
+        return;
+
+    // the same mapping as plotSpike(), one column at a time
+    const uint16_t* const data = s.data + 40*type;
+    const float samplesPerPixel = s.nSamples / float(w);
+    const float scale = 1000.0f / float(*s.gain) / range * h;
+
+    int lastY = 0;
+
+    for (int x = 0; x < w; x++)
     {
+        const float position = x * samplesPerPixel;
+        const int i = int(position);
 
-        SpikeObject newSpike = s;
+        if (i >= s.nSamples - 1)
+            break;
+
+        const float alpha = position - i;
+        const float value = (float(data[i]) - 32768.0f) * (1.0f - alpha)
+                            + (float(data[i+1]) - 32768.0f) * alpha;
 
-        spikeIndex++;
-        spikeIndex %= bufferSize;
+        const int y = roundFloatToInt(h/2 + value * scale);
 
-        spikeBuffer.set(spikeIndex, newSpike);
+        // fill in the rows between this column's point and the last one's,
+        // so that steep edges stay connected
+        int from = y, to = y;
 
-        spikesReceivedSinceLastRedraw++;
-        
+        if (x > 0)
+        {
+            if (y > lastY)
+                from = lastY + 1;
+            else if (y < lastY)
+                to = lastY - 1;
+        }
+
+        from = jmax(from, 0);
+        to = jmin(to, h - 1);
+
+        for (int row = from; row <= to; row++)
+            density[row*w + x] += 1.0f;
+
+        lastY = y;
     }
 
-    return true;
+}
+
+void WaveAxes::rebuildDensity()
+{
+
+    if (densityImage.isNull())
+        return; // not sized yet
+
+    density.clear(densityImage.getWidth()*densityImage.getHeight());
+
+    if (!gotFirstSpike)
+        return;
+
+    for (int n = 1; n <= bufferSize; n++)
+        accumulateSpike(spikeBuffer[(spikeIndex + n) % bufferSize]);
+
+}
+
+void WaveAxes::updateDensityImage()
+{
+
+    // spikes fade to half their brightness every second
+    const double now = Time::getMillisecondCounterHiRes();
+    const float decay = lastDecayTime > 0.0 ? (float) pow(0.5, (now - lastDecayTime) / 1000.0) : 1.0f;
+
+    lastDecayTime = now;
+
+    if (densityImage.isNull())
+        return;
+
+    const int w = densityImage.getWidth();
+    const int h = densityImage.getHeight();
+
+    Image::BitmapData bitmap(densityImage, Image::BitmapData::writeOnly);
+
+    for (int y = 0; y < h; y++)
+    {
+        float* const row = density + y*w;
+        PixelARGB* const pixels = (PixelARGB*) bitmap.getLinePointer(y);
+
+        for (int x = 0; x < w; x++)
+        {
+            float d = row[x] * decay;
+
+            if (d < 0.01f)
+                d = 0.0f;
+
+            row[x] = d;
+
+            // one spike comes out grey, and many on top of each other white
+            const uint8 level = (uint8) (255.0f * d / (d + 1.5f));
+
+            pixels[x].setARGB(level, level, level, level); // premultiplied white
+        }
+    }
 
 }
 
@@ -1045,6 +1160,9 @@ void WaveAxes::clear()
         spikeBuffer.add(so);
     }
 
+    if (! densityImage.isNull())
+        density.clear(densityImage.getWidth()*densityImage.getHeight());
+
     repaint();
 }
 
@@ -1135,19 +1253,13 @@ void WaveAxes::mouseExit(const MouseEvent& event)
 
 // --------------------------------------------------
 
-ProjectionAxes::ProjectionAxes(int projectionNum) : GenericAxes(projectionNum), imageDim(500),
-    rangeX(250), rangeY(250), spikesReceivedSinceLastRedraw(0)
+ProjectionAxes::ProjectionAxes(int projectionNum, SpikePeakRing* peakRing_)
+    : GenericAxes(projectionNum), peakRing(peakRing_),
+      rangeX(250), rangeY(250), spikesReceivedSinceLastRedraw(0)
 {
-    projectionImage = Image(Image::RGB, imageDim, imageDim, true);
-
-    clear();
-    //Graphics g(projectionImage);
-    //g.setColour(Colours::red);
-    //g.fillEllipse(20, 20, 300, 200);
 
     n2ProjIdx(projectionNum, &ampDim1, &ampDim2);
 
-
 }
 
 void ProjectionAxes::setRange(float x, float y)
@@ -1157,17 +1269,26 @@ void ProjectionAxes::setRange(float x, float y)
 
     //std::cout << "Setting range to " << x << " " << y << std::endl;
 
+    redrawProjectionImage();
+
     repaint();
 }
 
+void ProjectionAxes::resized()
+{
+
+    projectionImage = Image(Image::RGB, jmax(1, getWidth()), jmax(1, getHeight()), true);
+
+    redrawProjectionImage();
+
+}
+
 void ProjectionAxes::paint(Graphics& g)
 {
     //g.setColour(Colours::orange);
     //g.fillRect(5,5,getWidth()-5, getHeight()-5);
 
-    g.drawImage(projectionImage,
-                0, 0, getWidth(), getHeight(),
-                0, imageDim-rangeY, rangeX, rangeY);
+    g.drawImageAt(projectionImage, 0, 0);
 }
 
 bool ProjectionAxes::updateSpikeData(const SpikeObject& s)
@@ -1177,60 +1298,59 @@ bool ProjectionAxes::updateSpikeData(const SpikeObject& s)
         gotFirstSpike = true;
     }
 
-    int idx1, idx2;
-    calcWaveformPeakIdx(s, ampDim1, ampDim2, &idx1, &idx2);
+    if (projectionImage.isNull() || peakRing->size() == 0)
+        return true;
 
-    // add peaks to image
+    Image::BitmapData bitmap(projectionImage, Image::BitmapData::readWrite);
 
-    updateProjectionImage(s.data[idx1], s.data[idx2], *s.gain);
+    plotPoint(bitmap, peakRing->getPeaks(peakRing->size() - 1));
 
     return true;
 }
 
-void ProjectionAxes::updateProjectionImage(uint16_t x, uint16_t y, uint16_t gain)
+void ProjectionAxes::plotPoint(Image::BitmapData& bitmap, const float* peaks)
 {
-    Graphics g(projectionImage);
 
-    // h/2 + float(s.data[sampIdx]-32768)/float(*s.gain)*1000.0f / range * h;
+    // 0 uV at the bottom left, and the range at the top right
+    const int x = int(peaks[ampDim1] / float(rangeX) * bitmap.width);
+    const int y = bitmap.height - 1 - int(peaks[ampDim2] / float(rangeY) * bitmap.height);
 
-    if (gain != 0)
+    // a two-pixel square, like the ellipses this used to draw
+    if (x < 0 || y < 0 || x + 1 >= bitmap.width || y + 1 >= bitmap.height)
+        return;
+
+    for (int row = y; row <= y + 1; row++)
     {
-        float xf = float(x-32768)/float(gain)*1000.0f; // in microvolts
-        float yf = float(imageDim) - float(y-32768)/float(gain)*1000.0f; // in microvolts
+        uint8* const pixel = bitmap.getPixelPointer(x, row);
 
-        g.setColour(Colours::white);
-        g.fillEllipse(xf,yf,2.0f,2.0f);
+        memset(pixel, 0xff, 2*bitmap.pixelStride); // white
     }
 
 }
 
-void ProjectionAxes::calcWaveformPeakIdx(const SpikeObject& s, int d1, int d2, int* idx1, int* idx2)
+void ProjectionAxes::redrawProjectionImage()
 {
 
-    int max1 = -1*pow(2.0,15);
-    int max2 = max1;
+    if (projectionImage.isNull())
+        return; // not sized yet
 
-    for (int i = 0; i < s.nSamples; i++)
-    {
-        if (s.data[d1*s.nSamples + i] > max1)
-        {
-            *idx1 = d1*s.nSamples+i;
-            max1 = s.data[*idx1];
-        }
-        if (s.data[d2*s.nSamples+i] > max2)
-        {
-            *idx2 = d2*s.nSamples+i;
-            max2 = s.data[*idx2];
-        }
-    }
-}
+    projectionImage.clear(projectionImage.getBounds(), Colours::black);
+
+    if (peakRing == nullptr)
+        return;
 
+    Image::BitmapData bitmap(projectionImage, Image::BitmapData::readWrite);
 
+    const int numPoints = peakRing->size();
+
+    for (int i = 0; i < numPoints; i++)
+        plotPoint(bitmap, peakRing->getPeaks(i));
+
+}
 
 void ProjectionAxes::clear()
 {
-    projectionImage.clear(Rectangle<int>(0, 0, projectionImage.getWidth(), projectionImage.getHeight()),
-                          Colours::black);
+    redrawProjectionImage();
 
     repaint();
 }
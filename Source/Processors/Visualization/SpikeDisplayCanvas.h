@@ -28,6 +28,7 @@
 
 #include "../SpikeDisplayNode.h"
 #include "SpikeObject.h"
+#include "SpikePeakRing.h"
 
 #include "Visualizer.h"
 #include <vector>
@@ -49,6 +50,7 @@
 
 #define MAX_NUMBER_OF_SPIKE_SOURCES 128
 #define MAX_N_CHAN 4
+#define MAX_PROJECTION_POINTS 100000
 
 class SpikeDisplayNode;
 
@@ -78,6 +80,9 @@ public:
 
     void refresh();
 
+    /** Keeps taking in spikes while hidden, so that they're still saved. */
+    void skipRefresh();
+
     void processSpikeEvents();
 
     void beginAnimation();
@@ -104,8 +109,6 @@ public:
 
 private:
 
-    MidiBuffer* spikeBuffer;
-
     ScopedPointer<SpikeDisplay> spikeDisplay;
     ScopedPointer<Viewport> viewport;
 
@@ -138,6 +141,9 @@ public:
 
     void plotSpike(const SpikeObject& spike, int electrodeNum);
 
+    /** Repaints the plots that have received spikes since the last call. */
+    void repaintUpdatedPlots();
+
     int getTotalHeight()
     {
         return totalHeight;
@@ -161,6 +167,8 @@ private:
 
     OwnedArray<SpikePlot> spikePlots;
 
+    BigInteger updatedPlots;
+
     // float tetrodePlotMinWidth, stereotrodePlotMinWidth, singleElectrodePlotMinWidth;
     // float tetrodePlotRatio, stereotrodePlotRatio, singleElectrodePlotRatio;
 
@@ -224,6 +232,7 @@ private:
 
     OwnedArray<ProjectionAxes> pAxes;
     OwnedArray<WaveAxes> wAxes;
+    ScopedPointer<SpikePeakRing> peakRing;
     OwnedArray<UtilityButton> rangeButtons;
     Array<float> ranges;
 
@@ -303,6 +312,11 @@ protected:
 
   Class for drawing spike waveforms.
 
+  Every spike is added to a density image (a 2D histogram the size of the
+  axes) as it arrives, at a cost that depends only on the axes' width, and
+  the image fades with time; paint() draws the image and the newest spike
+  over it, however many spikes came in.
+
 */
 
 class WaveAxes : public GenericAxes
@@ -315,6 +329,7 @@ public:
     bool checkThreshold(const SpikeObject& spike);
 
     void paint(Graphics& g);
+    void resized();
 
     void plotSpike(const SpikeObject& s, Graphics& g);
 
@@ -349,6 +364,14 @@ private:
 
     void drawThresholdSlider(Graphics& g);
 
+    void accumulateSpike(const SpikeObject& s);
+    void rebuildDensity();
+    void updateDensityImage();
+
+    HeapBlock<float> density; // spikes per pixel, decayed
+    Image densityImage;
+    double lastDecayTime;
+
     int spikesReceivedSinceLastRedraw;
 
     Font font;
@@ -375,17 +398,24 @@ private:
 
   Class for drawing the peak projections of spike waveforms.
 
+  The points are drawn straight into an image the size of the axes, one
+  spike at a time as they arrive; the whole image is only redrawn from the
+  SpikePeakRing when the range or the size changes.
+
 */
 
 class ProjectionAxes : public GenericAxes
 {
 public:
-    ProjectionAxes(int projectionNum);
+    ProjectionAxes(int projectionNum, SpikePeakRing* peakRing);
     ~ProjectionAxes() {}
 
+    /** Plots the newest spike in the peak ring (the SpikePlot adds s to it
+        first). */
     bool updateSpikeData(const SpikeObject& s);
 
     void paint(Graphics& g);
+    void resized();
 
     void clear();
 
@@ -395,19 +425,18 @@ public:
 
 private:
 
-    void updateProjectionImage(uint16_t, uint16_t, uint16_t);
-
-    void calcWaveformPeakIdx(const SpikeObject&, int, int, int*, int*);
+    void plotPoint(Image::BitmapData& bitmap, const float* peaks);
+    void redrawProjectionImage();
 
     int ampDim1, ampDim2;
 
+    SpikePeakRing* peakRing;
+
     Image projectionImage;
 
     Colour pointColour;
     Colour gridColour;
 
-    int imageDim;
-
     int rangeX;
     int rangeY;
 
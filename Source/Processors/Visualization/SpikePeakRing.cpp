@@ -0,0 +1,79 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SpikePeakRing.h"
+
+using namespace juce;
+
+SpikePeakRing::SpikePeakRing(int numChannels_, int capacity_)
+    : numChannels(numChannels_), capacity(capacity_), allocated(0), next(0), count(0)
+{
+
+}
+
+void SpikePeakRing::add(const SpikeObject& s)
+{
+
+    if (count == allocated && allocated < capacity)
+    {
+        // nothing has been overwritten yet, so the spikes are still in
+        // order; next has wrapped around to 0, and the new one goes after them
+        allocated = jmin(capacity, jmax(1024, allocated*2));
+        peaks.realloc(allocated*numChannels);
+        next = count;
+    }
+
+    float* const p = peaks + next*numChannels;
+
+    for (int ch = 0; ch < numChannels; ch++)
+    {
+        const uint16_t* const data = s.data + ch*s.nSamples;
+        int peak = 0;
+
+        for (int i = 0; i < s.nSamples; i++)
+            peak = jmax(peak, int(data[i]));
+
+        p[ch] = s.gain[ch] != 0 ? float(peak-32768)/float(s.gain[ch])*1000.0f : 0.0f;
+    }
+
+    next = (next + 1) % allocated;
+    count = jmin(count + 1, allocated);
+
+}
+
+const float* SpikePeakRing::getPeaks(int i) const
+{
+
+    const int oldest = (count < allocated) ? 0 : next;
+
+    return peaks + ((oldest + i) % allocated)*numChannels;
+
+}
+
+void SpikePeakRing::clear()
+{
+
+    next = 0;
+    count = 0;
+
+}
@@ -0,0 +1,76 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SPIKEPEAKRING_H_5D0B71E2__
+#define __SPIKEPEAKRING_H_5D0B71E2__
+
+// only juce_core, so that the ring can be tested on its own (see Tests/)
+#include "../../../JuceLibraryCode/AppConfig.h"
+#include "../../../JuceLibraryCode/modules/juce_core/juce_core.h"
+
+#include "SpikeObject.h"
+
+/**
+
+  The peak amplitudes, in microvolts, of an electrode's most recent spikes,
+  one per channel. Once it holds its capacity (MAX_PROJECTION_POINTS, for
+  the spike display), new ones replace the oldest. It grows as spikes come in, so quiet electrodes
+  don't hold on to the full amount.
+
+  @see ProjectionAxes
+
+*/
+
+class SpikePeakRing
+{
+public:
+    SpikePeakRing(int numChannels, int capacity);
+
+    /** Adds a spike's peaks. */
+    void add(const SpikeObject& s);
+
+    /** Returns the number of spikes held. */
+    int size() const
+    {
+        return count;
+    }
+
+    /** Returns the peaks of spike i, from 0 (the oldest) to size() - 1. */
+    const float* getPeaks(int i) const;
+
+    void clear();
+
+private:
+
+    const int numChannels;
+    const int capacity;
+
+    juce::HeapBlock<float> peaks;
+    int allocated;
+
+    int next;
+    int count;
+
+};
+
+#endif  // __SPIKEPEAKRING_H_5D0B71E2__
@@ -25,17 +25,20 @@
 #define __VISUALIZER_H_C5943EC1__
 
 #include "../../../JuceLibraryCode/JuceHeader.h"
+#include "DisplayScheduler.h"
 
 /**
 
   Abstract base class for displaying data.
 
-  @see LfpDisplayCanvas, SpikeDisplayCanvas
+  While it's animating, a Visualizer is refreshed by the DisplayScheduler,
+  along with all the others.
+
+  @see LfpDisplayCanvas, SpikeDisplayCanvas, DisplayScheduler
 
 */
 
-class Visualizer : public Component,
-    public Timer
+class Visualizer : public Component
 
 {
 public:
@@ -43,7 +46,10 @@ public:
     {
         refreshRate = 10;    // 10 Hz default refresh rate
     }
-    ~Visualizer() {}
+    ~Visualizer()
+    {
+        DisplayScheduler::remove(this);
+    }
 
     /** Called when the component's tab becomes visible again.*/
     virtual void refreshState() = 0;
@@ -51,9 +57,14 @@ public:
     /** Called when parameters of underlying data processor are changed.*/
     virtual void update() = 0;
 
-    /** Called instead of "repaint" to avoid redrawing underlying components if not necessary.*/
+    /** Called instead of "repaint" to avoid redrawing underlying components if not necessary.
+        Should only repaint the parts of the display that have changed.*/
     virtual void refresh() = 0;
 
+    /** Called instead of refresh() while the visualizer isn't showing. Anything that has to
+        keep up with the data even when it isn't drawn belongs here.*/
+    virtual void skipRefresh() { }
+
     /** Called when data acquisition is active.*/
     virtual void beginAnimation() = 0;
 
@@ -66,22 +77,16 @@ public:
     /** Called by an editor to initiate a parameter change.*/
     virtual void setParameter(int, int, int, float) = 0;
 
-    /** Starts the timer callbacks. */
+    /** Starts the refreshes from the DisplayScheduler. */
     void startCallbacks()
     {
-        startTimer(20);
+        DisplayScheduler::add(this);
     }
 
-    /** Stops the timer callbacks. */
+    /** Stops the refreshes from the DisplayScheduler. */
     void stopCallbacks()
     {
-        stopTimer();
-    }
-
-    /** Called whenever the timer is triggered. */
-    void timerCallback()
-    {
-        refresh();
+        DisplayScheduler::remove(this);
     }
 
     /** Refresh rate in Hz. */
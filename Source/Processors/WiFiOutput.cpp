@@ -40,11 +40,11 @@ AudioProcessorEditor* WiFiOutput::createEditor()
     return editor;
 }
 
-void WiFiOutput::handleEvent(int eventType, MidiMessage& event, int sampleNum)
+void WiFiOutput::handleEvent(int eventType, const uint8* eventData, int numBytes, int sampleNum)
 {
     if (eventType == TTL)
     {
-        startTimer((int) float(event.getTimeStamp())/getSampleRate()*1000.0);
+        startTimer((int) float(sampleNum)/getSampleRate()*1000.0);
     }
 
 }
@@ -0,0 +1,190 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "ConfigurationLoader.h"
+#include "SettingsSnapshot.h"
+#include "../Processors/ProcessorGraph.h"
+#include "../Processors/GenericProcessor.h"
+
+#include <iostream>
+
+/** Constructs every source of one type, in order. */
+class ConfigurationLoader::SourceJob : public ThreadPoolJob
+{
+public:
+    SourceJob(ConfigurationLoader* loader_, const String& description_)
+        : ThreadPoolJob("Source construction"), loader(loader_), description(description_) {}
+
+    JobStatus runJob()
+    {
+        for (int i = 0; i < loader->sourceDescriptions.size(); i++)
+        {
+            if (loader->sourceDescriptions[i] == description)
+            {
+                String d = description;
+                loader->sources.set(i, loader->graph->createProcessorFromDescription(d));
+                ++(loader->numSourcesDone);
+            }
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    ConfigurationLoader* loader;
+    const String description;
+};
+
+ConfigurationLoader::ConfigurationLoader(const File& file_, ProcessorGraph* graph_)
+    : ThreadWithProgressWindow("Loading " + file_.getFileName(), true, false),
+      file(file_), graph(graph_), stage(READING)
+{
+
+}
+
+ConfigurationLoader::~ConfigurationLoader()
+{
+
+    // anything that wasn't handed over
+    for (int i = 0; i < sources.size(); i++)
+        delete sources[i];
+
+}
+
+bool ConfigurationLoader::read()
+{
+
+    stage = READING;
+    runThread();
+
+    return settings != nullptr;
+
+}
+
+void ConfigurationLoader::prepareSources()
+{
+
+    if (sourceDescriptions.size() == 0)
+        return;
+
+    stage = PREPARING;
+    runThread();
+
+    for (int i = 0; i < sources.size(); i++)
+    {
+        if (sources[i] != 0)
+            graph->addPreparedProcessor(sourceDescriptions[i], sources[i]);
+    }
+
+    sources.clear();
+
+}
+
+XmlElement* ConfigurationLoader::releaseSettings()
+{
+
+    return settings.release();
+
+}
+
+void ConfigurationLoader::run()
+{
+
+    if (stage == READING)
+        readSettings();
+    else
+        constructSources();
+
+}
+
+void ConfigurationLoader::readSettings()
+{
+
+    setStatusMessage("Reading " + file.getFileName() + "...");
+    setProgress(-1.0); // no way of telling how far along the parser is
+
+    ScopedPointer<XmlElement> xml(SettingsSnapshot::readFromFile(file));
+
+    if (xml == nullptr || ! xml->hasTagName("SETTINGS"))
+    {
+        error = "Not a valid file.";
+        return;
+    }
+
+    setStatusMessage("Checking " + file.getFileName() + "...");
+
+    int numProcessors = 0;
+
+    forEachXmlChildElementWithTagName(*xml, signalChain, "SIGNALCHAIN")
+    {
+        forEachXmlChildElementWithTagName(*signalChain, processor, "PROCESSOR")
+        {
+            const String description = processor->getStringAttribute("name");
+
+            if (! description.containsChar('/'))
+            {
+                error = "Processor " + String(numProcessors + 1) + " has no valid type.";
+                return;
+            }
+
+            if (description.upToFirstOccurrenceOf("/", false, false).equalsIgnoreCase("Sources"))
+                sourceDescriptions.add(description);
+
+            numProcessors++;
+        }
+    }
+
+    std::cout << file.getFileName() << ": " << numProcessors << " processors, "
+              << sourceDescriptions.size() << " of them sources." << std::endl;
+
+    settings = xml.release();
+
+}
+
+void ConfigurationLoader::constructSources()
+{
+
+    setProgress(0.0);
+
+    sources.insertMultiple(0, 0, sourceDescriptions.size());
+
+    StringArray types(sourceDescriptions);
+    types.removeDuplicates(false);
+
+    setStatusMessage("Looking for " + types.joinIntoString(", ") + "...");
+
+    ThreadPool pool(jlimit(1, SystemStats::getNumCpus(), types.size()));
+
+    for (int i = 0; i < types.size(); i++)
+        pool.addJob(new SourceJob(this, types[i]), true);
+
+    // the jobs can't be interrupted safely, so wait for all of them
+    while (pool.getNumJobs() > 0)
+    {
+        setProgress(numSourcesDone.get() / double(sourceDescriptions.size()));
+        wait(50);
+    }
+
+    setProgress(1.0);
+
+}
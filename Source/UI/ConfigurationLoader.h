@@ -0,0 +1,109 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __CONFIGURATIONLOADER_H_3B7F0D25__
+#define __CONFIGURATIONLOADER_H_3B7F0D25__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+class ProcessorGraph;
+class GenericProcessor;
+
+/**
+
+  Does the slow parts of loading a configuration off the message thread,
+  behind a progress window, in two stages:
+
+  - read() parses the file (settings XML or a SettingsSnapshot) and checks
+    that every processor in it names a processor type.
+  - prepareSources() constructs the configuration's data sources, whose
+    DataThreads look for (and initialize) their hardware, all at once on a
+    thread pool. Sources of the same type are built one after the other,
+    as they may be competing for the same device.
+
+  The EditorViewport clears the old signal chain in between, so that its
+  sources let go of their hardware first, and then builds the new chain in
+  one go on the message thread, picking up the prepared sources from the
+  ProcessorGraph (see ProcessorGraph::addPreparedProcessor()).
+
+  @see EditorViewport::loadState(), SettingsSnapshot
+
+*/
+
+class ConfigurationLoader : public ThreadWithProgressWindow
+{
+public:
+
+    ConfigurationLoader(const File& file, ProcessorGraph* graph);
+    ~ConfigurationLoader();
+
+    /** Reads and checks the file. Returns false, with an error message,
+        if it isn't a valid configuration. */
+    bool read();
+
+    /** Constructs the data sources, and hands them to the ProcessorGraph. */
+    void prepareSources();
+
+    /** Returns the settings that were read; the caller takes ownership. */
+    XmlElement* releaseSettings();
+
+    /** Returns the reason read() failed. */
+    const String& getError() const
+    {
+        return error;
+    }
+
+    void run();
+
+private:
+
+    class SourceJob;
+
+    enum Stage
+    {
+        READING,
+        PREPARING
+    };
+
+    void readSettings();
+    void constructSources();
+
+    const File file;
+    ProcessorGraph* graph;
+
+    Stage stage;
+
+    ScopedPointer<XmlElement> settings;
+    String error;
+
+    /** The data sources in the configuration, and what they became. */
+    StringArray sourceDescriptions;
+    Array<GenericProcessor*, CriticalSection> sources;
+
+    Atomic<int> numSourcesDone;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConfigurationLoader);
+
+};
+
+#endif  // __CONFIGURATIONLOADER_H_3B7F0D25__
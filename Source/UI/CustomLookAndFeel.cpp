@@ -23,40 +23,7 @@
 
 #include "CustomLookAndFeel.h"
 
-CustomLookAndFeel::CustomLookAndFeel() :
-    // third argument to MIS means don't copy the binary data to make a new stream
-    cpmonoExtraLightStream(BinaryData::cpmonoextralightserialized,
-                           BinaryData::cpmonoextralightserializedSize,
-                           false),
-    cpmonoLightStream(BinaryData::cpmonolightserialized,
-                      BinaryData::cpmonolightserializedSize,
-                      false),
-    cpmonoPlainStream(BinaryData::cpmonoplainserialized,
-                      BinaryData::cpmonoplainserializedSize,
-                      false),
-    cpmonoBoldStream(BinaryData::cpmonoboldserialized,
-                     BinaryData::cpmonoboldserializedSize,
-                     false),
-    cpmonoBlackStream(BinaryData::cpmonoblackserialized,
-                      BinaryData::cpmonoblackserializedSize,
-                      false),
-    misoRegularStream(BinaryData::misoserialized,
-                      BinaryData::misoserializedSize,
-                      false),
-    silkscreenStream(BinaryData::silkscreenserialized,
-                     BinaryData::silkscreenserializedSize,
-                     false),
-    // heap allocation is necessary here, because otherwise the typefaces are
-    // deleted too soon (there's a singleton typefacecache that holds references
-    // to them whenever they're used).
-    cpmonoExtraLight(new CustomTypeface(cpmonoExtraLightStream)),
-    cpmonoLight(new CustomTypeface(cpmonoLightStream)),
-    cpmonoPlain(new CustomTypeface(cpmonoPlainStream)),
-    cpmonoBold(new CustomTypeface(cpmonoBoldStream)),
-    cpmonoBlack(new CustomTypeface(cpmonoBlackStream)),
-    misoRegular(new CustomTypeface(misoRegularStream)),
-    silkscreen(new CustomTypeface(silkscreenStream))
-
+CustomLookAndFeel::CustomLookAndFeel()
 {
 
     // UNCOMMENT AFTER UPDATE
@@ -96,6 +63,27 @@ CustomLookAndFeel::~CustomLookAndFeel() {}
 // FONT/TYPEFACE METHODS :
 //==============================================================================
 
+const Typeface::Ptr CustomLookAndFeel::loadTypeface(Typeface::Ptr& typeface,
+                                                    const char* data, int dataSize)
+{
+    // the typefaces are only parsed when they're first asked for, as parsing
+    // all of them up front held up the launch for fonts that may never be drawn
+    const ScopedLock sl(typefaceLock);
+
+    if (typeface == nullptr)
+    {
+        // third argument to MIS means don't copy the binary data to make a new stream
+        MemoryInputStream mis(data, dataSize, false);
+
+        // heap allocation is necessary here, because otherwise the typefaces are
+        // deleted too soon (there's a singleton typefacecache that holds references
+        // to them whenever they're used).
+        typeface = new CustomTypeface(mis);
+    }
+
+    return typeface;
+}
+
 const Typeface::Ptr CustomLookAndFeel::getTypefaceForFont(const Font& font)
 {
     String typefaceName = font.getTypefaceName();
@@ -104,31 +92,45 @@ const Typeface::Ptr CustomLookAndFeel::getTypefaceForFont(const Font& font)
     // missing.  adjust as needed
     if (typefaceName.equalsIgnoreCase("Default Extra Light"))
     {
-        return cpmonoExtraLight;
+        return loadTypeface(cpmonoExtraLight,
+                            BinaryData::cpmonoextralightserialized,
+                            BinaryData::cpmonoextralightserializedSize);
     }
     else if (typefaceName.equalsIgnoreCase("Default Light"))
     {
-        return cpmonoLight;
+        return loadTypeface(cpmonoLight,
+                            BinaryData::cpmonolightserialized,
+                            BinaryData::cpmonolightserializedSize);
     }
     else if (typefaceName.equalsIgnoreCase("Default"))
     {
-        return cpmonoPlain;
+        return loadTypeface(cpmonoPlain,
+                            BinaryData::cpmonoplainserialized,
+                            BinaryData::cpmonoplainserializedSize);
     }
     else if (typefaceName.equalsIgnoreCase("Default Bold"))
     {
-        return cpmonoBold;
+        return loadTypeface(cpmonoBold,
+                            BinaryData::cpmonoboldserialized,
+                            BinaryData::cpmonoboldserializedSize);
     }
     else if (typefaceName.equalsIgnoreCase("Default Black"))
     {
-        return cpmonoBlack;
+        return loadTypeface(cpmonoBlack,
+                            BinaryData::cpmonoblackserialized,
+                            BinaryData::cpmonoblackserializedSize);
     }
     else if (typefaceName.equalsIgnoreCase("Paragraph"))
     {
-        return misoRegular;
+        return loadTypeface(misoRegular,
+                            BinaryData::misoserialized,
+                            BinaryData::misoserializedSize);
     }
     else if (typefaceName.equalsIgnoreCase("Small Text"))
     {
-        return silkscreen;
+        return loadTypeface(silkscreen,
+                            BinaryData::silkscreenserialized,
+                            BinaryData::silkscreenserializedSize);
     }
     else   // default
     {
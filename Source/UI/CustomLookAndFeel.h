@@ -31,7 +31,8 @@
    Used to modify the appearance of the application.
 
    Currently contains methods for drawing custom tabs, scroll bars, and sliders.
-   It also takes care of custom fonts via getTypefaceForFont().
+   It also takes care of custom fonts via getTypefaceForFont(), loading each
+   one the first time it's used.
 
    @see MainWindow
 
@@ -116,14 +117,10 @@ private:
     // this maps strings to customtypeface pointers
     HashMap<String, Typeface::Ptr> typefaceMap;
 
-    MemoryInputStream
-    cpmonoExtraLightStream,
-    cpmonoLightStream,
-    cpmonoPlainStream,
-    cpmonoBoldStream,
-    cpmonoBlackStream,
-    misoRegularStream,
-    silkscreenStream;
+    /** Returns the typeface, parsing it from the binary data the first time. */
+    const Typeface::Ptr loadTypeface(Typeface::Ptr& typeface, const char* data, int dataSize);
+
+    CriticalSection typefaceLock;
 
     Typeface::Ptr
     cpmonoExtraLight,
@@ -27,6 +27,8 @@
 
 #include "SignalChainManager.h"
 #include "EditorViewportButtons.h"
+#include "SettingsSnapshot.h"
+#include "ConfigurationLoader.h"
 
 EditorViewport::EditorViewport()
     : leftmostEditor(0),
@@ -1251,7 +1253,14 @@ const String EditorViewport::saveState(File fileToUse)
     getControlPanel()->saveStateToXml(xml); // save the control panel settings
     getUIComponent()->saveStateToXml(xml);  // save the UI settings
 
-    if (! xml->writeToFile(currentFile, String::empty))
+    bool written;
+
+    if (currentFile.hasFileExtension(SettingsSnapshot::fileExtension))
+        written = SettingsSnapshot::writeToFile(*xml, currentFile);
+    else
+        written = xml->writeToFile(currentFile, String::empty);
+
+    if (! written)
         error = "Couldn't write to file ";
     else
         error = "Saved configuration as ";
@@ -1286,23 +1295,34 @@ const String EditorViewport::loadState(File fileToLoad)
 
     Array<GenericProcessor*> splitPoints;
 
-    XmlDocument doc(currentFile);
-    XmlElement* xml = doc.getDocumentElement();
+    // parsing, and looking for the sources' hardware, happen off the message thread
+    ConfigurationLoader loader(currentFile, getProcessorGraph());
 
-    if (xml == 0 || ! xml->hasTagName("SETTINGS"))
+    if (! loader.read())
     {
         std::cout << "File not found." << std::endl;
-        delete xml;
-        return "Not a valid file.";
+        return loader.getError();
     }
 
+    // either settings XML or a binary snapshot of it
+    XmlElement* xml = loader.releaseSettings();
+
     clearSignalChain();
 
+    // after the old sources have let go of their hardware
+    loader.prepareSources();
+
     String description;// = " ";
     int loadOrder = 0;
 
     GenericProcessor* p;
 
+    // the processors are updated once, after they have all been created,
+    // rather than the whole chain again after each one
+    Array<GenericProcessor*> loadedProcessors;
+
+    signalChainManager->beginUpdateBatch();
+
     forEachXmlChildElement(*xml, signalChain)
     {
         forEachXmlChildElement(*signalChain, processor)
@@ -1332,8 +1352,7 @@ const String EditorViewport::loadState(File fileToLoad)
                 p = (GenericProcessor*) lastEditor->getProcessor();
                 p->loadOrder = loadOrder;
                 p->parametersAsXml = processor;
-                //Sets parameters based on XML files
-                setParametersByXML(p, processor);
+                loadedProcessors.add(p);
                 loadOrder++;
 
                 if (p->isSplitter() || p->isMerger())
@@ -1380,6 +1399,17 @@ const String EditorViewport::loadState(File fileToLoad)
 
     }
 
+    signalChainManager->endUpdateBatch();
+
+    getProcessorGraph()->clearPreparedProcessors();
+
+    // per-channel parameters need the channels to exist
+    for (int i = 0; i < loadedProcessors.size(); i++)
+    {
+        //Sets parameters based on XML files
+        setParametersByXML(loadedProcessors[i], loadedProcessors[i]->parametersAsXml);
+    }
+
     for (int i = 0; i < editorArray.size(); i++)
     {
         // deselect everything initially
@@ -60,6 +60,8 @@ ProcessorList::ProcessorList()
 
     ProcessorListItem* filters = new ProcessorListItem("Filters");
     filters->addSubItem(new ProcessorListItem("Bandpass Filter"));
+    filters->addSubItem(new ProcessorListItem("Line Noise Filter"));
+    filters->addSubItem(new ProcessorListItem("Band Power"));
     //filters->addSubItem(new ProcessorListItem("Event Detector"));
     filters->addSubItem(new ProcessorListItem("Spike Detector"));
     //filters->addSubItem(new ProcessorListItem("Resampler"));
@@ -71,6 +73,7 @@ ProcessorList::ProcessorList()
     sinks->addSubItem(new ProcessorListItem("LFP Viewer"));
     //sinks->addSubItem(new ProcessorListItem("LFP Trig. Avg."));
     sinks->addSubItem(new ProcessorListItem("Spike Viewer"));
+    sinks->addSubItem(new ProcessorListItem("Spectrum Viewer"));
     //sinks->addSubItem(new ProcessorListItem("WiFi Output"));
     //sinks->addSubItem(new ProcessorListItem("Arduino Output"));
     // sinks->addSubItem(new ProcessorListItem("FPGA Output"));
@@ -0,0 +1,340 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SettingsSnapshot.h"
+
+#include <iostream>
+
+const char* const SettingsSnapshot::fileExtension = ".oesnap";
+
+static const char magic[4] = { 'O', 'E', 'S', 'S' };
+
+static bool isChunk(const char* id, const char* name)
+{
+    return memcmp(id, name, 4) == 0;
+}
+
+/** Builds the string table while it writes the tree. */
+class SettingsSnapshot::Writer
+{
+public:
+
+    void writeElement(const XmlElement& xml)
+    {
+        if (xml.isTextElement())
+        {
+            tree.writeCompressedInt(0);
+            tree.writeCompressedInt(getIndex(xml.getText()));
+            return;
+        }
+
+        tree.writeCompressedInt(getIndex(xml.getTagName()) + 1);
+
+        const int numAttributes = xml.getNumAttributes();
+        tree.writeCompressedInt(numAttributes);
+
+        for (int i = 0; i < numAttributes; i++)
+        {
+            tree.writeCompressedInt(getIndex(xml.getAttributeName(i)));
+            tree.writeCompressedInt(getIndex(xml.getAttributeValue(i)));
+        }
+
+        tree.writeCompressedInt(xml.getNumChildElements());
+
+        for (const XmlElement* child = xml.getFirstChildElement(); child != nullptr;
+             child = child->getNextElement())
+        {
+            writeElement(*child);
+        }
+    }
+
+    void writeTo(OutputStream& stream)
+    {
+        MemoryOutputStream table;
+        table.writeCompressedInt(strings.size());
+
+        for (int i = 0; i < strings.size(); i++)
+        {
+            const String& s = strings[i];
+            const int numBytes = (int) s.getNumBytesAsUTF8();
+
+            table.writeCompressedInt(numBytes);
+            table.write(s.toUTF8(), (size_t) numBytes);
+        }
+
+        stream.write(magic, 4);
+        stream.writeInt(FORMAT_VERSION);
+
+        writeChunk(stream, "STRS", table);
+        writeChunk(stream, "TREE", tree);
+    }
+
+private:
+
+    int getIndex(const String& s)
+    {
+        if (indices.contains(s))
+            return indices[s];
+
+        const int index = strings.size();
+        strings.add(s);
+        indices.set(s, index);
+
+        return index;
+    }
+
+    static void writeChunk(OutputStream& stream, const char* id, const MemoryOutputStream& data)
+    {
+        stream.write(id, 4);
+        stream.writeInt((int) data.getDataSize());
+        stream.write(data.getData(), data.getDataSize());
+    }
+
+    StringArray strings;
+    HashMap<String, int> indices;
+
+    MemoryOutputStream tree;
+
+};
+
+/** Rebuilds the tree, checking every index against the string table. */
+class SettingsSnapshot::Reader
+{
+public:
+
+    Reader(InputStream& stream_) : stream(stream_), ok(true) {}
+
+    bool readTable()
+    {
+        const int numStrings = stream.readCompressedInt();
+
+        if (numStrings < 0)
+            return false;
+
+        MemoryBlock buffer;
+
+        for (int i = 0; i < numStrings; i++)
+        {
+            const int numBytes = stream.readCompressedInt();
+
+            if (numBytes < 0 || numBytes > stream.getNumBytesRemaining())
+                return false;
+
+            buffer.setSize((size_t) numBytes);
+
+            if (stream.read(buffer.getData(), numBytes) != numBytes)
+                return false;
+
+            strings.add(String::fromUTF8((const char*) buffer.getData(), numBytes));
+        }
+
+        return true;
+    }
+
+    XmlElement* readElement()
+    {
+        const int tag = stream.readCompressedInt();
+
+        if (tag == 0)
+            return XmlElement::createTextElement(getString());
+
+        if (! isValid(tag - 1))
+            return nullptr;
+
+        ScopedPointer<XmlElement> xml(new XmlElement(strings[tag - 1]));
+
+        const int numAttributes = stream.readCompressedInt();
+
+        for (int i = 0; i < numAttributes && ok; i++)
+        {
+            const String& name = getString();
+            xml->setAttribute(name, getString());
+        }
+
+        const int numChildren = stream.readCompressedInt();
+
+        for (int i = 0; i < numChildren && ok; i++)
+        {
+            XmlElement* child = readElement();
+
+            if (child == nullptr)
+                return nullptr;
+
+            xml->addChildElement(child);
+        }
+
+        if (! ok)
+            return nullptr;
+
+        return xml.release();
+    }
+
+private:
+
+    bool isValid(int index)
+    {
+        if (index < 0 || index >= strings.size())
+            ok = false;
+
+        return ok;
+    }
+
+    const String& getString()
+    {
+        const int index = stream.readCompressedInt();
+
+        return isValid(index) ? strings.getReference(index) : String::empty;
+    }
+
+    InputStream& stream;
+    StringArray strings;
+    bool ok;
+
+};
+
+void SettingsSnapshot::write(const XmlElement& xml, OutputStream& stream)
+{
+
+    Writer writer;
+    writer.writeElement(xml);
+    writer.writeTo(stream);
+
+}
+
+XmlElement* SettingsSnapshot::read(InputStream& stream)
+{
+
+    char header[4];
+
+    if (stream.read(header, 4) != 4 || memcmp(header, magic, 4) != 0)
+        return nullptr;
+
+    const int version = stream.readInt();
+
+    if (version > FORMAT_VERSION)
+    {
+        std::cout << "Settings snapshot is version " << version
+                  << "; this version reads up to " << (int) FORMAT_VERSION << "." << std::endl;
+        return nullptr;
+    }
+
+    Reader reader(stream);
+    bool hasTable = false;
+
+    while (! stream.isExhausted())
+    {
+        char id[4];
+
+        if (stream.read(id, 4) != 4)
+            return nullptr;
+
+        const int numBytes = stream.readInt();
+        const int64 end = stream.getPosition() + numBytes;
+
+        if (numBytes < 0 || numBytes > stream.getNumBytesRemaining())
+            return nullptr;
+
+        if (isChunk(id, "STRS"))
+        {
+            if (! reader.readTable())
+                return nullptr;
+
+            hasTable = true;
+        }
+        else if (isChunk(id, "TREE") && hasTable)
+        {
+            return reader.readElement();
+        }
+
+        // skip whatever this version doesn't know about
+        stream.setPosition(end);
+    }
+
+    return nullptr;
+
+}
+
+bool SettingsSnapshot::isSnapshot(const File& file)
+{
+
+    FileInputStream stream(file);
+
+    char header[4];
+
+    return stream.openedOk()
+           && stream.read(header, 4) == 4
+           && memcmp(header, magic, 4) == 0;
+
+}
+
+bool SettingsSnapshot::writeToFile(const XmlElement& xml, const File& file)
+{
+
+    TemporaryFile temp(file);
+
+    {
+        FileOutputStream stream(temp.getFile());
+
+        if (! stream.openedOk())
+            return false;
+
+        write(xml, stream);
+        stream.flush();
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+
+}
+
+XmlElement* SettingsSnapshot::readFromFile(const File& file)
+{
+
+    if (isSnapshot(file))
+    {
+        FileInputStream stream(file);
+
+        // read the whole file at once, rather than in small pieces
+        BufferedInputStream buffered(stream, jmax(4096, (int) jmin((int64) 1 << 24, file.getSize())));
+
+        return read(buffered);
+    }
+
+    XmlDocument doc(file);
+    return doc.getDocumentElement();
+
+}
+
+bool SettingsSnapshot::convert(const File& source, const File& destination)
+{
+
+    ScopedPointer<XmlElement> xml(readFromFile(source));
+
+    if (xml == nullptr)
+        return false;
+
+    if (destination.hasFileExtension(fileExtension))
+        return writeToFile(*xml, destination);
+    else
+        return xml->writeToFile(destination, String::empty);
+
+}
@@ -0,0 +1,95 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SETTINGSSNAPSHOT_H_6E2C91A4__
+#define __SETTINGSSNAPSHOT_H_6E2C91A4__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+/**
+
+  Reads and writes signal chain settings in a compact binary form.
+
+  A snapshot holds exactly the XML tree that EditorViewport::saveState()
+  builds (elements, attributes in order, and text), so it converts to and
+  from settings.xml without loss, and loading one goes through the same
+  code as loading the XML. What it saves is the text parsing: every tag,
+  attribute name and value is stored once, in a string table, and the
+  tree refers to them by index.
+
+  The file starts with "OESS" and a format version, followed by chunks,
+  each a four-character id and a byte count:
+
+  - STRS: the string table, as a count and then each string's UTF-8 length
+    and bytes.
+  - TREE: the root element. An element is its tag's string index + 1
+    (0 for a text element, followed by the text's index), its attributes
+    as name/value index pairs, and then its children.
+
+  All counts and indices are JUCE compressed ints. Readers skip chunks they
+  don't know, so later versions can add them.
+
+  @see EditorViewport
+
+*/
+
+class SettingsSnapshot
+{
+public:
+
+    /** The extension of snapshot files; saveState() writes XML otherwise. */
+    static const char* const fileExtension;
+
+    /** Writes the XML to a stream as a snapshot. */
+    static void write(const XmlElement& xml, OutputStream& stream);
+
+    /** Reads a snapshot back into XML. Returns nullptr if the data isn't a
+        snapshot, is damaged, or comes from a newer version. */
+    static XmlElement* read(InputStream& stream);
+
+    /** Returns true if the file starts like a snapshot. */
+    static bool isSnapshot(const File& file);
+
+    /** Writes the XML to a file as a snapshot, replacing the file. */
+    static bool writeToFile(const XmlElement& xml, const File& file);
+
+    /** Reads a snapshot or an XML file, whichever the file holds. */
+    static XmlElement* readFromFile(const File& file);
+
+    /** Converts between the two formats: to a snapshot if the destination
+        has the snapshot extension, to XML otherwise. */
+    static bool convert(const File& source, const File& destination);
+
+private:
+
+    enum
+    {
+        FORMAT_VERSION = 1
+    };
+
+    class Writer;
+    class Reader;
+
+};
+
+#endif  // __SETTINGSSNAPSHOT_H_6E2C91A4__
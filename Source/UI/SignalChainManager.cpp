@@ -32,7 +32,7 @@ SignalChainManager::SignalChainManager
  Array<GenericEditor*, CriticalSection>& editorArray_,
  Array<SignalChainTabButton*, CriticalSection>& signalChainArray_)
     : editorArray(editorArray_), signalChainArray(signalChainArray_),
-      ev(ev_), tabSize(30)
+      ev(ev_), updateBatchDepth(0), updateIsPending(false), tabSize(30)
 {
     topTab = 0;
 }
@@ -470,47 +470,91 @@ void SignalChainManager::updateVisibleEditors(GenericEditor* activeEditor,
         }
     }
 
-    // Step 7: update all settings
+    // Step 7: update settings
     if (action != ACTIVATE)
     {
 
-        std::cout << "Updating settings." << std::endl;
+        // an editor asking for an update has changed its own settings
+        if (action == UPDATE && activeEditor != 0)
+            activeEditor->getProcessor()->markSettingsDirty();
 
-        Array<GenericProcessor*> splitters;
+        if (updateBatchDepth > 0)
+            updateIsPending = true;
+        else
+            updateProcessorSettings();
+    }
+
+
+    std::cout << "Finished adding new editor." << std::endl << std::endl << std::endl;
+
+}
+
+void SignalChainManager::beginUpdateBatch()
+{
+    updateBatchDepth++;
+}
+
+void SignalChainManager::endUpdateBatch()
+{
+
+    jassert(updateBatchDepth > 0);
+
+    if (--updateBatchDepth == 0 && updateIsPending)
+    {
+        updateIsPending = false;
+        updateProcessorSettings();
+    }
+
+}
 
-        for (int n = 0; n < signalChainArray.size(); n++)
+void SignalChainManager::updateProcessorSettings()
+{
+
+    std::cout << "Updating settings." << std::endl;
+
+    // only processors whose inputs have changed are updated, but the
+    // whole chain is walked, as a change further down can be anywhere
+    int numVisited = 0;
+    int numUpdated = 0;
+
+    Array<GenericProcessor*> splitters;
+
+    for (int n = 0; n < signalChainArray.size(); n++)
+    {
+        // iterate through signal chains
+
+        GenericEditor* source = signalChainArray[n]->getEditor();
+        GenericProcessor* p = source->getProcessor();
+
+        if (p->isSplitter())
         {
-            // iterate through signal chains
+            splitters.add(p);
+        }
 
-            GenericEditor* source = signalChainArray[n]->getEditor();
-            GenericProcessor* p = source->getProcessor();
+        GenericProcessor* dest = p;
 
-            p->update();
+        while (dest != 0)
+        {
+            // iterate through processors
+            numVisited++;
 
-            if (p->isSplitter())
+            if (dest->settingsNeedUpdate())
             {
-                splitters.add(p);
+                dest->update();
+                numUpdated++;
             }
 
-            GenericProcessor* dest = p->getDestNode();
+            dest = dest->getDestNode();
 
-            while (dest != 0)
+            if (dest == 0 && splitters.size() > 0)
             {
-                // iterate through processors
-                dest->update();
-                dest = dest->getDestNode();
-
-                if (dest == 0 && splitters.size() > 0)
-                {
-                    splitters.getFirst()->switchIO();
-                    dest = splitters[0]->getDestNode();
-                    splitters.remove(0);
-                }
+                splitters.getFirst()->switchIO();
+                dest = splitters[0]->getDestNode();
+                splitters.remove(0);
             }
         }
     }
 
-
-    std::cout << "Finished adding new editor." << std::endl << std::endl << std::endl;
+    std::cout << "Updated " << numUpdated << " of " << numVisited << " processors." << std::endl;
 
 }
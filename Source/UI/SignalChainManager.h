@@ -69,6 +69,15 @@ public:
     /** Clears the signal chain.*/
     void clearSignalChain();
 
+    /** Holds back settings updates until the matching endUpdateBatch(), so
+    that a series of edits (such as loading a configuration) shares a single
+    update pass. Batches can be nested.*/
+    void beginUpdateBatch();
+
+    /** Ends a batch begun by beginUpdateBatch(), running the update pass that
+    was held back, if any.*/
+    void endUpdateBatch();
+
 private:
 
     /** An array of all currently visible editors.*/
@@ -84,6 +93,13 @@ private:
     /** Updates the visibility of SignalChainTabButtons.*/
     void refreshTabs();
 
+    /** Walks every signal chain from its source, calling update() on the
+    processors whose settings need it.*/
+    void updateProcessorSettings();
+
+    int updateBatchDepth;
+    bool updateIsPending;
+
     /** The index of the top tab (used for scrolling purposes).*/
     int topTab;
 
@@ -0,0 +1,127 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "StartupTrace.h"
+
+#include <iostream>
+
+static bool isRunning = false;
+static double startTime = 0.0;
+static double phaseStartTime = 0.0;
+static StringArray phaseNames;
+static Array<double> phaseTimes;
+
+/** The log starts over once it gets this big. */
+static const int64 maxLogSize = 256 * 1024;
+
+class StartupTrace::FinishMessage : public CallbackMessage
+{
+public:
+    void messageCallback()
+    {
+        StartupTrace::phase("Event loop");
+        StartupTrace::finish();
+    }
+};
+
+void StartupTrace::begin()
+{
+
+    phaseNames.clear();
+    phaseTimes.clear();
+
+    startTime = phaseStartTime = Time::getMillisecondCounterHiRes();
+    isRunning = true;
+
+}
+
+void StartupTrace::phase(const String& name)
+{
+
+    if (! isRunning)
+        return;
+
+    const double now = Time::getMillisecondCounterHiRes();
+
+    phaseNames.add(name);
+    phaseTimes.add(now - phaseStartTime);
+
+    phaseStartTime = now;
+
+}
+
+void StartupTrace::finishWhenIdle()
+{
+
+    if (isRunning)
+        (new FinishMessage())->post();
+
+}
+
+void StartupTrace::finish()
+{
+
+    if (! isRunning)
+        return;
+
+    isRunning = false;
+
+    const double total = Time::getMillisecondCounterHiRes() - startTime;
+
+    String trace;
+    trace << Time::getCurrentTime().formatted("%Y-%m-%d %H:%M:%S") << "  "
+          << JUCEApplication::getInstance()->getApplicationName() << " "
+          << JUCEApplication::getInstance()->getApplicationVersion() << newLine;
+
+    for (int i = 0; i < phaseNames.size(); i++)
+    {
+        trace << "    " << phaseNames[i].paddedRight(' ', 24)
+              << String(phaseTimes[i], 1).paddedLeft(' ', 9) << " ms" << newLine;
+    }
+
+    trace << "    " << String("Total").paddedRight(' ', 24)
+          << String(total, 1).paddedLeft(' ', 9) << " ms" << newLine << newLine;
+
+    std::cout << std::endl << "Startup times:" << std::endl << trace;
+
+    appendToLog(trace);
+
+}
+
+void StartupTrace::appendToLog(const String& trace)
+{
+
+#ifdef WIN32
+    File file = File::getCurrentWorkingDirectory().getChildFile("startupTrace.log");
+#else
+    File file = File("./startupTrace.log");
+#endif
+
+    if (file.getSize() > maxLogSize)
+        file.deleteFile();
+
+    if (! file.appendText(trace))
+        std::cout << "Couldn't write " << file.getFullPathName() << std::endl;
+
+}
@@ -0,0 +1,73 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef __STARTUPTRACE_H_9A41C6E2__
+#define __STARTUPTRACE_H_9A41C6E2__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+/**
+
+  Times the phases of launching the application, so that launch time can be
+  compared across releases.
+
+  The application calls begin() as soon as it starts, and then phase() at the
+  end of each step (creating the look and feel, opening the audio device,
+  building each part of the UIComponent, ...). finishWhenIdle() ends the
+  trace once the message loop has caught up with everything queued during
+  startup, which includes showing the main window.
+
+  Each launch appends a block to "startupTrace.log", in the directory from
+  which the GUI is run (next to "windowState.xml"), with the date, the
+  version, and each phase's duration in milliseconds.
+
+  @see MainWindow, UIComponent
+
+*/
+
+class StartupTrace
+{
+public:
+
+    /** Starts the clock. */
+    static void begin();
+
+    /** Records the time since the last phase ended, under the given name. */
+    static void phase(const String& name);
+
+    /** Ends the trace, and writes it out, once the message loop is idle. */
+    static void finishWhenIdle();
+
+    /** Ends the trace now, and writes it out. */
+    static void finish();
+
+private:
+
+    class FinishMessage;
+
+    static void appendToLog(const String& trace);
+
+};
+
+#endif  // __STARTUPTRACE_H_9A41C6E2__
@@ -22,6 +22,8 @@
 */
 
 #include "UIComponent.h"
+#include "SettingsSnapshot.h"
+#include "StartupTrace.h"
 #include <stdio.h>
 
 UIComponent::UIComponent(MainWindow* mainWindow_, ProcessorGraph* pgraph, AudioComponent* audio_)
@@ -38,12 +40,14 @@ UIComponent::UIComponent(MainWindow* mainWindow_, ProcessorGraph* pgraph, AudioC
     dataViewport->addTabToDataViewport("Info", infoLabel,0);
 
     std::cout << "Created data viewport." << std::endl;
+    StartupTrace::phase("Data viewport");
 
     editorViewport = new EditorViewport();
 
     addAndMakeVisible(editorViewport);
 
     std::cout << "Created filter viewport." << std::endl;
+    StartupTrace::phase("Editor viewport");
 
     editorViewportButton = new EditorViewportButton(this);
     addAndMakeVisible(editorViewportButton);
@@ -52,17 +56,20 @@ UIComponent::UIComponent(MainWindow* mainWindow_, ProcessorGraph* pgraph, AudioC
     addAndMakeVisible(controlPanel);
 
     std::cout << "Created control panel." << std::endl;
+    StartupTrace::phase("Control panel");
 
     processorList = new ProcessorList();
     addAndMakeVisible(processorList);
 
     std::cout << "Created filter list." << std::endl;
+    StartupTrace::phase("Processor list");
 
     messageCenter = new MessageCenter();
     addActionListener(messageCenter);
     addAndMakeVisible(messageCenter);
 
     std::cout << "Created message center." << std::endl;
+    StartupTrace::phase("Message center");
 
     setBounds(0,0,500,400);
 
@@ -92,6 +99,8 @@ UIComponent::UIComponent(MainWindow* mainWindow_, ProcessorGraph* pgraph, AudioC
     mainWindow->setMenuBar(this);
 #endif
 
+    StartupTrace::phase("Menus");
+
     //getEditorViewport()->loadState(File("/home/jsiegle/Programming/GUI/Builds/Linux/build/test.xml"));
 
 }
@@ -230,6 +239,8 @@ PopupMenu UIComponent::getMenuForIndex(int menuIndex, const String& menuName)
     {
         menu.addCommandItem(commandManager, openConfiguration);
         menu.addCommandItem(commandManager, saveConfiguration);
+        menu.addSeparator();
+        menu.addCommandItem(commandManager, exportProcessorStatistics);
 
 #if !JUCE_MAC
         menu.addSeparator();
@@ -254,6 +265,8 @@ PopupMenu UIComponent::getMenuForIndex(int menuIndex, const String& menuName)
         menu.addCommandItem(commandManager, toggleProcessorList);
         menu.addCommandItem(commandManager, toggleSignalChain);
         menu.addCommandItem(commandManager, toggleFileInfo);
+        menu.addSeparator();
+        menu.addCommandItem(commandManager, toggleProcessorStatistics);
 
     }
     else if (menuIndex == 3)
@@ -292,7 +305,9 @@ void UIComponent::getAllCommands(Array <CommandID>& commands)
                              toggleProcessorList,
                              toggleSignalChain,
                              toggleFileInfo,
-                             showHelp
+                             showHelp,
+                             toggleProcessorStatistics,
+                             exportProcessorStatistics
                             };
 
     commands.addArray(ids, numElementsInArray(ids));
@@ -371,6 +386,16 @@ void UIComponent::getCommandInfo(CommandID commandID, ApplicationCommandInfo& re
             result.setActive(false);
             break;
 
+        case toggleProcessorStatistics:
+            result.setInfo("Processing Times", "Show/hide per-processor timing in the Signal Chain.", "General", 0);
+            result.addDefaultKeypress('T', ModifierKeys::shiftModifier);
+            result.setTicked(processorGraph->areStatisticsVisible());
+            break;
+
+        case exportProcessorStatistics:
+            result.setInfo("Export processing times...", "Save per-processor timing statistics as CSV.", "General", 0);
+            break;
+
         default:
             break;
     };
@@ -386,7 +411,7 @@ bool UIComponent::perform(const InvocationInfo& info)
             {
                 FileChooser fc("Choose a file to load...",
                                File::getCurrentWorkingDirectory(),
-                               "*.xml",
+                               String("*.xml;*") + SettingsSnapshot::fileExtension,
                                true);
 
                 if (fc.browseForFileToOpen())
@@ -442,6 +467,30 @@ bool UIComponent::perform(const InvocationInfo& info)
             editorViewportButton->toggleState();
             break;
 
+        case toggleProcessorStatistics:
+            processorGraph->setStatisticsVisible(!processorGraph->areStatisticsVisible());
+            break;
+
+        case exportProcessorStatistics:
+            {
+                FileChooser fc("Choose the file to save...",
+                               File::getCurrentWorkingDirectory(),
+                               "*.csv",
+                               true);
+
+                if (fc.browseForFileToSave(true))
+                {
+                    File currentFile = fc.getResult();
+                    sendActionMessage(processorGraph->saveStatistics(currentFile));
+                }
+                else
+                {
+                    sendActionMessage("No file chosen.");
+                }
+
+                break;
+            }
+
         default:
             break;
 
@@ -195,7 +195,9 @@ private:
         toggleProcessorList 	= 0x2008,
         toggleSignalChain	    = 0x2009,
         toggleFileInfo			= 0x2010,
-        showHelp				= 0x2011
+        showHelp				= 0x2011,
+        toggleProcessorStatistics = 0x2012,
+        exportProcessorStatistics = 0x2013
     };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UIComponent);
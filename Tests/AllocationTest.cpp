@@ -0,0 +1,451 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+  Runs signal chains built from every GenericProcessor the ProcessorGraph
+  can create, and fails if any processor in a chain allocates on the audio
+  thread once it is past ProcessorStatistics::WARMUP_BLOCKS.
+
+  The chains are wired the way the ProcessorGraph wires them, minus the UI:
+  the Record Node and Audio Node take each source channel through
+  addInputChannel(), and each processor gets its own view of the block with
+  as many channels as its play configuration asks for.
+
+  Not covered, because they can't run without hardware:
+
+  - Source Node (RHA2000-EVAL, Custom FPGA, Rhythm FPGA): its data threads
+    need an acquisition board to deliver samples.
+  - Arduino Output, FPGA Output, Pulse Pal and WiFi Output: every TTL they
+    receive goes to a serial port, acquisition board or socket.
+
+  The Example Processor is not covered either; it's a template for new
+  processors, and the ProcessorGraph never creates it.
+
+  Must be built with OPEN_EPHYS_TRACK_ALLOCATIONS=1 (see Tests/Makefile);
+  otherwise nothing is counted and the test refuses to run.
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include "../Source/Processors/AllocationTracker.h"
+#include "../Source/Processors/AudioNode.h"
+#include "../Source/Processors/AudioResamplingNode.h"
+#include "../Source/Processors/BandPowerNode.h"
+#include "../Source/Processors/Channel.h"
+#include "../Source/Processors/ChannelMappingNode.h"
+#include "../Source/Processors/EventDetector.h"
+#include "../Source/Processors/EventNode.h"
+#include "../Source/Processors/FileReader.h"
+#include "../Source/Processors/FilterNode.h"
+#include "../Source/Processors/LfpDisplayNode.h"
+#include "../Source/Processors/LfpTriggeredAverageNode.h"
+#include "../Source/Processors/LineNoiseFilter.h"
+#include "../Source/Processors/PhaseDetector.h"
+#include "../Source/Processors/RecordNode.h"
+#include "../Source/Processors/ReferenceNode.h"
+#include "../Source/Processors/ResamplingNode.h"
+#include "../Source/Processors/SignalGenerator.h"
+#include "../Source/Processors/SpectrumNode.h"
+#include "../Source/Processors/SpikeDetector.h"
+#include "../Source/Processors/SpikeDisplayNode.h"
+#include "../Source/Processors/Editors/GenericEditor.h"
+#include "../Source/Processors/Utilities/Merger.h"
+#include "../Source/Processors/Utilities/RecordControl.h"
+#include "../Source/Processors/Utilities/Splitter.h"
+
+#include <iostream>
+
+namespace
+{
+
+const int numChannels = 16;
+const int maxBufferChannels = 128;
+const int blockSize = 1024;
+const int numBlocks = ProcessorStatistics::WARMUP_BLOCKS + 200;
+
+/** Holds the Record Node's data directory and the File Reader's file;
+    deleted when the test finishes.*/
+File testDirectory;
+
+/** A signal chain, in the order the graph processes it.*/
+class Chain
+{
+public:
+
+    /** Takes ownership of p and sets it up the way the ProcessorGraph does,
+        minus the UI. Returns p.*/
+    GenericProcessor* add(GenericProcessor* p, GenericProcessor* source)
+    {
+        p->setNodeId(100 + processors.size());
+        p->createEditor();
+
+        if (source != nullptr)
+        {
+            p->setSourceNode(source);
+            source->setDestNode(p);
+        }
+
+        p->update();
+
+        processors.add(p);
+
+        return p;
+    }
+
+    /** Adds one of the graph's fixed nodes, which aren't updated, and are
+        fed every channel of source through addInputChannel().*/
+    template <class NodeType>
+    NodeType* addFixedNode(NodeType* node, GenericProcessor* source)
+    {
+        node->setNodeId(100 + processors.size());
+        node->createEditor();
+
+        for (int chan = 0; chan < source->getNumOutputs(); chan++)
+        {
+            node->addInputChannel(source, chan);
+            node->getNextChannel(true);
+        }
+
+        processors.add(node);
+
+        return node;
+    }
+
+    OwnedArray<GenericProcessor> processors;
+
+};
+
+SignalGenerator* createGenerator()
+{
+    SignalGenerator* generator = new SignalGenerator();
+    generator->nOut = numChannels;
+
+    return generator;
+}
+
+/** Adds an Event Generator sending two TTLs a second.*/
+GenericProcessor* addEventGenerator(Chain& chain)
+{
+    GenericProcessor* events = chain.add(new EventNode(), nullptr);
+
+    events->setCurrentChannel(0);
+    events->setParameter(0, 3.0f);
+
+    return events;
+}
+
+/** A Signal Generator followed by one processor.*/
+template <class ProcessorType>
+void afterGenerator(Chain& chain)
+{
+    chain.add(new ProcessorType(), chain.add(createGenerator(), nullptr));
+}
+
+void spikeDetector(Chain& chain)
+{
+    SpikeDetector* sd = (SpikeDetector*) chain.add(new SpikeDetector(), chain.add(createGenerator(), nullptr));
+
+    // one tetrode, with thresholds the generator's sine waves cross,
+    // so spikes reach the processors downstream
+    sd->addElectrode(4);
+
+    for (int chan = 0; chan < 4; chan++)
+        sd->setChannelThreshold(0, chan, 0.01f);
+
+    sd->update();
+}
+
+void spikeViewer(Chain& chain)
+{
+    spikeDetector(chain);
+
+    chain.add(new SpikeDisplayNode(), chain.processors.getLast());
+}
+
+/** An Event Generator and a Signal Generator merged, so the processor
+    gets both samples and TTLs.*/
+template <class ProcessorType>
+void afterMerger(Chain& chain)
+{
+    GenericProcessor* events = addEventGenerator(chain);
+    GenericProcessor* generator = chain.add(createGenerator(), nullptr);
+
+    Merger* merger = new Merger();
+    chain.add(merger, events);
+
+    merger->switchIO();
+    merger->setSourceNode(generator);
+    merger->update();
+
+    chain.add(new ProcessorType(), merger);
+}
+
+void splitter(Chain& chain)
+{
+    Splitter* splitter = (Splitter*) chain.add(new Splitter(), chain.add(createGenerator(), nullptr));
+
+    chain.add(new FilterNode(), splitter);
+
+    splitter->switchIO();
+
+    chain.add(new ReferenceNode(), splitter);
+}
+
+void recordControl(Chain& chain)
+{
+    // the Event Generator's TTLs are on channel 1, and the Record Control
+    // triggers on channel 0, so the events are parsed but never start recording
+    chain.add(new RecordControl(), addEventGenerator(chain));
+}
+
+/** The File Reader's own editor can't be built without an X display (its
+    position slider sets a mouse cursor), and the audio thread never uses
+    the editor, so a plain one stands in for it.*/
+class HeadlessFileReader : public FileReader
+{
+public:
+    AudioProcessorEditor* createEditor()
+    {
+        editor = new GenericEditor(this, false);
+        return editor;
+    }
+};
+
+FileReader* addFileReader(Chain& chain)
+{
+    // raw files are read as 64 channels of int16 at 40 kHz; a quarter of a
+    // second is enough, since playback loops at the end of the file
+    const int numFileChannels = 64;
+    const int numFileSamples = 10000;
+
+    HeapBlock<int16> samples(numFileChannels * numFileSamples);
+
+    for (int i = 0; i < numFileChannels * numFileSamples; i++)
+        samples[i] = int16((i * 37) % 2000 - 1000);
+
+    File file = testDirectory.getChildFile("playback.dat");
+    file.replaceWithData(samples, numFileChannels * numFileSamples * sizeof(int16));
+
+    FileReader* reader = new HeadlessFileReader();
+    reader->setFile(file.getFullPathName());
+
+    chain.add(reader, nullptr);
+
+    return reader;
+}
+
+void fileReader(Chain& chain)
+{
+    addFileReader(chain);
+}
+
+void recordNode(Chain& chain)
+{
+    // the File Reader sends a timestamp every block, which the Record Node
+    // writes to its events file
+    GenericProcessor* source = addFileReader(chain);
+    RecordNode* recordNode = chain.addFixedNode(new RecordNode(), source);
+
+    recordNode->addInputChannel(source, AudioProcessorGraph::midiChannelIndex);
+
+    for (int chan = 0; chan < source->channels.size(); chan++)
+        source->channels[chan]->isRecording = true;
+
+    FilenameComponent directory("folder selector", testDirectory, false, true, false,
+                                String::empty, String::empty, String::empty);
+    recordNode->filenameComponentChanged(&directory);
+
+    recordNode->setParameter(1, 10.0f);
+}
+
+void audioMonitor(Chain& chain)
+{
+    GenericProcessor* source = chain.add(createGenerator(), nullptr);
+
+    for (int chan = 0; chan < source->channels.size(); chan += 4)
+        source->channels[chan]->isMonitored = true;
+
+    chain.addFixedNode(new AudioNode(), source);
+
+    AudioResamplingNode* resampler = new AudioResamplingNode();
+    resampler->setNodeId(100 + chain.processors.size());
+    resampler->createEditor();
+    chain.processors.add(resampler);
+}
+
+/** Seeks halfway through the file while playing.*/
+void seekFileReader(Chain& chain)
+{
+    chain.processors[0]->setParameter(1, 0.5f);
+}
+
+typedef void (*ChainBuilder)(Chain&);
+
+struct TestCase
+{
+    const char* name;
+    ChainBuilder build;
+
+    /** If not null, called once halfway through the run, from the audio
+        thread's point of view between two blocks.*/
+    ChainBuilder midway;
+};
+
+const TestCase testCases[] =
+{
+    { "Bandpass Filter",   &afterGenerator<FilterNode>,         nullptr },
+    { "Line Noise Filter", &afterGenerator<LineNoiseFilter>,    nullptr },
+    { "Band Power",        &afterGenerator<BandPowerNode>,      nullptr },
+    { "Phase Detector",    &afterGenerator<PhaseDetector>,      nullptr },
+    { "Spike Detector",    &spikeDetector,                      nullptr },
+    { "Event Detector",    &afterGenerator<EventDetector>,      nullptr },
+    { "Digital Ref",       &afterGenerator<ReferenceNode>,      nullptr },
+    { "Resampler",         &afterGenerator<ResamplingNode>,     nullptr },
+    { "Channel Map",       &afterGenerator<ChannelMappingNode>, nullptr },
+    { "Spectrum Viewer",   &afterGenerator<SpectrumNode>,       nullptr },
+    { "Spike Viewer",      &spikeViewer,                        nullptr },
+    { "LFP Viewer",        &afterMerger<LfpDisplayNode>,        nullptr },
+    { "LFP Trig. Avg.",    &afterMerger<LfpTriggeredAverageNode>, nullptr },
+    { "Splitter",          &splitter,                           nullptr },
+    { "Record Control",    &recordControl,                      nullptr },
+    { "Record Node",       &recordNode,                         nullptr },
+    { "Audio Node",        &audioMonitor,                       nullptr },
+    { "File Reader",       &fileReader,                         &seekFileReader }
+};
+
+/** Returns the number of channels the graph would give p's buffer.*/
+int getNumBufferChannels(GenericProcessor* p)
+{
+    return jlimit(1, maxBufferChannels,
+                  jmax(p->getNumInputChannels(), p->getNumOutputChannels()));
+}
+
+/** Returns the number of allocations counted after warm-up, for every
+    processor in the chain together.*/
+int64 runChain(const TestCase& test)
+{
+    Chain chain;
+    test.build(chain);
+
+    const int numProcessors = chain.processors.size();
+
+    for (int i = 0; i < numProcessors; i++)
+    {
+        chain.processors[i]->prepareToPlay(44100.0, blockSize);
+        chain.processors[i]->enable();
+        chain.processors[i]->getStatistics().reset();
+    }
+
+    AudioSampleBuffer storage(maxBufferChannels, blockSize);
+    MidiBuffer events;
+    events.ensureSize(64 * 1024);
+
+    for (int block = 0; block < numBlocks; block++)
+    {
+        if (block == numBlocks / 2 && test.midway != nullptr)
+            test.midway(chain);
+
+        storage.clear();
+        events.clear();
+
+        for (int i = 0; i < numProcessors; i++)
+        {
+            GenericProcessor* p = chain.processors[i];
+
+            // a fresh view every block, as the graph hands out; some
+            // processors replace the buffer they're given
+            AudioSampleBuffer buffer(storage.getArrayOfChannels(), getNumBufferChannels(p), blockSize);
+
+            ((AudioProcessor*) p)->processBlock(buffer, events);
+        }
+    }
+
+    int64 allocations = 0;
+
+    for (int i = 0; i < numProcessors; i++)
+    {
+        const int64 n = chain.processors[i]->getStatistics().getSummary().numAllocations;
+
+        if (n != 0)
+        {
+            std::cout << "  " << chain.processors[i]->getName() << " allocated "
+                      << n << " times" << std::endl;
+        }
+
+        allocations += n;
+    }
+
+    for (int i = numProcessors; --i >= 0;)
+        chain.processors[i]->disable();
+
+    // the Record Node closes its files on the block after recording stops
+    for (int i = 0; i < numProcessors; i++)
+    {
+        if (RecordNode* recordNode = dynamic_cast<RecordNode*>(chain.processors[i]))
+        {
+            AudioSampleBuffer buffer(storage.getArrayOfChannels(), getNumBufferChannels(recordNode), blockSize);
+            events.clear();
+            ((AudioProcessor*) recordNode)->processBlock(buffer, events);
+        }
+    }
+
+    std::cout << (allocations == 0 ? "PASS " : "FAIL ") << test.name
+              << ": " << allocations << " allocations after "
+              << int(ProcessorStatistics::WARMUP_BLOCKS) << " warm-up blocks" << std::endl;
+
+    return allocations;
+}
+
+}
+
+int main()
+{
+
+    if (!AllocationTracker::isEnabled())
+    {
+        std::cout << "Built without OPEN_EPHYS_TRACK_ALLOCATIONS; nothing to check." << std::endl;
+        return 1;
+    }
+
+    // editors need the message manager, even with no window
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    testDirectory = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("AllocationTest", String::empty);
+    testDirectory.createDirectory();
+
+    int numFailed = 0;
+
+    for (int i = 0; i < numElementsInArray(testCases); i++)
+    {
+        if (runChain(testCases[i]) != 0)
+            numFailed++;
+    }
+
+    testDirectory.deleteRecursively();
+
+    std::cout << numFailed << " of " << numElementsInArray(testCases)
+              << " chains allocated on the audio thread." << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+
+}
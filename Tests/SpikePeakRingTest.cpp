@@ -0,0 +1,123 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+  Checks that SpikePeakRing keeps its spikes in order as it grows past its
+  first 1024 and again past 2048, once it's full and overwriting the oldest,
+  and after it's cleared.
+*/
+
+#include "../Source/Processors/Visualization/SpikePeakRing.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+const int numChannels = 4;
+const int capacity = 4096;
+
+SpikeObject spike;
+
+/** Adds spike k, whose peak on channel ch is k + ch microvolts. */
+void addSpike(SpikePeakRing& ring, int k)
+{
+    spike.nSamples = 1;
+
+    for (int ch = 0; ch < numChannels; ch++)
+    {
+        spike.gain[ch] = 1000;
+        spike.data[ch] = uint16_t(32768 + k + ch);
+    }
+
+    ring.add(spike);
+}
+
+/** Checks that the ring holds spikes [first, first + size). */
+bool check(const SpikePeakRing& ring, int first, int size, const char* when)
+{
+    if (ring.size() != size)
+    {
+        std::cout << "FAIL " << when << ": holds " << ring.size()
+                  << " spikes, not " << size << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < size; i++)
+    {
+        const float* const peaks = ring.getPeaks(i);
+
+        for (int ch = 0; ch < numChannels; ch++)
+        {
+            if (std::fabs(peaks[ch] - float(first + i + ch)) > 0.01f)
+            {
+                std::cout << "FAIL " << when << ": spike " << i << ", channel " << ch
+                          << " is " << peaks[ch] << ", not " << first + i + ch << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "PASS " << when << std::endl;
+
+    return true;
+}
+
+}
+
+int main()
+{
+
+    SpikePeakRing ring(numChannels, capacity);
+    int numFailed = 0;
+
+    for (int k = 0; k < 1025; k++)
+        addSpike(ring, k);
+
+    if (!check(ring, 0, 1025, "growing past 1024 spikes"))
+        numFailed++;
+
+    for (int k = 1025; k < 3000; k++)
+        addSpike(ring, k);
+
+    if (!check(ring, 0, 3000, "growing past 2048 spikes"))
+        numFailed++;
+
+    for (int k = 3000; k < 10000; k++)
+        addSpike(ring, k);
+
+    if (!check(ring, 10000 - capacity, capacity, "overwriting the oldest spikes"))
+        numFailed++;
+
+    ring.clear();
+
+    for (int k = 0; k < 1500; k++)
+        addSpike(ring, k);
+
+    if (!check(ring, 0, 1500, "refilling after clear()"))
+        numFailed++;
+
+    return numFailed == 0 ? 0 : 1;
+
+}
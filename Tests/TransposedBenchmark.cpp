@@ -0,0 +1,140 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+  Times FilterNode's band-pass over 64 channels of 30 kHz data in the three
+  ways it can run: double-precision Direct Form II, the single-precision
+  TransposedCascade one channel at a time, and processFour().
+*/
+
+#include "../Source/Dsp/Dsp.h"
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+typedef Dsp::Butterworth::Design::BandPass <2> BandPassDesign;
+typedef BandPassDesign::State <Dsp::DirectFormII> BandPassState;
+typedef Dsp::TransposedDesign <BandPassDesign, 2> SingleBandPassDesign;
+typedef Dsp::TransposedCascade <2> SingleCascade;
+
+const int numChannels = 64;
+const int blockSize = 1024;
+
+/** About 35 seconds of data per channel. */
+const int numBlocks = 1000;
+
+struct Channels
+{
+    Channels()
+        : data(numChannels * blockSize)
+    {
+        std::srand(1234);
+
+        for (size_t i = 0; i < data.size(); i++)
+            data[i] = float(100.0 * (double(std::rand()) / RAND_MAX - 0.5));
+    }
+
+    float* operator[](int channel)
+    {
+        return &data[channel * blockSize];
+    }
+
+    std::vector<float> data;
+};
+
+double getSeconds(std::clock_t start)
+{
+    return double(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+}
+
+int main()
+{
+
+    Dsp::Params params;
+    params[0] = 30000.0; // sample rate
+    params[1] = 2; // order
+    params[2] = (6000.0 + 600.0) / 2; // center frequency
+    params[3] = 6000.0 - 600.0; // bandwidth
+
+    BandPassDesign design;
+    design.setParams(params);
+
+    SingleBandPassDesign singleDesign;
+    singleDesign.setParams(params);
+
+    Channels channels;
+
+    std::vector<BandPassState> doubleStates(numChannels);
+    std::vector<SingleCascade::State> singleStates(numChannels);
+
+    std::clock_t start = std::clock();
+
+    for (int b = 0; b < numBlocks; b++)
+        for (int c = 0; c < numChannels; c++)
+            design.process(blockSize, channels[c], doubleStates[c]);
+
+    const double doubleSeconds = getSeconds(start);
+
+    start = std::clock();
+
+    for (int b = 0; b < numBlocks; b++)
+        for (int c = 0; c < numChannels; c++)
+            singleDesign.process(blockSize, channels[c], singleStates[c]);
+
+    const double scalarSeconds = getSeconds(start);
+
+    start = std::clock();
+
+    for (int b = 0; b < numBlocks; b++)
+    {
+        for (int c = 0; c < numChannels; c += 4)
+        {
+            float* dest[4] = { channels[c], channels[c + 1], channels[c + 2], channels[c + 3] };
+            const SingleCascade* cascades[4] = { &singleDesign, &singleDesign, &singleDesign, &singleDesign };
+            SingleCascade::State* states[4] = { &singleStates[c], &singleStates[c + 1],
+                                                &singleStates[c + 2], &singleStates[c + 3] };
+
+            SingleCascade::processFour(blockSize, dest, cascades, states);
+        }
+    }
+
+    const double fourSeconds = getSeconds(start);
+
+    std::cout << numChannels << " channels, " << numBlocks << " blocks of " << blockSize
+              << " samples, 600-6000 Hz band-pass at 30 kHz" << std::endl;
+    std::cout << "  double, Direct Form II:  " << doubleSeconds << " s" << std::endl;
+    std::cout << "  float, one channel:      " << scalarSeconds << " s ("
+              << doubleSeconds / scalarSeconds << "x)" << std::endl;
+    std::cout << "  float, processFour():    " << fourSeconds << " s ("
+              << doubleSeconds / fourSeconds << "x)" << std::endl;
+
+    return 0;
+
+}
@@ -0,0 +1,182 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+  Checks the single-precision TransposedCascade against the double-precision
+  Direct Form II path that FilterNode uses by default. Both the scalar loop
+  and processFour() are run on spike-band filters like FilterNode's, and
+  must stay within maxErrorDb of the double-precision output.
+*/
+
+#include "../Source/Dsp/Dsp.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+typedef Dsp::Butterworth::Design::BandPass <2> BandPassDesign;
+typedef BandPassDesign::State <Dsp::DirectFormII> BandPassState;
+typedef Dsp::TransposedDesign <BandPassDesign, 2> SingleBandPassDesign;
+typedef Dsp::TransposedCascade <2> SingleCascade;
+
+const double sampleRate = 30000.0;
+const int numBlocks = 64;
+
+/** An odd length, so the tail after the last group of four samples runs too. */
+const int blockSize = 1024 + 3;
+
+/** Worst acceptable RMS error of the float path, relative to the signal. */
+const double maxErrorDb = -80.0;
+
+/** Four channels with different cutoffs, as FilterNode groups them. Low cuts
+    much below 30 Hz lose accuracy in single precision, and aren't tested. */
+const double cutoffs[4][2] = { { 600, 6000 }, { 300, 6000 }, { 300, 3000 }, { 100, 3000 } };
+
+void setBandPass(Dsp::Params& params, int channel)
+{
+    const double lowCut = cutoffs[channel][0];
+    const double highCut = cutoffs[channel][1];
+
+    params[0] = sampleRate;
+    params[1] = 2;
+    params[2] = (highCut + lowCut) / 2;
+    params[3] = highCut - lowCut;
+}
+
+/** Broadband noise plus a tone inside the pass band, like a raw recording. */
+void fillInput(std::vector<float>& data, int channel)
+{
+    std::srand(1234 + channel);
+
+    data.resize(blockSize * numBlocks);
+
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        const double noise = double(std::rand()) / RAND_MAX - 0.5;
+        data[i] = float(100.0 * noise + 50.0 * std::sin(2.0 * 3.14159265358979 * 1000.0 * i / sampleRate));
+    }
+}
+
+/** Runs the double-precision filter over a whole channel, block by block. */
+void filterDouble(std::vector<float>& data, int channel)
+{
+    Dsp::Params params;
+    setBandPass(params, channel);
+
+    BandPassDesign design;
+    design.setParams(params);
+
+    BandPassState state;
+
+    for (int b = 0; b < numBlocks; b++)
+        design.process(blockSize, &data[b * blockSize], state);
+}
+
+double getErrorDb(const std::vector<float>& data, const std::vector<float>& reference)
+{
+    double signal = 0, error = 0;
+
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        const double difference = double(data[i]) - reference[i];
+
+        signal += double(reference[i]) * reference[i];
+        error += difference * difference;
+    }
+
+    return (error > 0) ? 10.0 * std::log10(error / signal) : -1000.0;
+}
+
+bool report(const char* path, int channel, double errorDb)
+{
+    const bool passed = errorDb < maxErrorDb;
+
+    std::cout << (passed ? "PASS " : "FAIL ") << path << ", "
+              << cutoffs[channel][0] << "-" << cutoffs[channel][1] << " Hz: "
+              << errorDb << " dB RMS (limit " << maxErrorDb << " dB)" << std::endl;
+
+    return passed;
+}
+
+}
+
+int main()
+{
+
+    SingleBandPassDesign designs[4];
+    SingleCascade::State scalarStates[4];
+    SingleCascade::State fourStates[4];
+
+    std::vector<float> reference[4];
+    std::vector<float> scalar[4];
+    std::vector<float> four[4];
+
+    for (int c = 0; c < 4; c++)
+    {
+        Dsp::Params params;
+        setBandPass(params, c);
+        designs[c].setParams(params);
+
+        fillInput(reference[c], c);
+        scalar[c] = reference[c];
+        four[c] = reference[c];
+
+        filterDouble(reference[c], c);
+    }
+
+    for (int b = 0; b < numBlocks; b++)
+    {
+        float* dest[4];
+        const SingleCascade* cascades[4];
+        SingleCascade::State* states[4];
+
+        for (int c = 0; c < 4; c++)
+        {
+            designs[c].process(blockSize, &scalar[c][b * blockSize], scalarStates[c]);
+
+            dest[c] = &four[c][b * blockSize];
+            cascades[c] = &designs[c];
+            states[c] = &fourStates[c];
+        }
+
+        SingleCascade::processFour(blockSize, dest, cascades, states);
+    }
+
+    int numFailed = 0;
+
+    for (int c = 0; c < 4; c++)
+    {
+        if (!report("scalar float", c, getErrorDb(scalar[c], reference[c])))
+            numFailed++;
+
+        if (!report("processFour()", c, getErrorDb(four[c], reference[c])))
+            numFailed++;
+    }
+
+    return numFailed == 0 ? 0 : 1;
+
+}